@@ -43,6 +43,8 @@
 #include <fstream>
 #include <map>
 #include <vector>
+#include <mutex>
+#include <atomic>
 
 // use standard library objects
 using namespace std;
@@ -191,6 +193,11 @@ private:
 
 	void initialize()
 	{
+		pathWeightCacheCapacity = 1000;
+		pathWeightGeneration = -1;
+		siteTransIndexed = false;
+		siteTransHashBits = 1;
+
 		yang2007[0][0] = -0.217;
 		yang2007[0][1] = 1.79;
 		yang2007[0][2] = 3.16;
@@ -366,6 +373,163 @@ private:
 		return x1*mlogd*mlogd + x2*mlogd + x3;
 	}
 
+	/**
+	 * The attributes needed to evaluate Q in one frequency band.  If the
+	 * model stores Q for the band, qIndex is its attribute index.
+	 * Otherwise qIndex is -1 and Q is computed from attributes q0Index and
+	 * etaIndex at centerFrequency.
+	 */
+	struct BandQ
+	{
+		int qIndex;
+		int q0Index;
+		int etaIndex;
+		double centerFrequency;
+	};
+
+	/**
+	 * Map from frequency band to the attributes needed to evaluate Q in
+	 * that band.  Filled on demand by getBandQ().
+	 */
+	map<string, BandQ> bandQMap;
+
+	/**
+	 * Cache of the path weights computed by getPathWeights().  The key holds
+	 * the two endpoints of the path, dxkm, the interpolator, and the normal
+	 * and length of the path, so the short and long great circles between
+	 * the same endpoints have different keys.
+	 */
+	map<vector<double>, vector<pair<int, double> > > pathWeightCache;
+
+	/**
+	 * Maximum number of paths held in pathWeightCache.  When it is full,
+	 * the cache is emptied.  Zero disables the cache.
+	 */
+	int pathWeightCacheCapacity;
+
+	/**
+	 * The generation of the point map (see GeoTessPointMap::getGeneration())
+	 * when the weights in pathWeightCache were computed.  The point indexes
+	 * they hold are stale once the active region changes.
+	 */
+	int pathWeightGeneration;
+
+	/**
+	 * Guards bandQMap and pathWeightCache, which are modified by otherwise
+	 * read-only methods such as getPathQ().
+	 */
+	mutex cacheMutex;
+
+	/**
+	 * Determine the attributes needed to evaluate Q in band.
+	 * @throws GeoTessException if the model supports neither Q[band] nor
+	 * Q0/ETA, or band is not a known frequency band.
+	 */
+	BandQ getBandQ(const string& band);
+
+	/**
+	 * Determine the attributes needed to evaluate Q at centerFrequency in a
+	 * model that stores Q0 and ETA.
+	 * @throws GeoTessException if the model does not support Q0/ETA, or
+	 * centerFrequency is too small.
+	 */
+	BandQ getBandQ(double centerFrequency);
+
+	/**
+	 * Retrieve the weights of the points that contribute to the integral of
+	 * a model attribute along path, in point index order, computed with
+	 * dxkm and interpolatorType and cached for subsequent calls.
+	 */
+	void getPathWeights(GeoTessGreatCircle& path, vector<pair<int, double> >& weights);
+
+	/**
+	 * Integrate Q in each of the specified bands along a path.  Bands that
+	 * are evaluated from Q0 and ETA share a single gather of w/Q0 and ETA at
+	 * the points along the path, and Q0*f^ETA is evaluated as
+	 * Q0*exp(ETA*log(f)) with log(f) computed once per band.
+	 * @param bands the attributes that evaluate Q in each band.
+	 * @param weights the weights of the points along the path, as from
+	 * getPathWeights().
+	 * @param pathQ (output) the effective Q in each band, or NaN if any
+	 * point along the path is outside the model.
+	 */
+	void integratePathQ(const vector<BandQ>& bands,
+			const vector<pair<int, double> >& weights, vector<double>& pathQ);
+
+	/**
+	 * Discard the cached path weights, band attributes and site term index.
+	 */
+	void clearCaches()
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		bandQMap.clear();
+		pathWeightCache.clear();
+		siteTransIndexed = false;
+	}
+
+	/**
+	 * Map from station, channel and band names to the integer ids used
+	 * by the site term index.  Ids are assigned in name order.
+	 */
+	map<string, int> stationIds, channelIds, bandIds;
+
+	/**
+	 * The names of the stations, channels and bands, indexed by id.
+	 */
+	vector<string> stationNames, channelNames, bandNames;
+
+	/**
+	 * The site terms of station id s are entries siteTransStart[s] to
+	 * siteTransStart[s+1]-1 of siteTransChannel, siteTransBand and
+	 * siteTransValue, ordered by channel and then band.
+	 */
+	vector<int> siteTransStart, siteTransChannel, siteTransBand;
+	vector<float> siteTransValue;
+
+	/**
+	 * Open addressing hash table, with linear probing, from the key
+	 * computed by siteTransKey() to the site term.  The number of slots
+	 * is a power of two, 1 << siteTransHashBits, and empty slots have
+	 * key -1.
+	 */
+	vector<LONG_INT> siteTransHashKeys;
+	vector<float> siteTransHashValues;
+	int siteTransHashBits;
+
+	/**
+	 * True when the site term index reflects the contents of siteTrans.
+	 */
+	atomic<bool> siteTransIndexed;
+
+	/**
+	 * Build the site term index from siteTrans, if it is not current.
+	 */
+	void indexSiteTrans()
+	{
+		if (!siteTransIndexed.load(memory_order_acquire))
+			buildSiteTransIndex();
+	}
+
+	void buildSiteTransIndex();
+
+	LONG_INT siteTransKey(int stationId, int channelId, int bandId) const
+	{
+		return ((LONG_INT)stationId * (LONG_INT)channelNames.size() + channelId)
+				* (LONG_INT)bandNames.size() + bandId;
+	}
+
+	int siteTransSlot(LONG_INT key) const
+	{
+		return (int)(((unsigned long long) key * 0x9E3779B97F4A7C15ULL)
+				>> (64 - siteTransHashBits));
+	}
+
+	static int findId(const map<string, int>& ids, const string& name)
+	{
+		map<string, int>::const_iterator it = ids.find(name);
+		return it == ids.end() ? -1 : it->second;
+	}
+
 	/// @endcond
 
 public:
@@ -615,6 +779,19 @@ public:
 			}
 		}
 
+		if (siteTransIndexed)
+		{
+			for (int i=0; i<(int)stationNames.size(); ++i)
+				memory += (LONG_INT)(sizeof(string) + stationNames[i].length() + sizeof(int));
+			for (int i=0; i<(int)channelNames.size(); ++i)
+				memory += (LONG_INT)(sizeof(string) + channelNames[i].length() + sizeof(int));
+			for (int i=0; i<(int)bandNames.size(); ++i)
+				memory += (LONG_INT)(sizeof(string) + bandNames[i].length() + sizeof(int));
+			memory += (LONG_INT)(siteTransStart.size() * sizeof(int)
+					+ siteTransValue.size() * (2*sizeof(int) + sizeof(float))
+					+ siteTransHashKeys.size() * (sizeof(LONG_INT) + sizeof(float)));
+		}
+
 		memory += sizeof(yang2007)+18*sizeof(double);
 		memory += sizeof(yang2011)+18*sizeof(double);
 
@@ -693,198 +870,103 @@ public:
 	 * @return the value of effective Q for the specified frequency band,
 	 * @throws GeoTessException
 	 */
-	double getPathQ(GeoTessGreatCircle& path, const string& band)
-	{
-
-//		int level = getGrid().getNLevels(0)-1;
-//		// convert level index into grid spacing in degrees.
-//		double gridSpacing = exp(log(64.0)-level*log(2.0));
-//		// set the integration interval to 1/10th the grid spacing, in radians
-//		double integrationInterval = CPPUtils::toRadians(gridSpacing/10.);
-
-		double integrationInterval = dxkm / 6371.; // convert km to radians
-
-		GeoTessPointMap* pm = getPointMap();
-		int pointIndex;
-		double weight;
-		double integral = 0, pathLength=0.;
-
-		map<int, double> weights;
-		if (interpolatorType == "NATURAL_NEIGHBOR")
-			getWeights(path, integrationInterval, -1., GeoTessInterpolatorType::NATURAL_NEIGHBOR, weights);
-		else if (interpolatorType == "LINEAR")
-			getWeights(path, integrationInterval, -1., GeoTessInterpolatorType::LINEAR, weights);
-
-		string attribute = "Q["+band+"]";
-		int bandIndex = getMetaData().getAttributeIndex(attribute);
-		if (bandIndex >= 0)
-		{
-			for (map<int, double>::iterator it = weights.begin(); it != weights.end(); it++)
-			{
-				pointIndex = (*it).first;
-				if (pointIndex < 0) return NaN_DOUBLE;
-
-				weight = (*it).second;
-
-				integral += weight/pm->getPointValueDouble(pointIndex, bandIndex);
-				pathLength += weight;
-			}
-			return pathLength/integral;
-		}
-		else
-		{
-			int q0Index = getMetaData().getAttributeIndex("Q0");
-			int etaIndex = getMetaData().getAttributeIndex("ETA");
-			if (q0Index < 0 || etaIndex < 0)
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< "Model does not support attributes Q0/ETA or " << attribute
-						<< ". Supported attributes include:" << endl;
-				for (int i=0; i<getNAttributes(); ++i)
-					os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
-
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
-
-			map<string, vector<float> >::iterator freq = frequencyMap.find(band);
-
-			if (freq == frequencyMap.end())
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< band << "is not a supported frequency band. Supported attributes include:" << endl;
-				for (int i=0; i<getNAttributes(); ++i)
-					os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
-
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
-
-			double centerFrequency = sqrt((*freq).second[0] * (*freq).second[1]);
-
-			if (centerFrequency < 1e-6)
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< "centerFrequency = " << centerFrequency << " is too small." << endl;
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
-
-			double q0, eta;
-
-			for (map<int, double>::iterator it = weights.begin(); it != weights.end(); it++)
-			{
-				pointIndex = (*it).first;
-				if (pointIndex < 0) return NaN_DOUBLE;
-
-				weight = (*it).second;
-
-				q0 = pm->getPointValueDouble(pointIndex, q0Index);
-				eta = pm->getPointValueDouble(pointIndex, etaIndex);
-
-				integral += weight/(q0 * pow(centerFrequency, eta));
-				pathLength += weight;
-
-			}
-			return pathLength/integral;
-		}
-	}
+	double getPathQ(GeoTessGreatCircle& path, const string& band);
 
 	/**
 	 * Retrieve the value of effective Q for the specified frequency band,
 	 * using weights computed using GeoTessModel::getWeights, avoid repeat getWeights calls
-	 * Q stored as floats
 	 * @param band the frequency band, e.g., "1.0_2.0"
 	 * @param weights a map from integer point index to double path weight at that point.
 	 * @return the value of effective Q for the specified frequency band,
 	 * @throws GeoTessException
 	 */
-	double getPathQ(const string& band, map<int, double> weights)
-	{
-		GeoTessPointMap* pm = getPointMap(); // ok to call every time? Yes. Only retrieves a reference.
-		int pointIndex;
-		double weight;
-		double integral = 0, pathLength=0.;
-
-		string attribute = "Q["+band+"]";
-		int bandIndex = getMetaData().getAttributeIndex(attribute);
-		if (bandIndex >= 0)
-		{
-			for (map<int, double>::iterator it = weights.begin(); it != weights.end(); it++)
-			{
-				pointIndex = (*it).first;
-				if (pointIndex < 0) return NaN_DOUBLE;
-
-				// check weight defined > 0, == 0
-				weight = (*it).second;
-
-				// check Q defined
-				integral += weight/pm->getPointValueFloat(pointIndex, bandIndex);
-				pathLength += weight;
-			}
-			return pathLength/integral; // check integral > 0
-		}
-		else
-		{
-			int q0Index = getMetaData().getAttributeIndex("Q0");
-			int etaIndex = getMetaData().getAttributeIndex("ETA");
-			if (q0Index < 0 || etaIndex < 0)
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< "Model does not support attributes Q0/ETA or " << attribute
-						<< ". Supported attributes include:" << endl;
-				for (int i=0; i<getNAttributes(); ++i)
-					os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
-
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
-
-			map<string, vector<float> >::iterator freq = frequencyMap.find(band);
-
-			if (freq == frequencyMap.end())
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< band << "is not a supported frequency band. Supported attributes include:" << endl;
-				for (int i=0; i<getNAttributes(); ++i)
-					os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
-
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
+	double getPathQ(const string& band, const map<int, double>& weights);
 
-			double centerFrequency = sqrt((*freq).second[0] * (*freq).second[1]);
-
-			if (centerFrequency < 1e-6)
-			{
-				ostringstream os;
-				os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
-						<< "centerFrequency = " << centerFrequency << " is too small." << endl;
-				throw GeoTessException(os, __FILE__, __LINE__, 6005);
-			}
-
-			double q0, eta;
+	/**
+	 * Retrieve the values of effective Q for several frequency bands,
+	 * integrated along the great circle path from pointA to pointB.  The
+	 * path weights are computed once and all the bands are integrated in a
+	 * single pass over the points along the path.
+	 * @param path great circle path along which to compute Q
+	 * @param bands the frequency bands, e.g., "1.0_2.0"
+	 * @param pathQ (output) the value of effective Q for each band.
+	 * @throws GeoTessException
+	 */
+	void getPathQ(GeoTessGreatCircle& path, const vector<string>& bands,
+			vector<double>& pathQ);
 
-			for (map<int, double>::iterator it = weights.begin(); it != weights.end(); it++)
-			{
-				pointIndex = (*it).first;
-				if (pointIndex < 0) return NaN_DOUBLE;
+	/**
+	 * Retrieve the values of effective Q for several frequency bands,
+	 * integrated along the great circle path from pointA to pointB.
+	 * @param pointA unit vector representing start of great circle path
+	 * @param pointB unit vector representing end of great circle path
+	 * @param bands the frequency bands, e.g., "1.0_2.0"
+	 * @param pathQ (output) the value of effective Q for each band.
+	 * @throws GeoTessException
+	 */
+	void getPathQ(const double* pointA, const double* pointB,
+			const vector<string>& bands, vector<double>& pathQ)
+	{
+		GeoTessGreatCircle path(pointA, pointB);
+		getPathQ(path, bands, pathQ);
+	}
 
-				// check weight > 0, == 0
-				weight = (*it).second;
+	/**
+	 * Retrieve the values of effective Q for several frequency bands,
+	 * using weights computed using GeoTessModel::getWeights.
+	 * @param bands the frequency bands, e.g., "1.0_2.0"
+	 * @param weights a map from integer point index to double path weight at that point.
+	 * @param pathQ (output) the value of effective Q for each band.
+	 * @throws GeoTessException
+	 */
+	void getPathQ(const vector<string>& bands, const map<int, double>& weights,
+			vector<double>& pathQ);
 
-				// check q0, eta defined
-				q0 = pm->getPointValueDouble(pointIndex, q0Index);
-				eta = pm->getPointValueDouble(pointIndex, etaIndex);
+	/**
+	 * Retrieve the values of effective Q at several frequencies, integrated
+	 * along a great circle path through a model that stores Q0 and ETA,
+	 * where Q = Q0 * f^ETA.  The path weights, Q0 and ETA are retrieved once
+	 * and shared by all the frequencies.
+	 * @param path great circle path along which to compute Q
+	 * @param centerFrequencies the frequencies, in Hz, at which to evaluate Q,
+	 * e.g., the geometric mean of the limits of each frequency band.
+	 * @param pathQ (output) the value of effective Q at each frequency.
+	 * @throws GeoTessException if the model does not support Q0/ETA.
+	 */
+	void getPathQ(GeoTessGreatCircle& path, const vector<double>& centerFrequencies,
+			vector<double>& pathQ);
 
-				integral += weight/(q0 * pow(centerFrequency, eta));
-				pathLength += weight;
+	/**
+	 * Retrieve the values of effective Q at several frequencies, using
+	 * weights computed using GeoTessModel::getWeights, in a model that
+	 * stores Q0 and ETA.
+	 * @param centerFrequencies the frequencies, in Hz, at which to evaluate Q.
+	 * @param weights a map from integer point index to double path weight at that point.
+	 * @param pathQ (output) the value of effective Q at each frequency.
+	 * @throws GeoTessException if the model does not support Q0/ETA.
+	 */
+	void getPathQ(const vector<double>& centerFrequencies, const map<int, double>& weights,
+			vector<double>& pathQ);
 
-			}
-			return pathLength/integral; // check integral > 0
-		}
+	/**
+	 * Specify the maximum number of great circle paths whose weights are
+	 * cached by getPathQ().  When the cache is full it is emptied.
+	 * Specify zero to disable the cache.  The default is 1000.
+	 * @param capacity the maximum number of cached paths.
+	 */
+	void setPathWeightCacheCapacity(int capacity)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		pathWeightCacheCapacity = capacity;
+		pathWeightCache.clear();
 	}
 
+	/**
+	 * @return the maximum number of great circle paths whose weights are
+	 * cached by getPathQ().
+	 */
+	int getPathWeightCacheCapacity() const { return pathWeightCacheCapacity; }
+
 	int getFileformat() { return fileformat; }
 
 	/**
@@ -894,11 +976,15 @@ public:
 	string getPhase() { return phase; }
 
 	/**
-	 * Get reference to the map from station -> channel -> band -> siteTran
+	 * Get reference to the map from station -> channel -> band -> siteTran.
+	 * The caller may modify the map, so the station, channel and band ids
+	 * used by the id based site term methods are invalidated.  A caller that
+	 * retains the reference and modifies the map later must call
+	 * clearSiteTransIndex().
 	 * @return a reference to the map from station -> channel -> band -> siteTran
 	 */
 	map<string, map<string, map<string, float> > >& getSiteTrans()
-	{ return siteTrans; }
+	{ siteTransIndexed = false; return siteTrans; }
 
 	/**
 	 * Retrieve the site term for the specified station/channel/band
@@ -924,6 +1010,124 @@ public:
 		return NaN_FLOAT;
 	}
 
+	/**
+	 * Discard the index used by the id based site term methods, which is
+	 * rebuilt from the site term map when next needed.  Call this after
+	 * modifying the map through a reference previously returned by
+	 * getSiteTrans().  Station, channel and band ids obtained earlier are
+	 * no longer valid.
+	 */
+	void clearSiteTransIndex() { siteTransIndexed = false; }
+
+	/**
+	 * Retrieve the integer id of a station, for use with the id based
+	 * site term methods.  Ids are valid until the site terms are modified.
+	 * @param station
+	 * @return the id of the station, or -1 if it has no site terms.
+	 */
+	int getStationId(const string& station)
+	{ indexSiteTrans(); return findId(stationIds, station); }
+
+	/**
+	 * Retrieve the integer id of a channel, for use with the id based
+	 * site term methods.  Channel ids are shared by all stations.
+	 * @param channel
+	 * @return the id of the channel, or -1 if no station supports it.
+	 */
+	int getChannelId(const string& channel)
+	{ indexSiteTrans(); return findId(channelIds, channel); }
+
+	/**
+	 * Retrieve the integer id of a frequency band, for use with the id
+	 * based site term methods.  Band ids are shared by all stations.
+	 * @param band
+	 * @return the id of the band, or -1 if no station supports it.
+	 */
+	int getBandId(const string& band)
+	{ indexSiteTrans(); return findId(bandIds, band); }
+
+	/**
+	 * Retrieve the name of the station with the specified id.
+	 */
+	const string& getStationName(int stationId)
+	{ indexSiteTrans(); return stationNames[stationId]; }
+
+	/**
+	 * Retrieve the name of the channel with the specified id.
+	 */
+	const string& getChannelName(int channelId)
+	{ indexSiteTrans(); return channelNames[channelId]; }
+
+	/**
+	 * Retrieve the name of the frequency band with the specified id.
+	 */
+	const string& getBandName(int bandId)
+	{ indexSiteTrans(); return bandNames[bandId]; }
+
+	/**
+	 * Retrieve the site term for the specified station/channel/band ids,
+	 * as returned by getStationId(), getChannelId() and getBandId().
+	 * This is a single hash table probe, much faster than the
+	 * string based getSiteTrans().
+	 * @param stationId
+	 * @param channelId
+	 * @param bandId
+	 * @return the site term, or NaN if not supported or any id is -1.
+	 */
+	float getSiteTrans(int stationId, int channelId, int bandId)
+	{
+		indexSiteTrans();
+		if (stationId < 0 || channelId < 0 || bandId < 0)
+			return NaN_FLOAT;
+
+		LONG_INT key = siteTransKey(stationId, channelId, bandId);
+		int mask = (int)siteTransHashKeys.size() - 1;
+		for (int slot = siteTransSlot(key); siteTransHashKeys[slot] != -1; slot = (slot+1) & mask)
+			if (siteTransHashKeys[slot] == key)
+				return siteTransHashValues[slot];
+		return NaN_FLOAT;
+	}
+
+	/**
+	 * Retrieve all the site terms of a station, for every channel and band.
+	 * Entries are ordered by channel name and then band name.
+	 * @param stationId the id of the station, as returned by getStationId().
+	 * @param channelIds (output) the channel id of each site term.
+	 * @param bandIds (output) the band id of each site term.
+	 * @param values (output) the site terms.
+	 * @return the number of site terms, zero if stationId is -1.
+	 */
+	int getSiteTrans(int stationId, vector<int>& channelIds,
+			vector<int>& bandIds, vector<float>& values)
+	{
+		indexSiteTrans();
+		if (stationId < 0)
+		{
+			channelIds.clear();
+			bandIds.clear();
+			values.clear();
+			return 0;
+		}
+		int first = siteTransStart[stationId], last = siteTransStart[stationId+1];
+		channelIds.assign(siteTransChannel.begin()+first, siteTransChannel.begin()+last);
+		bandIds.assign(siteTransBand.begin()+first, siteTransBand.begin()+last);
+		values.assign(siteTransValue.begin()+first, siteTransValue.begin()+last);
+		return last - first;
+	}
+
+	/**
+	 * Retrieve all the site terms of a station, for every channel and band.
+	 * Entries are ordered by channel name and then band name.
+	 * @param station the name of the station.
+	 * @param channelIds (output) the channel id of each site term.
+	 * @param bandIds (output) the band id of each site term.
+	 * @param values (output) the site terms.
+	 * @return the number of site terms, zero if the station is not supported.
+	 */
+	int getSiteTrans(const string& station, vector<int>& channelIds,
+			vector<int>& bandIds, vector<float>& values)
+	{ return getSiteTrans(getStationId(station), channelIds, bandIds, values); }
+
 	/**
 	 * Retrieve the total number site terms supported for all station/channel/bands
 	 * @return the total number site terms supported for all station/channel/bands
@@ -1053,10 +1257,17 @@ public:
 	 * Retrieve a reference to the map from a string representation of a frequency band, to the
 	 * same information stored as a 2 element array of doubles.
 	 * For example, key = '1.0_2.0', value = [1.0, 2.0]
+	 * Since the caller may modify the map, the band information cached by
+	 * getPathQ() is discarded.
 	 * @return  a reference to the map from a string representation of a frequency band, to the
 	 * same information stored as a 2 element array of doubles.
 	 */
-	map<string, vector<float> >&  getFrequencyMap() { return frequencyMap; }
+	map<string, vector<float> >&  getFrequencyMap()
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		bandQMap.clear();
+		return frequencyMap;
+	}
 
 	// Start definition of spreading related functions
 
@@ -1420,7 +1631,7 @@ public:
 	 * @param _siteTrans
 	 */
 	void setSiteTrans(map<string, map<string, map<string, float> > >& _siteTrans)
-	{ siteTrans = _siteTrans; }
+	{ siteTrans = _siteTrans; siteTransIndexed = false; }
 
 	/**
 	 * Set spreadmode string as above
@@ -269,6 +269,7 @@ void GeoTessModelAmplitude::loadModelAscii(IFStreamAscii& input, const string& i
 	string station, channel, band, ph;
 	float siteTran;
 
+	clearCaches();
 	frequencyMap.clear();
 	for (int i=0; i<getNAttributes(); ++i)
 	{
@@ -449,6 +450,7 @@ void GeoTessModelAmplitude::loadModelBinary(IFStreamBinary& input, const string&
 	int nStations, nChannels, nBands;
 	string station, channel, band, ph;
 
+	clearCaches();
 	frequencyMap.clear();
 	for (int i=0; i<getNAttributes(); ++i)
 	{
@@ -541,8 +543,376 @@ void GeoTessModelAmplitude::loadModelBinary(IFStreamBinary& input, const string&
 	}
 }
 
+GeoTessModelAmplitude::BandQ GeoTessModelAmplitude::getBandQ(const string& band)
+{
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		map<string, BandQ>::iterator it = bandQMap.find(band);
+		if (it != bandQMap.end())
+			return it->second;
+	}
+
+	BandQ b;
+	b.q0Index = b.etaIndex = -1;
+	b.centerFrequency = NaN_DOUBLE;
+
+	string attribute = "Q["+band+"]";
+	b.qIndex = getMetaData().getAttributeIndex(attribute);
+	if (b.qIndex < 0)
+	{
+		b.q0Index = getMetaData().getAttributeIndex("Q0");
+		b.etaIndex = getMetaData().getAttributeIndex("ETA");
+		if (b.q0Index < 0 || b.etaIndex < 0)
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
+					<< "Model does not support attributes Q0/ETA or " << attribute
+					<< ". Supported attributes include:" << endl;
+			for (int i=0; i<getNAttributes(); ++i)
+				os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
+
+			throw GeoTessException(os, __FILE__, __LINE__, 6005);
+		}
+
+		map<string, vector<float> >::iterator freq = frequencyMap.find(band);
+
+		if (freq == frequencyMap.end())
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
+					<< band << "is not a supported frequency band. Supported attributes include:" << endl;
+			for (int i=0; i<getNAttributes(); ++i)
+				os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
+
+			throw GeoTessException(os, __FILE__, __LINE__, 6005);
+		}
+
+		b.centerFrequency = sqrt((*freq).second[0] * (*freq).second[1]);
+
+		if (b.centerFrequency < 1e-6)
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
+					<< "centerFrequency = " << b.centerFrequency << " is too small." << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 6005);
+		}
+	}
+
+	lock_guard<mutex> lock(cacheMutex);
+	bandQMap[band] = b;
+	return b;
+}
+
+void GeoTessModelAmplitude::getPathWeights(GeoTessGreatCircle& path,
+		vector<pair<int, double> >& weights)
+{
+	const double* a = path.getFirst();
+	const double* b = path.getLast();
+	const double* n = path.getNormal();
+	vector<double> key(12);
+	for (int i = 0; i < 3; ++i)
+	{
+		key[i] = a[i];
+		key[i+3] = b[i];
+		key[i+8] = n[i];
+	}
+	key[11] = path.getDistance();
+	key[6] = dxkm;
+	key[7] = interpolatorType == "NATURAL_NEIGHBOR" ? 1. :
+			(interpolatorType == "LINEAR" ? 0. : -1.);
+
+	int generation = getPointMap()->getGeneration();
+
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		if (generation != pathWeightGeneration)
+		{
+			pathWeightCache.clear();
+			pathWeightGeneration = generation;
+		}
+
+		map<vector<double>, vector<pair<int, double> > >::iterator it = pathWeightCache.find(key);
+		if (it != pathWeightCache.end())
+		{
+			weights = it->second;
+			return;
+		}
+	}
+
+	double integrationInterval = dxkm / 6371.; // convert km to radians
+
+	map<int, double> w;
+	if (key[7] == 1.)
+		getWeights(path, integrationInterval, -1., GeoTessInterpolatorType::NATURAL_NEIGHBOR, w);
+	else if (key[7] == 0.)
+		getWeights(path, integrationInterval, -1., GeoTessInterpolatorType::LINEAR, w);
+
+	weights.assign(w.begin(), w.end());
+
+	lock_guard<mutex> lock(cacheMutex);
+	if (pathWeightCacheCapacity > 0 && generation == pathWeightGeneration)
+	{
+		if ((int) pathWeightCache.size() >= pathWeightCacheCapacity)
+			pathWeightCache.clear();
+		pathWeightCache[key] = weights;
+	}
+}
+
+GeoTessModelAmplitude::BandQ GeoTessModelAmplitude::getBandQ(double centerFrequency)
+{
+	BandQ b;
+	b.qIndex = -1;
+	b.q0Index = getMetaData().getAttributeIndex("Q0");
+	b.etaIndex = getMetaData().getAttributeIndex("ETA");
+	b.centerFrequency = centerFrequency;
+	if (b.q0Index < 0 || b.etaIndex < 0)
+	{
+		ostringstream os;
+		os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
+				<< "Model does not support attributes Q0/ETA. Supported attributes include:" << endl;
+		for (int i=0; i<getNAttributes(); ++i)
+			os << "  " << i << ":  " << getMetaData().getAttributeName(i) << endl;
+
+		throw GeoTessException(os, __FILE__, __LINE__, 6005);
+	}
+
+	if (!(centerFrequency >= 1e-6))
+	{
+		ostringstream os;
+		os << endl << "ERROR in GeoTessModelAmplitude::getPathQ" << endl
+				<< "centerFrequency = " << centerFrequency << " is too small." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 6005);
+	}
+	return b;
+}
+
+void GeoTessModelAmplitude::integratePathQ(const vector<BandQ>& bands,
+		const vector<pair<int, double> >& weights, vector<double>& pathQ)
+{
+	int nBands = (int) bands.size();
+	int n = (int) weights.size();
+
+	GeoTessPointMap* pm = getPointMap();
+
+	int q0Index = -1, etaIndex = -1;
+	for (int j = 0; j < nBands; ++j)
+		if (bands[j].qIndex < 0)
+		{
+			q0Index = bands[j].q0Index;
+			etaIndex = bands[j].etaIndex;
+		}
+
+	double pathLength = 0.;
+	vector<double> w(n);
+	for (int i = 0; i < n; ++i)
+	{
+		if (weights[i].first < 0)
+		{
+			pathQ.assign(nBands, NaN_DOUBLE);
+			return;
+		}
+		w[i] = weights[i].second;
+		pathLength += w[i];
+	}
+
+	// gather w/Q0 and ETA at each point once, for all the Q0/ETA bands.
+	vector<double> wq0, eta;
+	if (q0Index >= 0)
+	{
+		wq0.resize(n);
+		eta.resize(n);
+		for (int i = 0; i < n; ++i)
+		{
+			wq0[i] = w[i] / pm->getPointValueDouble(weights[i].first, q0Index);
+			eta[i] = -pm->getPointValueDouble(weights[i].first, etaIndex);
+		}
+	}
+
+	// integrate 1/Q in each band.  The inner loops have no dependencies
+	// between points other than the sum, so the compiler can vectorize them.
+	pathQ.resize(nBands);
+	for (int j = 0; j < nBands; ++j)
+	{
+		const BandQ& b = bands[j];
+		double integral = 0.;
+		if (b.qIndex >= 0)
+		{
+			for (int i = 0; i < n; ++i)
+				integral += w[i]/pm->getPointValueDouble(weights[i].first, b.qIndex);
+		}
+		else
+		{
+			const double logf = log(b.centerFrequency);
+			const double* pwq0 = wq0.data();
+			const double* peta = eta.data();
+			for (int i = 0; i < n; ++i)
+				integral += pwq0[i] * exp(peta[i] * logf);
+		}
+		pathQ[j] = pathLength/integral;
+	}
+}
+
+double GeoTessModelAmplitude::getPathQ(GeoTessGreatCircle& path, const string& band)
+{
+	vector<BandQ> bands(1, getBandQ(band));
+	vector<pair<int, double> > weights;
+	getPathWeights(path, weights);
+
+	vector<double> pathQ;
+	integratePathQ(bands, weights, pathQ);
+	return pathQ[0];
+}
+
+double GeoTessModelAmplitude::getPathQ(const string& band, const map<int, double>& weights)
+{
+	vector<BandQ> bands(1, getBandQ(band));
+	vector<pair<int, double> > w(weights.begin(), weights.end());
+
+	vector<double> pathQ;
+	integratePathQ(bands, w, pathQ);
+	return pathQ[0];
+}
+
+void GeoTessModelAmplitude::getPathQ(GeoTessGreatCircle& path, const vector<string>& bands,
+		vector<double>& pathQ)
+{
+	vector<BandQ> b(bands.size());
+	for (int i = 0; i < (int) bands.size(); ++i)
+		b[i] = getBandQ(bands[i]);
+
+	vector<pair<int, double> > weights;
+	getPathWeights(path, weights);
+
+	integratePathQ(b, weights, pathQ);
+}
+
+void GeoTessModelAmplitude::getPathQ(const vector<string>& bands,
+		const map<int, double>& weights, vector<double>& pathQ)
+{
+	vector<BandQ> b(bands.size());
+	for (int i = 0; i < (int) bands.size(); ++i)
+		b[i] = getBandQ(bands[i]);
+
+	vector<pair<int, double> > w(weights.begin(), weights.end());
+
+	integratePathQ(b, w, pathQ);
+}
+
+void GeoTessModelAmplitude::getPathQ(GeoTessGreatCircle& path,
+		const vector<double>& centerFrequencies, vector<double>& pathQ)
+{
+	vector<BandQ> b(centerFrequencies.size());
+	for (int i = 0; i < (int) centerFrequencies.size(); ++i)
+		b[i] = getBandQ(centerFrequencies[i]);
+
+	vector<pair<int, double> > weights;
+	getPathWeights(path, weights);
+
+	integratePathQ(b, weights, pathQ);
+}
+
+void GeoTessModelAmplitude::getPathQ(const vector<double>& centerFrequencies,
+		const map<int, double>& weights, vector<double>& pathQ)
+{
+	vector<BandQ> b(centerFrequencies.size());
+	for (int i = 0; i < (int) centerFrequencies.size(); ++i)
+		b[i] = getBandQ(centerFrequencies[i]);
+
+	vector<pair<int, double> > w(weights.begin(), weights.end());
+
+	integratePathQ(b, w, pathQ);
+}
+
+void GeoTessModelAmplitude::buildSiteTransIndex()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	if (siteTransIndexed)
+		return;
+
+	map<string, map<string, map<string, float> > >::iterator it1;
+	map<string, map<string, float> >::iterator it2;
+	map<string, float>::iterator it3;
+
+	// intern the station, channel and band names.  Ids follow name order.
+	stationIds.clear();
+	channelIds.clear();
+	bandIds.clear();
+	int nSiteTrans = 0;
+	for (it1 = siteTrans.begin(); it1 != siteTrans.end(); ++it1)
+	{
+		stationIds[(*it1).first] = 0;
+		for (it2 = (*it1).second.begin(); it2 != (*it1).second.end(); ++it2)
+		{
+			channelIds[(*it2).first] = 0;
+			for (it3 = (*it2).second.begin(); it3 != (*it2).second.end(); ++it3)
+			{
+				bandIds[(*it3).first] = 0;
+				++nSiteTrans;
+			}
+		}
+	}
+
+	map<string, int>* ids[3] = { &stationIds, &channelIds, &bandIds };
+	vector<string>* names[3] = { &stationNames, &channelNames, &bandNames };
+	for (int i = 0; i < 3; ++i)
+	{
+		names[i]->clear();
+		names[i]->reserve(ids[i]->size());
+		for (map<string, int>::iterator it = ids[i]->begin(); it != ids[i]->end(); ++it)
+		{
+			(*it).second = (int) names[i]->size();
+			names[i]->push_back((*it).first);
+		}
+	}
+
+	// size the hash table to a power of two at least twice the number of entries.
+	siteTransHashBits = 1;
+	while ((1 << siteTransHashBits) < 2*nSiteTrans)
+		++siteTransHashBits;
+	int mask = (1 << siteTransHashBits) - 1;
+	siteTransHashKeys.assign(mask+1, -1);
+	siteTransHashValues.assign(mask+1, NaN_FLOAT);
+
+	siteTransStart.clear();
+	siteTransStart.reserve(stationNames.size()+1);
+	siteTransChannel.clear();
+	siteTransChannel.reserve(nSiteTrans);
+	siteTransBand.clear();
+	siteTransBand.reserve(nSiteTrans);
+	siteTransValue.clear();
+	siteTransValue.reserve(nSiteTrans);
+
+	int stationId = 0;
+	for (it1 = siteTrans.begin(); it1 != siteTrans.end(); ++it1, ++stationId)
+	{
+		siteTransStart.push_back((int) siteTransValue.size());
+		for (it2 = (*it1).second.begin(); it2 != (*it1).second.end(); ++it2)
+		{
+			int channelId = channelIds[(*it2).first];
+			for (it3 = (*it2).second.begin(); it3 != (*it2).second.end(); ++it3)
+			{
+				int bandId = bandIds[(*it3).first];
+				siteTransChannel.push_back(channelId);
+				siteTransBand.push_back(bandId);
+				siteTransValue.push_back((*it3).second);
+
+				LONG_INT key = siteTransKey(stationId, channelId, bandId);
+				int slot = siteTransSlot(key);
+				while (siteTransHashKeys[slot] != -1)
+					slot = (slot+1) & mask;
+				siteTransHashKeys[slot] = key;
+				siteTransHashValues[slot] = (*it3).second;
+			}
+		}
+	}
+	siteTransStart.push_back((int) siteTransValue.size());
+
+	siteTransIndexed.store(true, memory_order_release);
+}
+
 map<string, vector<float> >& GeoTessModelAmplitude::refreshFrequencyMap()
 {
+	clearCaches();
 	frequencyMap.clear();
 	string band, attribute;
 
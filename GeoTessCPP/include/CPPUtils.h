@@ -158,6 +158,15 @@ public:
 	 */
 	static void removePathSeparator(string& path);
 
+	/**
+	 * Retrieve the names of the regular files in a directory, in
+	 * alphabetical order.  Subdirectories are not included.
+	 * @param directory the directory to search.
+	 * @param names (output) the file names, without the directory.
+	 * @return false if the directory could not be opened.
+	 */
+	static bool listFiles(const string& directory, vector<string>& names);
+
 	/**
 	 * Static functions that returns the input integer, float, double,
 	 * or boolean, as a string.
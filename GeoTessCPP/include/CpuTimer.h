@@ -65,9 +65,9 @@ class GEOTESS_EXP_IMP CpuTimer
 {
   private:
 
-    // Last real time set when init_timer was called or 'this' CpuTimer was
-    // constructed (msec)
-    double						cpuRealTime;
+    // Last monotonic time set when init_timer was called or 'this' CpuTimer
+    // was constructed (nsec)
+    long long					cpuRealTime;
 
     // Last cpu time set when init_timer was called or 'this' CpuTimer was
     // constructed (msec)
@@ -82,16 +82,27 @@ class GEOTESS_EXP_IMP CpuTimer
     void							initTimer();
 
     /**
-     * Returns the current CPU time in msec since process start.
+     * Returns the current CPU time in msec since process start.  Uses the
+     * process cpu-time clock where available, which has nanosecond
+     * resolution, otherwise clock().
+     */
+    static double			getCurrCPUTime();
+
+    /**
+     * Returns the current real time (wall clock) in msec since 1970, with
+     * sub-millisecond resolution.  The wall clock can jump (e.g., when the
+     * system time is synchronized) so use getNanoTime() to measure
+     * elapsed times.
      */
-    static double			getCurrCPUTime()
-    									{ return (double) 1000.0 * clock() / CLOCKS_PER_SEC; }
+    static double			getCurrRealTime();
 
     /**
-     * Returns the current real time (wall clock) in msec since 1970.
+     * Returns the current value of a monotonic clock in nsec, relative to
+     * an arbitrary origin.  Only differences between values are
+     * meaningful.  All elapsed real times reported by CpuTimer are
+     * measured with this clock.
      */
-    static double			getCurrRealTime()
-    									{ return (double) 1000.0 * time(NULL); }
+    static long long	getNanoTime();
 
     // Returns cpu time (ms) since last init_timer call. The second
     // function also reinitializes cpuCPUTime.
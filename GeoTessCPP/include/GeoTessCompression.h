@@ -0,0 +1,151 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#ifndef GEOTESS_COMPRESSION_H
+#define GEOTESS_COMPRESSION_H
+
+// **** _SYSTEM INCLUDES_ ******************************************************
+
+#include <vector>
+
+// use standard library objects
+using namespace std;
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "CPPUtils.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _FORWARD REFERENCES_ ***************************************************
+
+class GeoTessMetaData;
+class GeoTessProfile;
+class IFStreamBinary;
+
+// **** _CLASS DEFINITION_ *****************************************************
+
+/**
+ * \brief Compressed storage of the profile section of binary GeoTess model files.
+ *
+ * When GeoTessMetaData::isCompressed() is true, GeoTessModel::writeModelBinary()
+ * replaces the profile section of the file with a sequence of independently
+ * compressed blocks, each holding the profiles of blockVertices consecutive
+ * vertices.  The file header (metadata) and the grid are not affected.
+ * <p>Within a block the profiles are transposed into separate streams:
+ * profile types, node counts, radii and then one stream per attribute.
+ * Radii and unquantized attribute values are stored as the exclusive-or of
+ * each value with the previous value of the same stream, split into byte
+ * planes, so that the slowly varying sign, exponent and high order mantissa
+ * bits become long runs of zeros.  Attributes for which a quantization
+ * precision has been specified (see GeoTessMetaData::setQuantization()) are
+ * rounded to a multiple of the precision and stored as variable length
+ * differences, which is lossy: values change by at most half the precision.
+ * Each block is then compressed with a byte oriented LZ77 coder, similar to
+ * LZ4, that is implemented in this class.
+ * <p>Blocks are compressed and decompressed concurrently with
+ * GeoTessParallel.
+ */
+class GEOTESS_EXP_IMP GeoTessCompression
+{
+private:
+
+	/**
+	 * Serialize the profiles of vertices [first, last) into raw.
+	 */
+	static void encodeBlock(GeoTessProfile*** profiles, const int& first, const int& last,
+			GeoTessMetaData& metaData, vector<uByte>& raw);
+
+	/**
+	 * Rebuild the profiles of vertices [first, last) from raw.
+	 */
+	static void decodeBlock(const vector<uByte>& raw, const int& first, const int& last,
+			GeoTessMetaData& metaData, GeoTessProfile*** profiles);
+
+public:
+
+	/**
+	 * The default number of vertices whose profiles are stored in one
+	 * compressed block.
+	 */
+	static const int BLOCK_VERTICES = 1024;
+
+	/**
+	 * Compress input with the LZ77 block coder.  Output is cleared first.
+	 * The compressed data do not record the length of the input, which the
+	 * caller must supply to decompress().
+	 */
+	static void compress(const vector<uByte>& input, vector<uByte>& output);
+
+	/**
+	 * Decompress data produced by compress().
+	 * @param input the compressed data.
+	 * @param inputLength the number of bytes of compressed data.
+	 * @param output (output) array that receives the decompressed data.
+	 * @param outputLength the number of bytes that compress() was given.
+	 * @throws GeoTessException if the compressed data are corrupt.
+	 */
+	static void decompress(const uByte* input, const int& inputLength,
+			uByte* output, const int& outputLength);
+
+	/**
+	 * Write the profiles of a model as compressed blocks.
+	 * @param output the stream to which the blocks are written.
+	 * @param profiles nVertices x nLayers array of profiles.
+	 * @param metaData the model metadata, which supplies the number of
+	 * vertices, layers and attributes, the DataType and the quantization
+	 * precision of each attribute.
+	 */
+	static void writeProfiles(IFStreamBinary& output, GeoTessProfile*** profiles,
+			GeoTessMetaData& metaData);
+
+	/**
+	 * Read profiles written by writeProfiles().  The attribute filter of the
+	 * metadata, if any, is honored.
+	 * @param input the stream from which the blocks are read.
+	 * @param profiles nVertices x nLayers array that receives the profiles.
+	 * @param metaData the model metadata.
+	 * @throws GeoTessException if the compressed data are corrupt.
+	 */
+	static void readProfiles(IFStreamBinary& input, GeoTessProfile*** profiles,
+			GeoTessMetaData& metaData);
+
+}; // end class GeoTessCompression
+
+} // end namespace geotess
+
+#endif /* GEOTESS_COMPRESSION_H */
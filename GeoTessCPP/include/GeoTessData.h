@@ -41,6 +41,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <atomic>
 
 // use standard library objects
 using namespace std;
@@ -77,9 +78,10 @@ class GEOTESS_EXP_IMP GeoTessData
   private:
 
 		/**
-		 * The static class instance count.
+		 * The static class instance count.  Atomic so that instances
+		 * can be constructed concurrently, e.g., by GeoTessCompression.
 		 */
-		static int				aClassCount;
+		static atomic<int>			aClassCount;
 
 	public:
 
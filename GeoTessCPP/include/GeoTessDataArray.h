@@ -161,7 +161,7 @@ public:
 		if (nValues > 0)
 		{
 			values = new T [nValues];
-			T val;
+			T val = 0;
 			for (int i=0; i<(int)filter.size(); ++i)
 			{
 				ifs.readType(val);
@@ -422,6 +422,14 @@ public:
 		return new GeoTessDataArray<T>(values, nValues);
 	}
 
+	/**
+	 * Retrieve a reference to the array of values managed by this DataArray.
+	 * This is a non-virtual accessor intended for bulk operations that have
+	 * already established the concrete type of the Data object and want to
+	 * avoid a virtual call per value.  Caller should not delete the array.
+	 */
+	T*						getValuesArray() { return values; }
+
 }; // end class DataArray
 
 /// @cond PROTECTED  Turn off doxygen documentation until 'endcond' is found
@@ -125,7 +125,7 @@ public:
 	 */
 	GeoTessDataValue(IFStreamAscii& ifs, vector<int>& filter) : GeoTessData(), value(0)
 	{
-		T val;
+		T val = 0;
 		for (int i=0; i<(int)filter.size(); ++i)
 		{
 			ifs.readType(val);
@@ -307,6 +307,14 @@ public:
 		return new GeoTessDataValue<T>(value);
 	}
 
+	/**
+	 * Retrieve a reference to the single value managed by this DataValue,
+	 * as a one-element array.  This is a non-virtual accessor intended for
+	 * bulk operations that have already established the concrete type of
+	 * the Data object.  Caller should not delete the array.
+	 */
+	T*						getValuesArray() { return &value; }
+
 }; // end class DataValue
 
 /// @cond PROTECTED  Turn off doxygen documentation until 'endcond' is found
@@ -651,6 +651,38 @@ class GEOTESS_EXP_IMP GeoTessGreatCircle
 		return dx;
 	}
 
+	/**
+	 * Retrieve a bunch of unit vectors equally spaced along the great circle
+	 * between initial and final points that define the great circle.
+	 * Points are returned in structure-of-arrays layout: the components of
+	 * the i'th point are x[i], y[i] and z[i].
+	 *
+	 * <p>This is much faster than calling getPoint() npoints times since sin and
+	 * cos are evaluated only once per GeoTessUtils::SINCOS_BLOCK points.
+	 * Supplied arrays must be large enough to hold the specified number
+	 * of points.  This method neither creates nor deletes any memory.
+	 *
+	 * @param x array of length npoints populated with the x components of the points.
+	 * @param y array of length npoints populated with the y components of the points.
+	 * @param z array of length npoints populated with the z components of the points.
+	 * @param npoints the number of points desired.
+	 * @param onCenters if true, the points are
+	 * located at the centers of path increments of equal size.
+	 * If onCenters is false, the first point is located at the starting point
+	 * of the great circle, the last point is located at the final point of the
+	 * great circle and the remaining points are equally spaced in between.
+	 * @return actual spacing between the points in radians.
+	 */
+	double getPoints(double* x, double* y, double* z, const int &npoints, const bool& onCenters=false)
+	{
+		if (npoints <= 0) return 0.;
+		double dx = onCenters ? getDistance()/npoints
+				: npoints == 1 ? 0. : getDistance()/(npoints-1);
+		const double* gc[2] = {firstPoint, moveDirection};
+		GeoTessUtils::getGreatCirclePoints(gc, onCenters ? dx/2 : 0., dx, npoints, x, y, z);
+		return dx;
+	}
+
 	/**
 	 * Retrieve the unit vector that lies at the intersection of this GreatCircle
 	 * and another GreatCircle. There are, in general, two such intersections
@@ -241,7 +241,7 @@ protected:
 		tessellations(NULL), nTessellations(0),
 		descendants(NULL), gridID(gid),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{
 	}
 
@@ -333,6 +333,11 @@ private:
 	 */
 	int refCount;
 
+	/**
+	 * Time, in seconds, spent in the most recent call to initialize(), or -1.
+	 */
+	double initializeTime;
+
 	/**
 	 * An nLevels x nVertices x n array that stores the indices of the n
 	 * triangles of which each vertex is a member.
@@ -407,7 +412,7 @@ public:
 		tessellations(NULL), nTessellations(0),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ }
 
 	/**
@@ -417,7 +422,7 @@ public:
 		vertices(NULL), triangles(NULL), levels(NULL), tessellations(NULL),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ loadGridAscii(input); }
 
 	/**
@@ -427,7 +432,7 @@ public:
 		vertices(NULL), triangles(NULL), levels(NULL), tessellations(NULL),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ loadGridBinary(input); }
 
 	/**
@@ -1331,7 +1336,7 @@ public:
 		tessellations(NULL), nTessellations(0),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ }
 
 	/**
@@ -1342,7 +1347,7 @@ public:
 		vertices(NULL), triangles(NULL), levels(NULL), tessellations(NULL),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ loadGridAscii(input); }
 
 	/**
@@ -1353,7 +1358,7 @@ public:
 		vertices(NULL), triangles(NULL), levels(NULL), tessellations(NULL),
 		descendants(NULL), gridID(""),
 		gridInputFile("null"), gridOutputFile("null"), gridSoftwareVersion(""),
-		gridGenerationDate(""), refCount(0)
+		gridGenerationDate(""), refCount(0), initializeTime(-1.)
 	{ loadGridBinary(input); }
 
 	/**
@@ -1379,7 +1384,7 @@ public:
 				gridOutputFile(_gridOutputFile),
 				gridSoftwareVersion(_gridSoftwareVersion),
 				gridGenerationDate(_gridGenerationDate),
-				refCount(0)
+				refCount(0), initializeTime(-1.)
 	{ initialize(); }
 
 	/**
@@ -1392,6 +1397,13 @@ public:
 	 */
 	int getReferenceCount() { return refCount; }
 
+	/**
+	 * Retrieve the time, in seconds, that was spent computing the
+	 * neighbors, descendants and vertex triangles of this grid when it
+	 * was loaded, or -1.
+	 */
+	double getInitializeTime() const { return initializeTime; }
+
 	/**
 	 * Add reference count;
 	 */
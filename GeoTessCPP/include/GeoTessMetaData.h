@@ -70,6 +70,8 @@ namespace geotess
 
 // **** _FORWARD REFERENCES_ ***************************************************
 
+class GeoTessPolygon;
+
 // **** _CLASS DEFINITION_ *****************************************************
 
 /**
@@ -197,6 +199,12 @@ private:
 	 */
 	double loadTimeModel;
 
+	/**
+	 * Time, in seconds, spent in each phase of the most recent model load,
+	 * in the order in which the phases were first executed.
+	 */
+	vector<pair<string, double> > loadProfile;
+
 	/**
 	 * Name of file to which the model was written, or "none".
 	 */
@@ -213,6 +221,38 @@ private:
 	 */
 	double writeTimeModel;
 
+	/**
+	 * If true, the profiles are written to binary files as compressed
+	 * blocks.  See GeoTessCompression.
+	 */
+	bool compressed;
+
+	/**
+	 * Quantization precision of each attribute in compressed binary files.
+	 * Zero, or a missing entry, means the attribute is stored losslessly.
+	 */
+	vector<double> quantization;
+
+	/**
+	 * If true, profiles loaded from binary files are decoded the first
+	 * time they are used rather than when the file is loaded.  See
+	 * GeoTessProfileLazy.
+	 */
+	bool lazyLoading;
+
+	/**
+	 * If not NULL, only the profiles of vertices inside this polygon, and
+	 * of loadRegionHalo rings of neighbors around them, are loaded.
+	 * See setLoadRegion().
+	 */
+	GeoTessPolygon* loadRegion;
+
+	/**
+	 * Number of rings of neighboring vertices around loadRegion whose
+	 * profiles are also loaded.
+	 */
+	int loadRegionHalo;
+
 	/**
 	 * Reference count.
 	 */
@@ -315,8 +355,8 @@ public:
 					NULL), attributeUnits(NULL), boolAttributeFilter(false),
 					inputModelFile("none"), inputGridFile("none"), loadTimeModel(-1.0),
 					outputModelFile("none"), outputGridFile("none"), writeTimeModel(-1.0),
-					refCount(0), reuseGrids(true), modelSoftwareVersion(""), modelGenerationDate(""),
-					eulerRotationAngles(NULL), eulerGridToModel(NULL), eulerModelToGrid(NULL)
+					compressed(false), lazyLoading(false), loadRegion(NULL), loadRegionHalo(2), refCount(0), reuseGrids(true), modelSoftwareVersion(""),
+					modelGenerationDate(""), eulerRotationAngles(NULL), eulerGridToModel(NULL), eulerModelToGrid(NULL)
 	{ }
 
 	/**
@@ -522,6 +562,42 @@ public:
 		return loadTimeModel;
 	}
 
+	/**
+	 * Retrieve the amount of time, in seconds, spent in each phase of the
+	 * most recent model load, in the order in which the phases were executed.
+	 * Phases recorded by GeoTessModel are:
+	 * <ul>
+	 * <li>"metadata" -- reading the model metadata
+	 * <li>"profiles" -- reading and decoding the profiles
+	 * <li>"grid" -- reading the grid, or finding it in the grid reuse map,
+	 * excluding GeoTessGrid::initialize()
+	 * <li>"grid initialize" -- GeoTessGrid::initialize(); 0 if the grid was reused
+	 * <li>"point map" -- constructing the GeoTessPointMap
+	 * <li>"active region" -- setActiveRegion()
+	 * </ul>
+	 * Classes that extend GeoTessModel may record additional phases.
+	 * @return the load profile as (phase name, seconds) pairs.
+	 */
+	const vector<pair<string, double> >& getLoadProfile() const
+	{
+		return loadProfile;
+	}
+
+	/**
+	 * Retrieve the amount of time, in seconds, spent in the specified phase
+	 * of the most recent model load, or -1 if the phase was not recorded.
+	 * See getLoadProfile() for the names of the phases.
+	 * @param phase the name of the phase
+	 * @return seconds spent in the phase, or -1.
+	 */
+	double getLoadTime(const string& phase) const
+	{
+		for (int i=0; i<(int)loadProfile.size(); ++i)
+			if (loadProfile[i].first == phase)
+				return loadProfile[i].second;
+		return -1.;
+	}
+
 	/**
 	 * Retrieve the name of the file to which the model was most recently written, or "none".
 	 *
@@ -1128,6 +1204,29 @@ public:
 	 */
 	void setLoadTimeModel(double ltm) { loadTimeModel = ltm; }
 
+	/**
+	 * Add time, in seconds, to the specified phase of the load profile.
+	 * The phase is appended to the profile if it is not already there.
+	 *
+	 * @param phase the name of the phase.
+	 * @param seconds the time spent in the phase.
+	 */
+	void addLoadTime(const string& phase, double seconds)
+	{
+		for (int i=0; i<(int)loadProfile.size(); ++i)
+			if (loadProfile[i].first == phase)
+			{
+				loadProfile[i].second += seconds;
+				return;
+			}
+		loadProfile.push_back(pair<string, double>(phase, seconds));
+	}
+
+	/**
+	 * Discard the load profile.  Called at the start of every model load.
+	 */
+	void clearLoadProfile() { loadProfile.clear(); }
+
 	/**
 	 * Set the name of the file to which the model has been written
 	 *
@@ -1153,6 +1252,110 @@ public:
 
 	void setModelFileFormat(int version) { modelFileFormat = version; }
 
+	/**
+	 * Returns true if binary model files are written with compressed
+	 * profiles, or if the model was loaded from such a file.
+	 */
+	bool isCompressed() const { return compressed; }
+
+	/**
+	 * Specify whether GeoTessModel::writeModelBinary() should store the
+	 * profiles as compressed blocks (see GeoTessCompression).  Compressed
+	 * files can only be read by versions of GeoTess that support them.
+	 * Ascii files are never compressed.  Default is false.
+	 * @param compress true to compress the profiles of binary files.
+	 */
+	void setCompressed(bool compress) { compressed = compress; }
+
+	/**
+	 * Retrieve the precision to which the specified attribute is quantized
+	 * in compressed binary files, or 0 if it is stored losslessly.
+	 * @param attributeIndex index of the attribute.
+	 * @return the quantization precision of the attribute.
+	 */
+	double getQuantization(int attributeIndex) const
+	{
+		return attributeIndex >= 0 && attributeIndex < (int)quantization.size()
+				? quantization[attributeIndex] : 0.;
+	}
+
+	/**
+	 * Specify the precision to which an attribute is rounded when the model
+	 * is written to a compressed binary file.  Values are stored as the
+	 * nearest multiple of precision, so they change by at most precision/2,
+	 * and the smaller range of values compresses much better.  Only applies
+	 * to models with DataType DOUBLE or FLOAT.  Specify 0 to store the
+	 * attribute losslessly, which is the default.  Has no effect unless
+	 * setCompressed(true) is called as well.
+	 * @param attributeIndex index of the attribute.
+	 * @param precision the quantization precision, in the units of the attribute.
+	 */
+	void setQuantization(int attributeIndex, double precision);
+
+	/**
+	 * Replace the quantization precision of all attributes.  Element i is
+	 * the precision of attribute i.
+	 */
+	void setQuantization(const vector<double>& precision) { quantization = precision; }
+
+	/**
+	 * Returns true if profiles loaded from binary files are decoded the
+	 * first time they are used.
+	 */
+	bool isLazyLoading() const { return lazyLoading; }
+
+	/**
+	 * Specify whether profiles should be decoded the first time they are
+	 * used rather than when a binary model file is loaded.  The undecoded
+	 * profiles are retained in memory in their compact file format and
+	 * each is decoded when it is first touched by a GeoTessPosition, the
+	 * GeoTessPointMap or any other caller.  Profile type, number of nodes and
+	 * the radii of the top and bottom of each layer are available without
+	 * decoding, so a service that only interpolates the layers near the
+	 * surface of a whole-Earth model never pays to decode the deeper layers.
+	 * Like the attribute filter, this must be specified before the model is
+	 * loaded.  It is ignored for ascii files and for binary files with
+	 * compressed profiles, which are always decoded in full.  Default is
+	 * false.
+	 * @param lazy true to decode profiles on first use.
+	 */
+	void setLazyLoading(bool lazy) { lazyLoading = lazy; }
+
+	/**
+	 * Restrict the next model load to a region of interest.  Only the
+	 * profiles of vertices inside the polygon, plus halo rings of
+	 * neighboring vertices so that positions inside the polygon can be
+	 * interpolated, are kept.  The profiles of all other vertices are
+	 * replaced with empty profiles that preserve the layer radii but carry
+	 * no data, so interpolated values outside the region are NaN and the
+	 * point map only contains points in the region.  With binary files, the
+	 * profiles of discarded vertices are never decoded.  Use
+	 * GeoTessPolygon(center, radius, nEdges) for a spherical cap.
+	 * <p>Like the attribute filter, this must be specified before the model
+	 * is loaded.  A model loaded this way is a regional model: if it is
+	 * written to file, the empty profiles are written too.
+	 * <p>GeoTessPolygon implements reference counting.  This metadata
+	 * increments the reference count of polygon and releases it when it is
+	 * replaced or when the metadata is deleted.
+	 * @param polygon the region of interest, or NULL to load the whole model.
+	 * @param halo the number of rings of neighboring vertices, in the top
+	 * level of each tessellation, to keep around the vertices inside the
+	 * polygon.  One ring suffices for linear interpolation, natural neighbor
+	 * interpolation requires two.  Default is 2.
+	 */
+	void setLoadRegion(GeoTessPolygon* polygon, int halo = 2);
+
+	/**
+	 * Retrieve the region of interest set with setLoadRegion(), or NULL.
+	 */
+	GeoTessPolygon* getLoadRegion() const { return loadRegion; }
+
+	/**
+	 * Retrieve the number of rings of neighboring vertices kept around the
+	 * region of interest.
+	 */
+	int getLoadRegionHalo() const { return loadRegionHalo; }
+
 	/**
 	 * Specify the 3 euler rotation angles, in degrees, that will control grid rotations.
 	 * <p>There are possibly two geographic coordinate systems at play:
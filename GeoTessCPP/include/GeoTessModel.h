@@ -54,6 +54,7 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <mutex>
 
 // use standard library objects
 using namespace std;
@@ -61,6 +62,7 @@ using namespace std;
 // **** _LOCAL INCLUDES_ *******************************************************
 
 #include "CPPUtils.h"
+#include "CpuTimer.h"
 #include "GeoTessUtils.h"
 #include "GeoTessInterpolatorType.h"
 #include "GeoTessException.h"
@@ -143,6 +145,22 @@ protected:
 	 */
 	static	map<string, GeoTessGrid*> 	reuseGridMap;
 
+	/**
+	 * Guards reuseGridMap and the reference counts of the grids it holds so
+	 * that models that share grids can be loaded and deleted concurrently.
+	 */
+	static	mutex						reuseGridMutex;
+
+	/**
+	 * Add a reference to a grid that was just loaded and, if reuse is true,
+	 * add it to reuseGridMap.  If another thread added a grid with the same
+	 * gridID to the map after acquireReuseGrid() returned NULL, the new grid
+	 * is deleted and the one in the map is returned instead, with a reference
+	 * added.  Thread safe.
+	 */
+	static GeoTessGrid* registerReuseGrid(GeoTessGrid* grid, const string& gridID,
+			bool reuse);
+
 	/**
 	 * The GeoTessGrid object that supports the 2D components of the model grid.
 	 */
@@ -179,11 +197,25 @@ protected:
 	 */
 	GeoTessPointMap*														pointMap;
 
+	/**
+	 * When profiles are loaded lazily (see GeoTessMetaData::setLazyLoading()),
+	 * the binary encoding of the profiles that have not been decoded yet.
+	 * NULL otherwise.
+	 */
+	IFStreamBinary*															lazyProfileData;
+
 	/**
 	 * Deletes the profiles array if it has been allocated
 	 */
 	void deleteProfiles();
 
+	/**
+	 * Replace the profiles of vertices outside the region of interest
+	 * specified with GeoTessMetaData::setLoadRegion() with empty profiles.
+	 * Called by loadModel() after the profiles and the grid are loaded.
+	 */
+	void applyLoadRegion();
+
 	/**
 	 * Load a model (3D grid and data) from an ascii File.
 	 */
@@ -282,12 +314,13 @@ protected:
 			const string& relGridFilePath, const string& gridFileName,
 			const string& gridID, const string& funcName)
 	{
-		// process grid
+		// process grid.  Time spent in GeoTessGrid::initialize() is reported
+		// separately from time spent reading the grid.
+
+		CpuTimer timer;
+		double initializeTime = 0.;
 
-		grid = NULL;
-		map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(gridID);
-		if (it != reuseGridMap.end())
-			grid = it->second;
+		grid = acquireReuseGrid(gridID);
 
 		if (gridFileName == "*")
 		{
@@ -296,14 +329,11 @@ protected:
 			// file is positioned where classes that extend GeoTessModel can read
 			// additional data.
 			GeoTessGrid* g = new GeoTessGrid(input);
+			initializeTime = g->getInitializeTime();
 			if (!grid)
 			{
-				grid = g;
-
-				grid->setGridInputFile(metaData->getInputModelFile());
-
-				if (metaData->isGridReuseOn())
-					reuseGridMap[gridID] = grid;
+				g->setGridInputFile(metaData->getInputModelFile());
+				grid = registerReuseGrid(g, gridID, metaData->isGridReuseOn());
 			}
 			else
 				delete g;
@@ -319,27 +349,28 @@ protected:
 			if (inputDirectory != "")
 				gridFil = CPPUtils::insertPathSeparator(inputDirectory, gridFil);
 
-			grid = new GeoTessGrid();
-			grid->loadGrid(gridFil);
-			if (metaData->isGridReuseOn())
-				reuseGridMap[gridID] = grid;
+			GeoTessGrid* g = new GeoTessGrid();
+			g->loadGrid(gridFil);
+			initializeTime = g->getInitializeTime();
 
 			// throw an error if the grid ID's are not equal
 
-			if (grid->getGridID() != gridID)
+			if (g->getGridID() != gridID)
 			{
 				ostringstream os;
 				os << endl << "ERROR in GeoTessModel::" + funcName << endl
 						<< "gridIDs in model file and existingGrid are not equal: "
 						<< endl << "  Model File gridID = " << gridID << endl
-						<< "  Grid File gridID  = " << grid->getGridID() << endl;
+						<< "  Grid File gridID  = " << g->getGridID() << endl;
+				delete g;
 				throw GeoTessException(os, __FILE__, __LINE__, 1002);
 			}
-		}
 
-		// add a reference to the grid and build the point map
+			grid = registerReuseGrid(g, gridID, metaData->isGridReuseOn());
+		}
 
-		grid->addReference();
+		metaData->addLoadTime("grid", timer.realTime() * 1e-3 - initializeTime);
+		metaData->addLoadTime("grid initialize", initializeTime);
 	}
 
 private:
@@ -578,6 +609,8 @@ public:
 						memory += profiles[i][j]->getMemory();
 		if (pointMap)
 			memory += pointMap->getMemory();
+		if (lazyProfileData)
+			memory += lazyProfileData->getCapacity();
 
 		return memory;
 	}
@@ -590,6 +623,7 @@ public:
 	 */
 	static LONG_INT getReuseGridMapMemory()
 	{
+		lock_guard<mutex> lock(reuseGridMutex);
 		// this ignores some memory allocated to support the map.  It is complicated and
 		// platform dependent.  Also probably small compared to the size of the Grids.
 		LONG_INT memory = sizeof(map<string, GeoTessGrid*>);
@@ -608,14 +642,36 @@ public:
 	 * returns the size of the map that supports this functionality.
 	 * @return size of reuseGridMap.
 	 */
-	static int getReuseGridMapSize() { return reuseGridMap.size(); }
+	static int getReuseGridMapSize()
+	{
+		lock_guard<mutex> lock(reuseGridMutex);
+		return (int) reuseGridMap.size();
+	}
 
 	/**
 	 * GeoTessModel will attempt to reuse grids that it has already loaded into
 	 * memory when a new model tries to reload the same grid.  This method
 	 * clears the map that supports this functionality.
 	 */
-	static void clearReuseGrid() { reuseGridMap.clear(); }
+	static void clearReuseGrid()
+	{
+		lock_guard<mutex> lock(reuseGridMutex);
+		reuseGridMap.clear();
+	}
+
+	/**
+	 * Return the grid with the specified gridID from reuseGridMap, with a
+	 * reference added, or NULL if the map does not contain such a grid.
+	 * The caller must eventually pass the grid to releaseGrid().
+	 * Thread safe.
+	 */
+	static GeoTessGrid* acquireReuseGrid(const string& gridID);
+
+	/**
+	 * Remove a reference from grid.  If it is no longer referenced, remove it
+	 * from reuseGridMap and delete it.  Thread safe.
+	 */
+	static void releaseGrid(GeoTessGrid* grid);
 
 	/**
 	 *  Retrieve a reference to the ellipsoid that is stored in this GeoTessModel.  This EarthShape
@@ -750,6 +806,21 @@ public:
 	GeoTessPosition* getPosition(const GeoTessInterpolatorType& horizontalType,
 			const GeoTessInterpolatorType& radialType);
 
+	/**
+	 * Compute all the information that this model, its grid and its profiles
+	 * compute lazily the first time they are interpolated with the
+	 * specified interpolators: triangle circumcenters and spoke lists for
+	 * NATURAL_NEIGHBOR, spline coefficients for CUBIC_SPLINE.
+	 * Once this method has returned, separate GeoTessPosition objects
+	 * obtained from this model with the same interpolators may be used
+	 * concurrently from multiple threads, one GeoTessPosition per thread.
+	 * Calling it more than once is harmless.
+	 * @param horizontalType the horizontal interpolator that will be used
+	 * @param radialType the radial interpolator that will be used
+	 */
+	void prepareInterpolation(const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType);
+
 	/**
 	 * Return number of vertices in the 2D geographic grid.
 	 * @return number of vertices in the 2D geographic grid.
@@ -1128,6 +1199,27 @@ public:
 			pointMap->setActiveRegion(polygon);
 	}
 
+	/**
+	 * Expand the active region to include the nodes contained within the
+	 * specified Polygon object.  The active region becomes the union of all
+	 * the polygons that have been added.  See GeoTessPointMap::addActiveRegion().
+	 * @param polygon a Polygon or Polygon3D object.
+	 */
+	void addActiveRegion(GeoTessPolygon* polygon)
+	{
+		pointMap->addActiveRegion(polygon);
+	}
+
+	/**
+	 * Shrink the active region by removing a polygon that was previously
+	 * used to define it.  See GeoTessPointMap::removeActiveRegion().
+	 * @param polygon a Polygon or Polygon3D object.
+	 */
+	void removeActiveRegion(GeoTessPolygon* polygon)
+	{
+		pointMap->removeActiveRegion(polygon);
+	}
+
 	/**
 	 * Retrieve the pointer to the Polygon or Polygon3D object
 	 * that supports this PointMap.  May be NULL.
@@ -81,6 +81,40 @@ class GEOTESS_EXP_IMP GeoTessModelUtils
 {
 private:
 
+	/**
+	 * Number of map rows (latitudes), or slice columns, that are handed to
+	 * a thread at one time by the map and slice utilities.
+	 */
+	static const int MAP_BAND = 4;
+
+	/**
+	 * The spatial coordinates that getSlice() can output with each sample.
+	 */
+	enum SliceCoordinate { SLICE_DISTANCE, SLICE_DEPTH, SLICE_RADIUS, SLICE_X,
+		SLICE_Y, SLICE_Z, SLICE_LAT, SLICE_LON, SLICE_UNKNOWN };
+
+	/**
+	 * Parse a comma delimited list of spatial coordinate names
+	 * (case-insensitive) into a list of SliceCoordinates.  Unrecognized names
+	 * become SLICE_UNKNOWN, which getSlice() outputs as NA_VALUE.
+	 * @return true if any of the coordinates are x, y or z.
+	 */
+	static bool parseSliceCoordinates(const string& spatialCoordinates,
+			vector<SliceCoordinate>& coordinates);
+
+	/**
+	 * Evaluate f(pos, i, j) at every node of an nlat x nlon map.  Bands of
+	 * MAP_BAND rows are distributed over GeoTessParallel threads, each of
+	 * which owns its own GeoTessPosition.  Within a band, rows are
+	 * traversed in alternating directions so that consecutive
+	 * positions are always adjacent, which keeps the triangle walk short.
+	 */
+	template <typename F>
+	static void forEachMapNode(GeoTessModel& model,
+			const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType,
+			const int& nlat, const int& nlon, F f);
+
 
 public:
 
@@ -167,6 +201,30 @@ public:
 			const GeoTessInterpolatorType& radialType, bool reciprocal, vector<int>& attributes,
 			vector<vector<vector<double> > >& values);
 
+	/**
+	 * Retrieve a map of attribute values at a constant specified depth on a
+	 * regular latitude-longitude grid.  Identical to the version that returns
+	 * a 3D vector, except that values are returned in a single contiguous
+	 * array where the value of attribute k at latitudes[i], longitudes[j]
+	 * is values[(i*nlon + j)*nAttributes + k], and the map is computed
+	 * concurrently using GeoTessParallel::getNThreads() threads.
+	 *
+	 * @param values [nlat*nlon*nAttributes] array of doubles, resized by this method.
+	 * @throws GeoTessException
+	 */
+	static void getMapValuesDepth(GeoTessModel& model,
+			vector<double>& latitudes, vector<double>& longitudes, int layerId, double depth,
+			const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType, bool reciprocal, vector<int>& attributes,
+			vector<double>& values);
+
+	/**
+	 * Retrieve attribute values interpolated on a vertical slice through a
+	 * model.  See the implementation for a full description of the
+	 * parameters.
+	 * @param transect [nx][nPoints][spatialCoordinates.length + nAttributes]
+	 * @throws GeoTessException
+	 */
 	static void getSlice(GeoTessModel& model, const double* const x0,
 			const double* const x1, int nx,
 			double maxRadialSpacing, int firstLayer,
@@ -176,6 +234,29 @@ public:
 			const vector<int>& attributes,
 			vector<vector<vector<double> > >& transect);
 
+	/**
+	 * Retrieve attribute values interpolated on a vertical slice through a
+	 * model.  Identical to the version that returns a 3D vector, except that
+	 * values are returned in a single contiguous array where value v of
+	 * point j in column i is transect[(i*nPoints + j)*nValues + v], and the
+	 * nx columns are computed concurrently using GeoTessParallel::getNThreads()
+	 * threads (call GeoTessParallel::setNThreads(1) to compute them serially).
+	 * @param transect [nx*nPoints*nValues] array of doubles, resized by
+	 * this method.
+	 * @param nPoints (output) the number of points in each column of the slice.
+	 * @param nValues (output) the number of values per point, which is the
+	 * number of spatialCoordinates plus the number of attributes.
+	 * @throws GeoTessException
+	 */
+	static void getSlice(GeoTessModel& model, const double* const x0,
+			const double* const x1, int nx,
+			double maxRadialSpacing, int firstLayer,
+			int lastLayer, const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType,
+			const string& spatialCoordinates, bool reciprocal,
+			const vector<int>& attributes,
+			vector<double>& transect, int& nPoints, int& nValues);
+
 	/**
 	 * Retrieve a map of attribute values at some fractional thickness with
 	 * a layer.  FractionalRadius <= 0. will result in samples at the bottom
@@ -203,6 +284,23 @@ public:
 			const GeoTessInterpolatorType& radialType, bool reciprocal, vector<int>& attributes,
 			vector<vector<vector<double> > >& values);
 
+	/**
+	 * Retrieve a map of attribute values at some fractional thickness with
+	 * a layer.  Identical to the version that returns a 3D vector, except that
+	 * values are returned in a single contiguous array where the value of
+	 * attribute k at latitudes[i], longitudes[j] is
+	 * values[(i*nlon + j)*nAttributes + k], and the map is computed
+	 * concurrently using GeoTessParallel::getNThreads() threads.
+	 *
+	 * @param values [nlat*nlon*nAttributes] array of doubles, resized by this method.
+	 * @throws GeoTessException
+	 */
+	static void getMapValuesLayer(GeoTessModel& model,
+			vector<double>& latitudes, vector<double>& longitudes, int layerId, double fractionalRadius,
+			const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType, bool reciprocal, vector<int>& attributes,
+			vector<double>& values);
+
 	/**
 	 * Retrieve a map of the depth or radius of the top or bottom of a
 	 * specified layer.
@@ -226,6 +324,22 @@ public:
 			const GeoTessInterpolatorType& radialType,
 			vector<vector<double> >& values);
 
+	/**
+	 * Retrieve a map of the depth or radius of the top or bottom of a
+	 * specified layer.  Identical to the version that returns a 2D vector,
+	 * except that the value at latitudes[i], longitudes[j] is returned in
+	 * values[i*nlon + j], and the map is computed concurrently using
+	 * GeoTessParallel::getNThreads() threads.
+	 *
+	 * @param values [nlat*nlon] array of doubles, resized by this method.
+	 * @throws GeoTessException
+	 */
+	static void getMapLayerBoundary(GeoTessModel& model,
+			vector<double>& latitudes, vector<double>& longitudes, int layerId,
+			bool top, bool convertToDepth, const GeoTessInterpolatorType& horizontalType,
+			const GeoTessInterpolatorType& radialType,
+			vector<double>& values);
+
 }; // end class GeoTessModelUtils
 
 } // end namespace geotess
@@ -0,0 +1,185 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#ifndef GEOTESS_PARALLEL_H
+#define GEOTESS_PARALLEL_H
+
+// **** _SYSTEM INCLUDES_ ******************************************************
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+// use standard library objects
+using namespace std;
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "CPPUtils.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _FORWARD REFERENCES_ ***************************************************
+
+// **** _CLASS DEFINITION_ *****************************************************
+
+/**
+ * \brief Minimal support for splitting loops over independent items
+ * across several threads.
+ *
+ * GeoTessParallel manages the number of threads that GeoTess uses for
+ * internal multi-threaded operations and provides a single loop construct,
+ * forEach(), that divides the range [0, n) into chunks that are processed
+ * concurrently.  Chunks are handed out dynamically so that the work is
+ * balanced even when some items are much more expensive than others.
+ * <p>If a chunk throws an exception, the remaining chunks are abandoned and
+ * the first exception is rethrown in the calling thread once all worker
+ * threads have finished.
+ * <p>Callers are responsible for ensuring that the function they supply
+ * only modifies state that is private to the items it is processing.
+ */
+class GEOTESS_EXP_IMP GeoTessParallel
+{
+private:
+
+	/**
+	 * Number of threads used by forEach().  Values <= 0 mean use
+	 * std::thread::hardware_concurrency().
+	 */
+	static int nThreads;
+
+	/**
+	 * Process chunks of [0, n) until there are none left.
+	 */
+	template <typename F>
+	static void work(F& f, const int& n, const int& chunk, const int& thread,
+			atomic<int>& next, exception_ptr& error, atomic<bool>& failed)
+	{
+		try
+		{
+			int first;
+			while (!failed && (first = next.fetch_add(chunk)) < n)
+				f(first, first + chunk < n ? first + chunk : n, thread);
+		}
+		catch (...)
+		{
+			if (!failed.exchange(true))
+				error = current_exception();
+		}
+	}
+
+public:
+
+	/**
+	 * Retrieve the number of threads that multi-threaded GeoTess
+	 * operations will use.  Defaults to the number of hardware threads
+	 * available on this machine.
+	 */
+	static int getNThreads();
+
+	/**
+	 * Specify the number of threads that multi-threaded GeoTess operations
+	 * should use.  Specify 1 to force single threaded execution.  Values
+	 * <= 0 restore the default, which is the number of hardware threads
+	 * available on this machine.
+	 */
+	static void setNThreads(int n) { nThreads = n; }
+
+	/**
+	 * Retrieve the number of threads that forEach(n, chunk, f) will use.
+	 * This is getNThreads() limited by the number of chunks.
+	 */
+	static int getNThreads(const int& n, const int& chunk)
+	{
+		int nt = getNThreads();
+		int nChunks = chunk < 1 ? n : (n + chunk - 1) / chunk;
+		return nt < nChunks ? nt : (nChunks < 1 ? 1 : nChunks);
+	}
+
+	/**
+	 * Call f(first, last, thread) on consecutive chunks of the range [0, n),
+	 * where each chunk covers at most chunk items.  Chunks are processed
+	 * concurrently by getNThreads(n, chunk) threads, one of which is the
+	 * calling thread.  thread is the index, in the range
+	 * [0, getNThreads(n, chunk)), of the thread that is processing the chunk,
+	 * which callers can use to select per-thread resources such as
+	 * GeoTessPosition objects.  Returns when all chunks have been processed.
+	 * @param n the number of items to process.
+	 * @param chunk the number of items handed to f at one time.  Should be
+	 * large enough to amortize the cost of scheduling a chunk.
+	 * @param f a function or function object callable as
+	 * f(int first, int last, int thread).
+	 */
+	template <typename F>
+	static void forEach(const int& n, int chunk, F f)
+	{
+		if (n <= 0) return;
+		if (chunk < 1) chunk = 1;
+
+		int nt = getNThreads(n, chunk);
+
+		if (nt <= 1)
+		{
+			f(0, n, 0);
+			return;
+		}
+
+		atomic<int> next(0);
+		atomic<bool> failed(false);
+		exception_ptr error;
+
+		vector<thread> threads;
+		threads.reserve(nt-1);
+		for (int i = 1; i < nt; ++i)
+			threads.push_back(thread(&GeoTessParallel::work<F>, ref(f), n, chunk, i,
+					ref(next), ref(error), ref(failed)));
+
+		work(f, n, chunk, 0, next, error, failed);
+
+		for (int i = 0; i < (int)threads.size(); ++i)
+			threads[i].join();
+
+		if (error)
+			rethrow_exception(error);
+	}
+
+};
+
+} // end namespace geotess
+
+#endif  // GEOTESS_PARALLEL_H
@@ -105,14 +105,105 @@ private:
 	 */
 	GeoTessMetaData& metaData ;
 
-	GeoTessPolygon* polygon;
+	/**
+	 * The Polygon and/or Polygon3D objects whose union defines the active
+	 * region.  Empty if the active region spans the entire model.
+	 */
+	vector<GeoTessPolygon*> polygons;
+
+	/**
+	 * When the active region is defined by polygons, coverage[i] is the
+	 * number of polygons that contain point i.  A point is removed from the
+	 * active region when its coverage drops to zero.
+	 */
+	vector<int> coverage;
+
+	/**
+	 * A flattened nPoints by 3 array of indexes. For each point in the 3D grid, pointMap stores
+	 * 3 consecutive indexes: the index of the 2D vertex, the layer index, and the node index
+	 * within the layer.  The indexes of point i are at pointMap[3*i], pointMap[3*i+1] and
+	 * pointMap[3*i+2].  There is an entry for each data object, not each radius.
+	 */
+	vector<int> pointMap;
+
+	/**
+	 * Incremented by pointMapChanged().  See getGeneration().
+	 */
+	int generation;
+
+	/**
+	 * Called whenever the points are added, removed or renumbered.
+	 */
+	void pointMapChanged()
+	{
+		++generation;
+	}
+
+	/**
+	 * Append a point to the end of pointMap and set the pointIndex of the
+	 * specified node of Profile p.
+	 */
+	void addPoint(GeoTessProfile* p, int vertex, int layer, int node)
+	{
+		p->setPointIndex(node, (int)(pointMap.size()/3));
+		pointMap.push_back(vertex);
+		pointMap.push_back(layer);
+		pointMap.push_back(node);
+	}
+
+	/**
+	 * Throw an exception if attributeIndex or the point range [firstPoint, lastPoint)
+	 * is invalid.  Called once per bulk operation.
+	 */
+	void checkPointRange(const string& method, int attributeIndex, int firstPoint, int lastPoint);
+
+	/**
+	 * Bulk copy of one attribute from the Data objects of the points in
+	 * [firstPoint, lastPoint) into values.  T is the element type of the
+	 * model's DataType.  Data objects whose concrete type is
+	 * GeoTessDataArray<T> or GeoTessDataValue<T> are read directly; any
+	 * other Data object is read through the virtual accessor.
+	 */
+	template <typename T>
+	void copyPointValues(int attributeIndex, double* values, int firstPoint, int lastPoint);
+
+	/**
+	 * Bulk copy of one attribute from values into the Data objects of the points
+	 * in [firstPoint, lastPoint).  T is the element type of the model's
+	 * DataType; Data objects of any other concrete type are written through
+	 * the virtual accessor.
+	 */
+	template <typename T>
+	void copyPointValues(int attributeIndex, const double* values, int firstPoint, int lastPoint);
+
+	/**
+	 * Number of vertices that are tested against a polygon at one time
+	 * when the test is split across multiple threads.
+	 */
+	static const int VERTEX_CHUNK = 1024;
+
+	/**
+	 * Determine which vertices of the grid are inside polygon.  Vertices are
+	 * tested concurrently and vertices outside the polygon's bounding cap
+	 * are classified without testing them individually.  On exit, inside[v]
+	 * is nonzero if vertex v is inside the polygon.  If polygon is a
+	 * Polygon3D, radii[2*v] and radii[2*v+1] are the radii of its bottom and
+	 * top horizons at every vertex v that is inside; otherwise radii is empty.
+	 * layerBottom and layerTop are the range of layers spanned by the polygon.
+	 */
+	void findVertices(GeoTessPolygon* polygon, vector<char>& inside, vector<double>& radii,
+			int& layerBottom, int& layerTop);
+
+	/**
+	 * Add the nodes contained in polygon to the active region.
+	 */
+	void addPolygon(GeoTessPolygon* polygon);
 
 	/**
-	 * A nPoints by 3 array of indexes. For each point in the 3D grid, pointMap stores 3 indexes:
-	 * the index of the 2D vertex, the layer index, and the node index within the layer. There is an
-	 * entry for each data object, not each radius.
+	 * Decrement the reference count of every polygon and delete the ones
+	 * that are no longer referenced.
 	 */
-	vector<vector<int> >  pointMap;
+	void releasePolygons();
 
 	bool populated;
 
@@ -153,8 +244,9 @@ public:
 	LONG_INT getMemory()
 	{
 		return (LONG_INT) sizeof(GeoTessPointMap)
-				+ (LONG_INT)(pointMap.capacity() * sizeof(vector<int>)
-				+ pointMap.size() * 3 * (LONG_INT)sizeof(int));
+				+ (LONG_INT)pointMap.capacity() * (LONG_INT)sizeof(int)
+				+ (LONG_INT)coverage.capacity() * (LONG_INT)sizeof(int)
+				+ (LONG_INT)polygons.capacity() * (LONG_INT)sizeof(GeoTessPolygon*);
 	}
 
 	/**
@@ -172,10 +264,41 @@ public:
 	 * within the polygon will be set to unique positive values.
 	 * All nodes outside the polygon will have pointIndex
 	 * values equal to -1.
+	 * <p>Vertices are tested against the polygon concurrently, using
+	 * GeoTessParallel::getNThreads() threads.
 	 * @param polygon a 2D Polygon object
 	 */
 	void setActiveRegion(GeoTessPolygon* polygon);
 
+	/**
+	 * Expand the active region to include all the nodes contained in the
+	 * specified Polygon or Polygon3D.  The active region becomes the union of
+	 * all the polygons that have been added.  Nodes that were already active
+	 * retain their pointIndex values; newly active nodes are assigned
+	 * pointIndex values starting at the current size().
+	 * <p>If the PointMap is not populated, or if its active region currently
+	 * spans the entire model, this is equivalent to setActiveRegion(polygon).
+	 * <p>Polygon implements reference counting.  This PointMap increments
+	 * the polygon's reference count.
+	 * @param polygon a 2D or 3D polygon.
+	 */
+	void addActiveRegion(GeoTessPolygon* polygon);
+
+	/**
+	 * Shrink the active region by removing a polygon that was previously
+	 * supplied to setActiveRegion(polygon) or addActiveRegion(polygon).
+	 * Nodes that are not contained in any of the remaining polygons become
+	 * inactive.  The remaining active nodes are renumbered so that pointIndex
+	 * values remain contiguous; their relative order is unchanged.
+	 * <p>If the last polygon is removed, the PointMap is cleared.
+	 * <p>The polygon's reference count is decremented and the polygon is
+	 * deleted if it is no longer referenced.
+	 * @param polygon the polygon to remove.
+	 * @throws GeoTessException if polygon does not define part of the
+	 * active region.
+	 */
+	void removeActiveRegion(GeoTessPolygon* polygon);
+
 	/**
 	 * Populate the PointMap such that nodes located within the
 	 * specified Polygon are active and all others are inactive.
@@ -193,12 +316,19 @@ public:
 
 	/**
 	 * Retrieve the pointer to the Polygon or Polygon3D object
-	 * that supports this PointMap.  May be NULL.
+	 * that supports this PointMap.  May be NULL.  If the active region
+	 * is the union of several polygons, the first one is returned.
 	 * <p>Polygon implements referenceCounting so if you wish
 	 * to retain a copy of this polygon, be sure to
 	 * addReference() and delete it when you are done with it.
 	 */
-	GeoTessPolygon* getPolygon() { return polygon; }
+	GeoTessPolygon* getPolygon() { return polygons.empty() ? NULL : polygons[0]; }
+
+	/**
+	 * Retrieve the Polygon and/or Polygon3D objects whose union defines
+	 * the active region.  Empty if the active region spans the entire model.
+	 */
+	const vector<GeoTessPolygon*>& getPolygons() { return polygons; }
 
 	/**
 	 * Clears all the information in this pointMap and the
@@ -222,7 +352,7 @@ public:
 	 */
 	int size()
 	{
-		return pointMap.size();
+		return (int)(pointMap.size()/3);
 	}
 
 	/**
@@ -235,7 +365,7 @@ public:
 	 */
 	int getVertexIndex(int pointIndex)
 	{
-		return pointMap[pointIndex][0];
+		return pointMap[3*pointIndex];
 	}
 
 	/**
@@ -248,7 +378,7 @@ public:
 	 */
 	int getTessId(int pointIndex)
 	{
-		return metaData.getTessellation(pointMap[pointIndex][1]);
+		return metaData.getTessellation(pointMap[3*pointIndex+1]);
 	}
 
 	/**
@@ -261,7 +391,7 @@ public:
 	 */
 	int getLayerIndex(int pointIndex)
 	{
-		return pointMap[pointIndex][1];
+		return pointMap[3*pointIndex+1];
 	}
 
 	/**
@@ -274,22 +404,49 @@ public:
 	 */
 	int getNodeIndex(int pointIndex)
 	{
-		return pointMap[pointIndex][2];
+		return pointMap[3*pointIndex+2];
+	}
+
+	/**
+	 * Retrieve a copy of the index map for the specified pointIndex. This
+	 * is a 3-element array consisting of 0:vertexIndex, 1:layerIndex,
+	 * 2:nodeIndex.
+	 *
+	 * <p>Deprecated because it builds a new vector on every call.  Use
+	 * getPointIndicesFlat() instead.
+	 *
+	 * @param pointIndex
+	 * @return the index map for the specified pointIndex.
+	 */
+	vector<int> getPointIndices(int pointIndex)
+	{
+		const int* p = &pointMap[3*pointIndex];
+		return vector<int>(p, p+3);
 	}
 
 	/**
-	 * Retrieve a reference to the index map for the specified pointIndex. This
+	 * Retrieve a pointer to the index map for the specified pointIndex. This
 	 * is a 3-element array consisting of 0:vertexIndex, 1:layerIndex,
 	 * 2:nodeIndex.
 	 *
+	 * <p>Caller should not delete this array.  It is invalidated by the next
+	 * call to setActiveRegion() or clear().
+	 *
 	 * @param pointIndex
 	 * @return the index map for the specified pointIndex.
 	 */
-	const vector<int>& getPointIndices(int pointIndex)
+	const int* getPointIndicesFlat(int pointIndex)
 	{
-		return pointMap[pointIndex];
+		return &pointMap[3*pointIndex];
 	}
 
+	/**
+	 * Retrieve a number that changes every time points are added, removed
+	 * or renumbered, e.g., by setActiveRegion().  Anything that caches point
+	 * indexes can compare it with the value at the time they were cached.
+	 */
+	int getGeneration() const { return generation; }
+
 	/**
 	 * Retrieve the pointIndex of the point that corresponds to the specified
 	 * vertex, layer and node.
@@ -340,7 +497,7 @@ public:
 	 */
 	void setPointData(int pointIndex, GeoTessData* data)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		profiles[map[0]][map[1]]->setData(map[2], data);
 	}
 
@@ -351,7 +508,7 @@ public:
 	 */
 	GeoTessData* getPointData(int pointIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2]);
 	}
 
@@ -366,7 +523,7 @@ public:
 	template <typename T>
 	void setPointValue(int pointIndex, int attributeIndex, T value)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		profiles[map[0]][map[1]]->getData(map[2])->setValue(attributeIndex,
 				value);
 	}
@@ -380,7 +537,7 @@ public:
 	 */
 	double getPointValue(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getValue(attributeIndex, map[2]);
 	}
 
@@ -395,7 +552,7 @@ public:
 	 */
 	double getPointValueDouble(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getDouble(attributeIndex);
 	}
 
@@ -410,7 +567,7 @@ public:
 	 */
 	float getPointValueFloat(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getFloat(attributeIndex);
 	}
 
@@ -425,7 +582,7 @@ public:
 	 */
 	LONG_INT getPointValueLong(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getLong(attributeIndex);
 	}
 
@@ -440,7 +597,7 @@ public:
 	 */
 	int getPointValueInt(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getInt(attributeIndex);
 	}
 
@@ -455,7 +612,7 @@ public:
 	 */
 	short getPointValueShort(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getShort(attributeIndex);
 	}
 
@@ -470,10 +627,57 @@ public:
 	 */
 	byte getPointValueByte(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getData(map[2])->getByte(attributeIndex);
 	}
 
+	/**
+	 * Retrieve the value of the specified attribute at every point in the
+	 * model, cast to double if necessary.  Equivalent to calling
+	 * getPointValueDouble(i, attributeIndex) for every pointIndex i but
+	 * points are visited in storage order, the data type is resolved once
+	 * rather than per point, and there is no virtual call on the Data objects.
+	 * @param attributeIndex
+	 * @param values (output) array of length size() that will be populated
+	 * with the value of the specified attribute at every point.
+	 */
+	void getPointValues(int attributeIndex, double* values)
+	{ getPointValues(attributeIndex, values, 0, size()); }
+
+	/**
+	 * Retrieve the value of the specified attribute at points firstPoint
+	 * (inclusive) through lastPoint (exclusive), cast to double if necessary.
+	 * @param attributeIndex
+	 * @param values (output) array of length lastPoint-firstPoint.  values[0]
+	 * receives the value at point firstPoint.
+	 * @param firstPoint the index of the first point
+	 * @param lastPoint one more than the index of the last point
+	 */
+	void getPointValues(int attributeIndex, double* values, int firstPoint, int lastPoint);
+
+	/**
+	 * Set the value of the specified attribute at every point in the model.
+	 * Values are cast to the DataType of the model.  Equivalent to calling
+	 * setPointValue(i, attributeIndex, values[i]) for every pointIndex i but
+	 * points are visited in storage order and the data type is resolved once.
+	 * @param attributeIndex
+	 * @param values array of length size() containing the new values.
+	 */
+	void setPointValues(int attributeIndex, const double* values)
+	{ setPointValues(attributeIndex, values, 0, size()); }
+
+	/**
+	 * Set the value of the specified attribute at points firstPoint
+	 * (inclusive) through lastPoint (exclusive).  Values are cast to the
+	 * DataType of the model.
+	 * @param attributeIndex
+	 * @param values array of length lastPoint-firstPoint.  values[0] is
+	 * assigned to point firstPoint.
+	 * @param firstPoint the index of the first point
+	 * @param lastPoint one more than the index of the last point
+	 */
+	void setPointValues(int attributeIndex, const double* values, int firstPoint, int lastPoint);
+
 	/**
 	 * Return true if the value of the specified attribute at the specified
 	 * point is NaN.
@@ -485,7 +689,7 @@ public:
 	 */
 	bool isNaN(int pointIndex, int attributeIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->isNaN(map[2], attributeIndex);
 	}
 
@@ -499,7 +703,7 @@ public:
 	 */
 	void getPointVector(int pointIndex, double* v)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		const double* vv = grid.getVertex(map[0]);
 		double r = profiles[map[0]][map[1]]->getRadius(map[2]);
 		v[0] = vv[0] * r;
@@ -515,7 +719,7 @@ public:
 	 */
 	const double* getPointUnitVector(int pointIndex) const
 	{
-		return grid.getVertex(pointMap[pointIndex][0]);
+		return grid.getVertex(pointMap[3*pointIndex]);
 	}
 
 	/**
@@ -526,7 +730,7 @@ public:
 	 */
 	double getPointRadius(int pointIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return profiles[map[0]][map[1]]->getRadius(map[2]);
 	}
 
@@ -538,9 +742,9 @@ public:
 	 */
 	double getPointDepth(int pointIndex)
 	{
-		vector<int>& map = pointMap[pointIndex];
+		const int* map = &pointMap[3*pointIndex];
 		return GeoTessUtils::getEarthRadius(
-				grid.getVertex(pointMap[pointIndex][0]))
+				grid.getVertex(map[0]))
 				- profiles[map[0]][map[1]]->getRadius(map[2]);
 	}
 
@@ -553,8 +757,8 @@ public:
 	 */
 	double getDistance3D(int pointIndex1, int pointIndex2)
 	{
-		vector<int>& m1 = pointMap[pointIndex1];
-		vector<int>& m2 = pointMap[pointIndex2];
+		const int* m1 = &pointMap[3*pointIndex1];
+		const int* m2 = &pointMap[3*pointIndex2];
 		return GeoTessUtils::getDistance3D(grid.getVertex(m1[0]),
 				profiles[m1[0]][m1[1]]->getRadius(m1[2]), grid.getVertex(m2[0]),
 				profiles[m2[0]][m2[1]]->getRadius(m2[2]));
@@ -566,7 +770,7 @@ public:
 //	template<typename T>
 //	void appendData(int pointIndex, T* newValues, int n)
 //	{
-//		vector<int>& map = pointMap[pointIndex];
+//		const int* map = &pointMap[3*pointIndex];
 //		profiles[map[0]][map[1]]->appendData<T>(map[2], newValues, n);
 //	}
 
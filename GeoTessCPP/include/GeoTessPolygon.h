@@ -51,6 +51,7 @@ using namespace std;
 #include "CPPUtils.h"
 #include "GeoTessUtils.h"
 #include "GeoTessGreatCircle.h"
+#include "GeoTessPolygonIndex.h"
 #include "IFStreamAscii.h"
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
@@ -143,6 +144,29 @@ protected:
 	 */
 	 bool lonFirst;
 
+	/**
+	 * Unit vector at the center of a spherical cap that encloses every
+	 * edge of this polygon.  See getBoundingCap().
+	 */
+	double capCenter[3];
+
+	/**
+	 * Angular radius of the bounding cap, in radians.  Equal to PI if
+	 * the polygon has no useful bounding cap.
+	 */
+	double capRadius;
+
+	/**
+	 * Compute capCenter and capRadius from the edges of this polygon.
+	 */
+	void computeBoundingCap();
+
+	/**
+	 * Optional spatial index that accelerates contains().  Empty unless
+	 * buildIndex() has been called.
+	 */
+	GeoTessPolygonIndex index;
+
 	/**
 	 * @param points a list of unit vectors
 	 */
@@ -301,6 +325,7 @@ protected:
 	void invert()
 	{
 		referenceIn = !referenceIn;
+		index.invert();
 	}
 
 	/**
@@ -314,9 +339,12 @@ protected:
 	 * inside or outside the polygon
 	 * @param inside true if the supplied reference point is known to be
 	 * inside the polygon, false if known to be outside.
+	 * <p>Discards the spatial index, if there is one.
 	 */
 	void setReferencePoint(const double* refPoint, const bool &inside)
 	{
+		index.clear();
+
 		if (referencePoint == NULL)
 			referencePoint = new double[3];
 
@@ -334,6 +362,7 @@ protected:
 	 * @param lon longitude of reference point in degrees
 	 * @param inside true if the supplied reference point is known to be
 	 * inside the polygon, false if known to be outside.
+	 * <p>Discards the spatial index, if there is one.
 	 */
 	void setReferencePoint(double lat, double lon, bool inside)
 	{
@@ -342,6 +371,65 @@ protected:
 		setReferencePoint(r, inside);
 	}
 
+	/**
+	 * Retrieve a spherical cap that encloses the entire boundary of this
+	 * polygon, including the tolerance within which points are deemed to
+	 * be on the boundary.  All points outside the cap are on the same side
+	 * of the polygon boundary; containsExterior() reports which side that is.
+	 * <p>The cap is computed when the polygon is constructed.  Its radius
+	 * is PI if the polygon is global or if the polygon boundary spans so much
+	 * of the sphere that the cap would be of no use.
+	 * @param center 3-element array that will be populated with the unit
+	 * vector of the center of the cap.
+	 * @return the angular radius of the cap, in radians.
+	 */
+	double getBoundingCap(double* center)
+	{
+		center[0] = capCenter[0];
+		center[1] = capCenter[1];
+		center[2] = capCenter[2];
+		return global ? PI : capRadius;
+	}
+
+	/**
+	 * Returns true if the points outside the bounding cap are inside
+	 * the polygon.  Only meaningful if getBoundingCap() returns a radius
+	 * less than PI.
+	 */
+	bool containsExterior();
+
+	/**
+	 * Build a spatial index that accelerates contains().  The sphere is
+	 * partitioned into cells, each of which is classified as inside, outside
+	 * or on the boundary of the polygon.  Points that fall in inside or
+	 * outside cells are classified in constant time.  Points in boundary
+	 * cells are tested against only the few edges that pass near the cell.
+	 * <p>Worthwhile when many points are to be tested against a polygon with
+	 * many edges.  contains() returns the same results with or without the
+	 * index.  Polygons that are global are not indexed.
+	 * <p>The index is not modified by contains(), so an indexed polygon can
+	 * be shared by multiple threads.
+	 * @param depth maximum number of times each face of the cube map used to
+	 * partition the sphere is subdivided.  Boundary cells at depth d span
+	 * about 90/2^d degrees.  Must be in the range [0, 14].
+	 */
+	void buildIndex(int depth = 8);
+
+	/**
+	 * Discard the spatial index built by buildIndex().
+	 */
+	void clearIndex() { index.clear(); }
+
+	/**
+	 * Returns true if buildIndex() has been called.
+	 */
+	bool isIndexed() { return !index.empty(); }
+
+	/**
+	 * Retrieve the spatial index built by buildIndex().
+	 */
+	const GeoTessPolygonIndex& getIndex() { return index; }
+
 	/**
 	 * Returns true if this Polygon contains any of the supplied unit vectors
 	 *
@@ -383,6 +471,13 @@ protected:
 		if (global || GeoTessUtils::dot(referencePoint, x) > cos(TOLERANCE))
 			return referenceIn;
 
+		if (!index.empty())
+		{
+			int in = index.classify(edges, x);
+			if (in >= 0)
+				return in == 1;
+		}
+
 		GeoTessGreatCircle gcRef(referencePoint, x);
 
 		return onBoundary(gcRef) || ((edgeCrossings(gcRef) % 2 == 0) == referenceIn);
@@ -0,0 +1,246 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#ifndef POLYGONINDEX_H_
+#define POLYGONINDEX_H_
+
+// **** _SYSTEM INCLUDES_ ******************************************************
+
+#include <vector>
+
+// use standard library objects
+using namespace std;
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "CPPUtils.h"
+#include "GeoTessUtils.h"
+#include "GeoTessGreatCircle.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _FORWARD REFERENCES_ ***************************************************
+
+class GeoTessPolygon;
+
+// **** _CLASS DEFINITION_ *****************************************************
+
+/**
+ * \brief Spatial index that accelerates GeoTessPolygon::contains().
+ *
+ * The sphere is partitioned into the 6 faces of a cube map and each face
+ * is recursively subdivided into 4 cells, forming a quadtree.  Subdivision
+ * stops when no polygon edge comes near a cell, in which case the entire
+ * cell is known to be either inside or outside the polygon, or when the
+ * maximum depth is reached, in which case the cell is a boundary cell that
+ * stores the short list of edges that pass near it.
+ * <p>Every cell also stores a reference point whose status, inside or
+ * outside the polygon, is known.  A point that falls in a boundary cell is
+ * classified by counting the crossings of the great circle arc from the
+ * cell's reference point to the point with the cell's edges only.
+ * <p>Configurations that cannot be resolved robustly, e.g., a point within
+ * a tolerance of an edge, are reported as undetermined and left to the
+ * exhaustive algorithm in GeoTessPolygon.
+ * <p>A GeoTessPolygonIndex is not modified by classify() so it can be
+ * shared by multiple threads.
+ */
+class GEOTESS_EXP_IMP GeoTessPolygonIndex
+{
+private:
+
+	/**
+	 * The number of times the faces of the cube map are subdivided.
+	 */
+	int depth;
+
+	/**
+	 * For each cell, the index of the first of its 4 children, or -1
+	 * if the cell is a leaf.
+	 */
+	vector<int> child;
+
+	/**
+	 * For each cell, 1 if the reference point of the cell is inside
+	 * the polygon, 0 if it is outside and -1 if unknown.
+	 */
+	vector<signed char> status;
+
+	/**
+	 * For each cell, the unit vector of the reference point (3 values per cell).
+	 */
+	vector<double> reference;
+
+	/**
+	 * For each leaf cell, the index in edgeList of the first edge that passes
+	 * near the cell, and the number of such edges.  Cells with no nearby
+	 * edges are entirely inside or entirely outside the polygon.
+	 */
+	vector<int> edgeFirst, edgeCount;
+
+	/**
+	 * Indexes of polygon edges, grouped by leaf cell.
+	 */
+	vector<int> edgeList;
+
+	/**
+	 * Map unit vector x to face f of the cube map and to tangent plane
+	 * coordinates u, v in the range [-1, 1].
+	 */
+	static void toFace(const double* x, int& f, double& u, double& v);
+
+	/**
+	 * Map tangent plane coordinates u, v on face f of the cube map to a unit vector.
+	 */
+	static void fromFace(const int& f, const double& u, const double& v, double* x);
+
+	/**
+	 * Returns true if the great circle arc edge passes within angular
+	 * distance radius of unit vector x.
+	 */
+	static bool near(GeoTessGreatCircle* edge, const double* x, const double& radius);
+
+	/**
+	 * Returns true if x is within tolerance of the boundary formed by the
+	 * specified edges.
+	 */
+	static bool nearBoundary(const vector<GeoTessGreatCircle*>& edges,
+			const int* list, const int& n, const double* x);
+
+	/**
+	 * Classify x given a reference point with known status and the list of
+	 * edges that might cross the arc from the reference point to x.  Returns
+	 * 1 if x is inside, 0 if outside, -1 if undetermined.
+	 */
+	static int classify(const vector<GeoTessGreatCircle*>& edges,
+			const int* list, const int& n, const double* ref, const int& refStatus,
+			const double* x);
+
+	/**
+	 * Add cell node, which covers the tangent plane coordinates of face f
+	 * spanned by cell (i, j) at the specified level, and recursively
+	 * subdivide it.
+	 */
+	void buildCell(GeoTessPolygon& polygon, const vector<GeoTessGreatCircle*>& edges,
+			const int& node, const int& f, const int& level, const int& i, const int& j,
+			const vector<int>& parentEdges, const double* parentRef, const int& parentStatus);
+
+public:
+
+	/**
+	 * Default constructor.  The index is empty.
+	 */
+	GeoTessPolygonIndex() : depth(0) {}
+
+	/**
+	 * Build the index for the specified polygon, discarding any previous
+	 * contents.
+	 * @param polygon the polygon.  Must not be global.  Its contains() method
+	 * is called to establish the status of a few reference points, so the
+	 * polygon should not already own an index.
+	 * @param edges the edges of the polygon.
+	 * @param depth the maximum number of times that each face of the cube
+	 * map is subdivided.  Boundary cells at depth d span about 90/2^d degrees.
+	 */
+	void build(GeoTessPolygon& polygon, const vector<GeoTessGreatCircle*>& edges,
+			const int& depth);
+
+	/**
+	 * Determine whether x is inside the polygon.
+	 * @param edges the edges of the polygon that was indexed.
+	 * @param x unit vector of the point to evaluate.
+	 * @return 1 if x is inside, 0 if it is outside, -1 if the index
+	 * cannot robustly classify x.
+	 */
+	int classify(const vector<GeoTessGreatCircle*>& edges, const double* x) const;
+
+	/**
+	 * Reverse the status of every cell.  Called when the polygon is inverted.
+	 */
+	void invert()
+	{
+		for (int i = 0; i < (int)status.size(); ++i)
+			if (status[i] >= 0)
+				status[i] = 1 - status[i];
+	}
+
+	/**
+	 * Discard the contents of the index.
+	 */
+	void clear()
+	{
+		depth = 0;
+		child.clear();
+		status.clear();
+		reference.clear();
+		edgeFirst.clear();
+		edgeCount.clear();
+		edgeList.clear();
+	}
+
+	/**
+	 * Returns true if the index has not been built.
+	 */
+	bool empty() const { return child.empty(); }
+
+	/**
+	 * Retrieve the maximum depth of the quadtree.
+	 */
+	int getDepth() const { return depth; }
+
+	/**
+	 * Retrieve the number of cells in the quadtree, including the 6 faces
+	 * of the cube map.
+	 */
+	int getNCells() const { return (int)child.size(); }
+
+	/**
+	 * Retrieve the amount of memory used by the index, in bytes.
+	 */
+	LONG_INT getMemory() const
+	{
+		return (LONG_INT)sizeof(GeoTessPolygonIndex)
+				+ (LONG_INT)child.capacity()*sizeof(int)
+				+ (LONG_INT)status.capacity()*sizeof(signed char)
+				+ (LONG_INT)reference.capacity()*sizeof(double)
+				+ (LONG_INT)(edgeFirst.capacity()+edgeCount.capacity()+edgeList.capacity())*sizeof(int);
+	}
+
+}; // end class GeoTessPolygonIndex
+
+} // end namespace geotess
+
+#endif /* POLYGONINDEX_H_ */
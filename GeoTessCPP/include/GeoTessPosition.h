@@ -67,6 +67,97 @@ namespace geotess {
 class GeoTessInterpolatorType;
 class GeoTessProfile;
 
+// **** _PERFORMANCE COUNTERS_ *************************************************
+
+/**
+ * GeoTessPosition objects only accumulate performance counters when GeoTess
+ * is compiled with GEOTESS_POSITION_COUNTERS defined, e.g., by adding
+ * -DGEOTESS_POSITION_COUNTERS to CCFLAGS in Makefile_common.  Otherwise
+ * GEOTESS_POSITION_COUNT(statement) expands to nothing.
+ */
+#ifdef GEOTESS_POSITION_COUNTERS
+#define GEOTESS_POSITION_COUNT(statement) statement
+#else
+#define GEOTESS_POSITION_COUNT(statement)
+#endif
+
+/**
+ * \brief Performance counters accumulated by a GeoTessPosition object.
+ *
+ * All counts are zero unless GeoTess was compiled with
+ * GEOTESS_POSITION_COUNTERS defined.
+ */
+struct GEOTESS_EXP_IMP GeoTessPositionCounters
+{
+	/**
+	 * Number of triangles visited by the walking triangle algorithm.
+	 */
+	long long walkSteps;
+
+	/**
+	 * Number of times the walking triangle algorithm started from the first
+	 * triangle of a tessellation instead of the previous triangle.
+	 */
+	long long walkRestarts;
+
+	/**
+	 * Number of times the position was set to the same geographic location
+	 * it already occupied, so that no triangle walk was required.
+	 */
+	long long cacheHits;
+
+	/**
+	 * Number of times radial interpolation coefficients were recomputed.
+	 */
+	long long radialUpdates;
+
+	/**
+	 * Number of times horizontal interpolation coefficients were recomputed
+	 * (calls to update2D()) and the total time, in nsec, spent doing so.
+	 */
+	long long update2DCalls, update2DTime;
+
+	/**
+	 * Number of natural neighbor perimeters computed, and the total and
+	 * maximum number of edges in those perimeters.
+	 */
+	long long nnPerimeters, nnPerimeterEdges, nnPerimeterMax;
+
+	GeoTessPositionCounters() { reset(); }
+
+	/**
+	 * Set all counters to zero.
+	 */
+	void reset()
+	{
+		walkSteps = walkRestarts = cacheHits = radialUpdates = 0;
+		update2DCalls = update2DTime = 0;
+		nnPerimeters = nnPerimeterEdges = nnPerimeterMax = 0;
+	}
+
+	/**
+	 * Add the counts in other to this.
+	 */
+	void add(const GeoTessPositionCounters& other)
+	{
+		walkSteps += other.walkSteps;
+		walkRestarts += other.walkRestarts;
+		cacheHits += other.cacheHits;
+		radialUpdates += other.radialUpdates;
+		update2DCalls += other.update2DCalls;
+		update2DTime += other.update2DTime;
+		nnPerimeters += other.nnPerimeters;
+		nnPerimeterEdges += other.nnPerimeterEdges;
+		if (other.nnPerimeterMax > nnPerimeterMax)
+			nnPerimeterMax = other.nnPerimeterMax;
+	}
+
+	/**
+	 * Return a one-line summary of the counters.
+	 */
+	string toString() const;
+};
+
 // **** _CLASS DEFINITION_ *****************************************************
 
 /**
@@ -168,6 +259,7 @@ private:
 	{
 		if (triangle[tid] < 0)
 		{
+			GEOTESS_POSITION_COUNT(++counters.walkRestarts);
 			tessLevels[tid] = 0;
 			triangle[tid] = grid.getTriangle(tid, 0, 0);
 			getContainingTriangle(tid);
@@ -222,6 +314,7 @@ private:
 		// do nothing.
 		if (radialIndexes[0].size() == 0)
 		{
+			GEOTESS_POSITION_COUNT(++counters.radialUpdates);
 			vector<int>& v = vertices[tessid];
 			double r = radius;
 			double depth = depthSpecified ? getDepth() : NaN_DOUBLE;
@@ -285,6 +378,12 @@ protected:
 
 	/// @cond PROTECTED  Turn off doxygen documentation until 'endcond' is found
 
+	/**
+	 * Performance counters.  Only updated if compiled with
+	 * GEOTESS_POSITION_COUNTERS defined.
+	 */
+	GeoTessPositionCounters				counters;
+
 	/**
 	 * Radius of current position, in km.
 	 */
@@ -1129,6 +1228,26 @@ public:
 		return errorValue;
 	}
 
+	/**
+	 * Retrieve the performance counters accumulated by this position since
+	 * it was constructed or resetCounters() was last called.  The counters
+	 * are all zero unless GeoTess was compiled with GEOTESS_POSITION_COUNTERS
+	 * defined.
+	 * @return the performance counters.
+	 */
+	const GeoTessPositionCounters&	getCounters() const { return counters; }
+
+	/**
+	 * Set all performance counters to zero.
+	 */
+	void									resetCounters() { counters.reset(); }
+
+	/**
+	 * Return true if GeoTess was compiled with GEOTESS_POSITION_COUNTERS
+	 * defined, i.e., if getCounters() returns meaningful values.
+	 */
+	static bool						isCountersEnabled();
+
 	/**
 	 * If any calculated value is NaN, then functions like getValue() or
 	 * getRadiusTop() or getRadiusBottom() will return this value. The default
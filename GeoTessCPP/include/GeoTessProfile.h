@@ -42,6 +42,7 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <atomic>
 #include <map>
 
 // use standard library objects
@@ -98,9 +99,10 @@ class GEOTESS_EXP_IMP GeoTessProfile
 private:
 
 	/**
-	 * The static class instance count.
+	 * The static class instance count.  Atomic so that instances
+	 * can be constructed concurrently, e.g., by GeoTessCompression.
 	 */
-	static int						aClassCount;
+	static atomic<int>					aClassCount;
 
 public:
 
@@ -459,6 +461,15 @@ public:
 	 */
 	virtual GeoTessData*				getDataBottom() = ABSTRACT;
 
+	/**
+	 * Compute and cache any information that is computed lazily the first
+	 * time values are interpolated with the specified radial interpolator,
+	 * so that subsequent calls to getValue() do not modify this profile and
+	 * may be made concurrently from multiple threads.  Only ProfileNPoint
+	 * caches anything (cubic spline second derivatives).
+	 */
+	virtual void				prepareInterpolation(const GeoTessInterpolatorType& /*radialType*/) const {}
+
 	/**
 	 * Return the thickness of the layer in km.
 	 */
@@ -587,6 +598,12 @@ public:
 	 */
 	static GeoTessProfile*				newProfile(IFStreamAscii& ifs, GeoTessMetaData& gtmd);
 
+	/**
+	 * Static method to skip over the next Profile in an ascii stream without
+	 * instantiating it.
+	 */
+	static void										skipProfile(IFStreamAscii& ifs, GeoTessMetaData& gtmd);
+
 	/**
 	 * Write the radii and data values to binary file.
 	 */
@@ -0,0 +1,397 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#ifndef PROFILELAZY_OBJECT_H
+#define PROFILELAZY_OBJECT_H
+
+// **** _SYSTEM INCLUDES_ ******************************************************
+
+#include <iostream>
+#include <string>
+#include <atomic>
+
+// use standard library objects
+using namespace std;
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "GeoTessProfile.h"
+#include "GeoTessProfileType.h"
+#include "GeoTessInterpolatorType.h"
+#include "IFStreamBinary.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _FORWARD REFERENCES_ ***************************************************
+
+class GeoTessMetaData;
+
+// **** _CLASS DEFINITION_ *****************************************************
+
+/**
+ * \brief A Profile whose radii and data are decoded from the model file the
+ * first time they are needed.
+ *
+ * When GeoTessMetaData::isLazyLoading() is true, GeoTessModel copies the
+ * binary encoding of each EMPTY, THIN, CONSTANT and NPOINT profile into a
+ * single in-memory store while the file is loaded, and places one of these
+ * objects in the profile array in place of the decoded profile.  Profile type,
+ * number of radii and data, the radii at the top and bottom of the layer and
+ * the point indices are answered without decoding.  Any other request decodes
+ * the real profile from the store, after which every call is forwarded to it.
+ * Decoding is thread safe: if two threads touch the same profile
+ * concurrently, one of them discards its copy.
+ */
+class GEOTESS_EXP_IMP GeoTessProfileLazy : virtual public GeoTessProfile
+{
+private:
+
+	/**
+	 * The store that holds the binary encoding of this profile.  Owned by
+	 * the model.
+	 */
+	IFStreamBinary*						source;
+
+	/**
+	 * Position in source of the first byte (the profile type) of this profile.
+	 */
+	int												position;
+
+	/**
+	 * Number of bytes in the encoding of this profile.
+	 */
+	int												length;
+
+	/**
+	 * The model metadata, which supplies the DataType and attribute filter.
+	 */
+	GeoTessMetaData*					metaData;
+
+	/**
+	 * Profile type of the encoded profile.
+	 */
+	const GeoTessProfileType*	type;
+
+	int												nRadii;
+
+	int												nData;
+
+	float											radiusBottom;
+
+	float											radiusTop;
+
+	/**
+	 * Point indices assigned before the profile is decoded.
+	 * NULL until the first valid index is assigned.
+	 */
+	int*											pointIndices;
+
+	/**
+	 * True if prepareInterpolation(CUBIC_SPLINE) was called before the
+	 * profile was decoded.
+	 */
+	mutable atomic<bool>			cubic;
+
+	/**
+	 * The decoded profile, or NULL if it has not been decoded yet.
+	 */
+	mutable atomic<GeoTessProfile*>	profile;
+
+	/**
+	 * Decode the profile from source.
+	 */
+	GeoTessProfile*						decode() const;
+
+	/**
+	 * Return the decoded profile, decoding it first if necessary.
+	 */
+	GeoTessProfile*						get() const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		return p != NULL ? p : decode();
+	}
+
+	GeoTessProfileLazy(IFStreamBinary* src, int pos, int len, GeoTessMetaData* md,
+			const GeoTessProfileType& typ, int nr, int nd, float rbot, float rtop)
+	: GeoTessProfile(), source(src), position(pos), length(len), metaData(md), type(&typ),
+	  nRadii(nr), nData(nd), radiusBottom(rbot), radiusTop(rtop),
+	  pointIndices(NULL), cubic(false), profile(NULL) {};
+
+	/**
+	 * Copy constructor and assignment are not supported.
+	 */
+	GeoTessProfileLazy(const GeoTessProfileLazy& other);
+	GeoTessProfileLazy& operator=(const GeoTessProfileLazy& other);
+
+public:
+
+	/**
+	 * Static factory method that reads the next profile from input.  EMPTY,
+	 * THIN, CONSTANT and NPOINT profiles are copied, still encoded, to the end
+	 * of store and a GeoTessProfileLazy that references them is returned.
+	 * SURFACE and SURFACE_EMPTY profiles are small and are decoded immediately.
+	 * @param input the binary model file, positioned at the start of a profile.
+	 * @param metaData the model metadata.
+	 * @param store the stream that receives the encoded profile.  It must
+	 * have the same byte order as input and must outlive the returned profile.
+	 */
+	static GeoTessProfile*		newProfile(IFStreamBinary& input, GeoTessMetaData& metaData,
+			IFStreamBinary& store);
+
+	/**
+	 * If the profile has not been decoded yet, append its encoding to store
+	 * and decode it from there from now on.  Used to compact the store when
+	 * the profiles that reference it are discarded.
+	 */
+	void											moveTo(IFStreamBinary& store);
+
+	/**
+	 * Destructor.
+	 */
+	virtual										~GeoTessProfileLazy();
+
+	/**
+	 * Returns the class name.
+	 */
+	static  string						class_name() { return "ProfileLazy"; };
+
+	/**
+	 * Returns the class size.
+	 */
+	virtual int								class_size() const { return (int) sizeof(GeoTessProfileLazy); };
+
+	/**
+	 * Return true if the profile has been decoded.
+	 */
+	bool											isLoaded() const { return profile.load(memory_order_acquire) != NULL; }
+
+	/**
+	 * Return the decoded profile, decoding it first if necessary, and
+	 * relinquish ownership of it.  The caller assumes ownership of the
+	 * returned profile and should delete this object.
+	 */
+	GeoTessProfile*						release()
+	{
+		GeoTessProfile* p = get();
+		profile = NULL;
+		return p;
+	}
+
+	virtual LONG_INT					getMemory()
+	{
+		LONG_INT sz = (LONG_INT) sizeof(GeoTessProfileLazy);
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL)
+			sz += p->getMemory();
+		else if (pointIndices != NULL)
+			sz += nData * (LONG_INT) sizeof(int);
+		return sz;
+	}
+
+	virtual	const GeoTessProfileType&	getType() const { return *type; }
+
+	virtual bool							operator == (const GeoTessProfile& p) const
+	{ return *get() == p; }
+
+	virtual double						getValue(const GeoTessInterpolatorType& rInterpType,
+			int attributeIndex, double radius, bool allowRadiusOutOfRange) const
+	{ return get()->getValue(rInterpType, attributeIndex, radius, allowRadiusOutOfRange); }
+
+	virtual double						getValue(int attributeIndex, int nodeIndex) const
+	{ return get()->getValue(attributeIndex, nodeIndex); }
+
+	virtual bool							isNaN(int nodeIndex, int attributeIndex)
+	{ return get()->isNaN(nodeIndex, attributeIndex); }
+
+	virtual double						getValueTop(int attributeIndex) const
+	{ return get()->getValueTop(attributeIndex); }
+
+	virtual double						getValueBottom(int attributeIndex) const
+	{ return get()->getValueBottom(attributeIndex); }
+
+	virtual float							getRadius(int i) const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL) return p->getRadius(i);
+		if (i == 0) return radiusBottom;
+		if (i == nRadii-1) return radiusTop;
+		return get()->getRadius(i);
+	}
+
+	virtual int								getNRadii() const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		return p != NULL ? p->getNRadii() : nRadii;
+	}
+
+	virtual int								getNData() const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		return p != NULL ? p->getNData() : nData;
+	}
+
+	virtual float*						getRadii() { return get()->getRadii(); }
+
+	virtual GeoTessData**			getData() { return get()->getData(); }
+
+	virtual GeoTessData*			getData(int i) { return get()->getData(i); }
+
+	virtual const GeoTessData&	getData(int i) const { return ((const GeoTessProfile*) get())->getData(i); }
+
+	virtual void							setData(int index, GeoTessData* data) { get()->setData(index, data); }
+
+	virtual void							setData(const vector<GeoTessData*>& inData) { get()->setData(inData); }
+
+	virtual void							setRadii(const vector<float>& newRadii) { get()->setRadii(newRadii); }
+
+	virtual void							setRadius(int index, float radius) { get()->setRadius(index, radius); }
+
+	virtual float							getRadiusTop() const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		return p != NULL ? p->getRadiusTop() : radiusTop;
+	}
+
+	virtual const GeoTessData&	getDataTop() const { return ((const GeoTessProfile*) get())->getDataTop(); }
+
+	virtual GeoTessData*			getDataTop() { return get()->getDataTop(); }
+
+	virtual float							getRadiusBottom() const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		return p != NULL ? p->getRadiusBottom() : radiusBottom;
+	}
+
+	virtual const GeoTessData&	getDataBottom() const { return ((const GeoTessProfile*) get())->getDataBottom(); }
+
+	virtual GeoTessData*			getDataBottom() { return get()->getDataBottom(); }
+
+	/**
+	 * Cubic spline coefficients are computed when the profile is decoded,
+	 * so a model prepared for cubic interpolation does not decode every
+	 * profile up front.
+	 */
+	virtual void							prepareInterpolation(const GeoTessInterpolatorType& radialType) const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL)
+			p->prepareInterpolation(radialType);
+		else if (&radialType == &GeoTessInterpolatorType::CUBIC_SPLINE)
+		{
+			cubic = true;
+
+			// the profile may have been decoded before the flag was seen.
+			p = profile.load();
+			if (p != NULL) p->prepareInterpolation(radialType);
+		}
+	}
+
+	virtual int								getRadiusIndex(double radius, int jlo) const
+	{ return get()->getRadiusIndex(radius, jlo); }
+
+	virtual double						getInterpolationCoefficient(int i, double radius,
+			bool allowOutOfRange) const
+	{ return get()->getInterpolationCoefficient(i, radius, allowOutOfRange); }
+
+	virtual int								getPointIndex(int nodeIndex) const
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL) return p->getPointIndex(nodeIndex);
+		return pointIndices == NULL ? -1 : pointIndices[nodeIndex];
+	}
+
+	virtual int								findClosestRadiusIndex(double radius) const
+	{ return get()->findClosestRadiusIndex(radius); }
+
+	/// @cond PROTECTED  Turn off doxygen documentation until 'endcond' is found
+
+	virtual void							getWeights(map<int, double>& weights,
+			double dkm, double radius, double hcoefficient) const
+	{ get()->getWeights(weights, dkm, radius, hcoefficient); }
+
+	virtual void							getCoefficients(map<int, double>& coefficients, double radius,
+			double horizontalCoefficient) const
+	{ get()->getCoefficients(coefficients, radius, horizontalCoefficient); }
+
+	virtual void							write(IFStreamBinary& ofs) { get()->write(ofs); }
+
+	virtual void							write(IFStreamAscii& ofs) { get()->write(ofs); }
+
+	virtual void							setPointIndex(int nodeIndex, int pointIndex)
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL)
+		{
+			p->setPointIndex(nodeIndex, pointIndex);
+			return;
+		}
+		if (pointIndices == NULL)
+		{
+			if (pointIndex < 0) return;
+
+			pointIndices = new int [nData];
+			for (int i = 0; i < nData; ++i) pointIndices[i] = -1;
+		}
+		pointIndices[nodeIndex] = pointIndex;
+	}
+
+	virtual void							resetPointIndices()
+	{
+		GeoTessProfile* p = profile.load(memory_order_acquire);
+		if (p != NULL)
+			p->resetPointIndices();
+		else if (pointIndices != NULL)
+			for (int i = 0; i < nData; ++i) pointIndices[i] = -1;
+	}
+
+	virtual void							setInterpolationCoefficients(const GeoTessInterpolatorType& interpType,
+			vector<int>& nodeIndexes, vector<double>& coefficients,
+			double& radius, bool& allowOutOfRange)
+	{ get()->setInterpolationCoefficients(interpType, nodeIndexes, coefficients, radius, allowOutOfRange); }
+
+	/**
+	 * Returns a deep copy of the decoded profile.  Caller assumes ownership.
+	 */
+	virtual GeoTessProfile*		copy() { return get()->copy(); }
+
+	///@endcond
+
+}; // end class ProfileLazy
+
+} // end namespace geotess
+
+#endif  // PROFILELAZY_OBJECT_H
@@ -423,6 +423,17 @@ public:
 			int attributeIndex, double radius,
 			bool allowRadiusOutOfRange) const;
 
+	/**
+	 * If radialType is CUBIC_SPLINE, compute the spline second derivatives of
+	 * all attributes so that getValue() no longer modifies this profile.
+	 */
+	virtual void				prepareInterpolation(const GeoTessInterpolatorType& radialType) const
+	{
+		if (&radialType == &GeoTessInterpolatorType::CUBIC_SPLINE && nNodes > 1)
+			for (int i=0; i<data[0]->size(); ++i)
+				check(i);
+	}
+
 	/**
 	 * Find index i such that x is >= xx[i] and < xx[i+1]. If x < xx[1] returns
 	 * 0. If x >= xx[xx.length-2] return xx.length-2.
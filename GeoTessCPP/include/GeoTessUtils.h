@@ -411,6 +411,75 @@ static void rotate(const double* const x, const double* const p, double a,
 			const double& delta, const bool& onCenters, double** points,
 			int& npoints);
 
+	/**
+	 * Retrieve the unit vectors of a bunch of points distributed along a great circle path between
+	 * two points.  Points are returned in structure-of-arrays layout: the components of the
+	 * i'th point are x[i], y[i] and z[i].  Unlike the double** versions, this method requires
+	 * no memory allocation and evaluates sin and cos only a handful of times regardless of
+	 * the number of points (see getGreatCirclePoints(greatCircle, dx0, dx, ...)).
+	 * @param ptA unit vector of first point on great circle (input)
+	 * @param ptB unit vector of last point on great circle (input)
+	 * @param npoints the number of points to distribute along the great circle path (input)
+	 * @param onCenters if true, returned points will be located in the centers of equal size
+	 * path increments.  If false, first point will coincide with ptA, last point will coincide
+	 * with ptB and the remaining points will be equally spaced in between. (input)
+	 * @param x array of length npoints populated with the x components of the points.
+	 * @param y array of length npoints populated with the y components of the points.
+	 * @param z array of length npoints populated with the z components of the points.
+	 * @return actual point spacing in radians
+	 */
+	static double getGreatCirclePoints(const double* const ptA, const double* const ptB,
+			const int& npoints, const bool& onCenters,
+			double* const x, double* const y, double* const z);
+
+	/**
+	 * A great circle is defined by two unit vectors that are 90 degrees apart.
+	 * A great circle is stored in a double[2][3] array and one can be obtained
+	 * by calling one of the getGreatCircle() methods.
+	 * <p>
+	 * Populate npoints unit vectors located on the great circle at distances
+	 * dx0 + i*dx radians from the first point of the great circle, for i = 0
+	 * to npoints-1.  Points are returned in structure-of-arrays layout.
+	 * <p>
+	 * Sines and cosines are computed with sinCos(), so the cost per point is
+	 * a few multiply-adds in a loop the compiler can vectorize.
+	 * @param greatCircle a great circle structure
+	 * @param dx0 distance in radians from first point of great circle to the first point returned.
+	 * @param dx spacing of the returned points, in radians.
+	 * @param npoints number of points to compute.
+	 * @param x array of length npoints populated with the x components of the points.
+	 * @param y array of length npoints populated with the y components of the points.
+	 * @param z array of length npoints populated with the z components of the points.
+	 */
+	static void getGreatCirclePoints(double const* const * const greatCircle,
+			const double& dx0, const double& dx, const int& npoints,
+			double* const x, double* const y, double* const z);
+
+	/**
+	 * Compute sin(a0 + i*da) and cos(a0 + i*da) for i = 0 to n-1.
+	 * <p>
+	 * Rather than calling sin() and cos() for every angle, the angles are
+	 * processed in blocks of SINCOS_BLOCK.  sin and cos of j*da, for j within
+	 * a block, are tabulated once with the rotation recurrence and every
+	 * angle is then obtained from the angle addition formulas applied to the
+	 * first angle of its block.  sin() and cos() are called exactly only once
+	 * per block, so recurrence error cannot accumulate beyond SINCOS_BLOCK steps,
+	 * and the inner loop has no dependencies between iterations so it vectorizes.
+	 * @param a0 the first angle, in radians
+	 * @param da the angle increment, in radians
+	 * @param n the number of angles
+	 * @param s array of length n populated with the sines
+	 * @param c array of length n populated with the cosines
+	 */
+	static void sinCos(const double& a0, const double& da, const int& n,
+			double* const s, double* const c);
+
+	/**
+	 * The number of consecutive angles that share one exact evaluation of
+	 * sin() and cos() in sinCos() and getGreatCirclePoints().
+	 */
+	static const int SINCOS_BLOCK = 64;
+
 	/**
 	 * Find the length of a 3-element vector.
 	 *
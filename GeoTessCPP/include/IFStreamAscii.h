@@ -82,9 +82,39 @@ class GEOTESS_EXP_IMP IFStreamAscii
   private:
 
 		/**
-		 * Input stream.
+		 * Contents of the file opened by openForRead(const string&).  The
+		 * whole file is read into memory when it is opened and all subsequent
+		 * reads are served from this buffer.
 		 */
-		ifstream			ifs;
+		string						strBuffer;
+
+		/**
+		 * The characters being read.  Points into strBuffer, or into the
+		 * buffer of another IFStreamAscii when this reader was opened on a
+		 * section of that reader with openForRead(const IFStreamAscii&, ...).
+		 */
+		const char*				strData;
+
+		/**
+		 * Number of characters in strData.
+		 */
+		size_t						strSize;
+
+		/**
+		 * Offset in strData of the first character of the next line.
+		 */
+		size_t						strPos;
+
+		/**
+		 * True while a file or buffer section is open for read.
+		 */
+		bool							strReadOpen;
+
+		/**
+		 * Set when getLine() reaches the end of strData, with the same meaning
+		 * as ifstream::eof() after a call to std::getline().
+		 */
+		bool							strEOF;
 
 		/**
 		 * Output stream.
@@ -141,17 +171,60 @@ class GEOTESS_EXP_IMP IFStreamAscii
 		 */
     int								strTokenPtr;
 
+		/**
+     * The current data line, from which tokens are read.
+		 */
+    string						strLine;
+
 		/**
      * The stream token list.
      *
      *  This parameter is only modified when a new stream
      *  is set (constructors and the function set) and in the private function
-     *  read(string& s). The list and pointer point to the next token availble
+     *  readToken(). The list and pointer point to the next token availble
      *  in the current stream. When strTokenPtr == strTokens.size() it is
-     *  zeroed and a new line is read (read_line) from the stream. The new
-     *  line is then tokenized into the vector strTokens.
+     *  zeroed and a new line is read (read_line) from the stream into strLine.
+     *  The new line is then tokenized into the vector strTokens, which holds
+     *  the offset and length of each token in strLine so that numeric tokens
+     *  can be converted without first being copied into a string.
 		 */
-    vector<string>		strTokens;
+    vector<pair<int, int> >	strTokens;
+
+		/**
+		 * Read the next data line into strLine and tokenize it.  Returns false
+		 * at eof.
+		 */
+		bool							readTokenLine();
+
+		/**
+		 * Set beg and end to the first and one past the last character of the
+		 * next token.  The pointers remain valid until the next token is read.
+		 * Returns false at eof.
+		 */
+		bool							readToken(const char*& beg, const char*& end);
+
+		/**
+		 * Tokenize str into the offset and length of each token.
+		 */
+		void							tokenize(const string& str, vector<pair<int, int> >& tokens);
+
+		/**
+		 * Convert the characters [beg, end) of a token to a number.  Return
+		 * false if the token does not start with a number.  Plain decimal
+		 * numbers are converted directly from the token; anything else (or
+		 * a decimal number with too many digits to be converted exactly) is
+		 * handed to the C library.
+		 */
+		static bool				scanInteger(const char* beg, const char* end, long long& l);
+		static bool				scanFloat(const char* beg, const char* end, float& f);
+		static bool				scanDouble(const char* beg, const char* end, double& d);
+
+		/**
+		 * Throw the exception reporting a token that could not be converted to
+		 * the specified type.
+		 */
+		void							throwScanError(const string& function, const string& type,
+																		 const char* beg, const char* end, const int& code);
 
 	public:
 
@@ -163,12 +236,14 @@ class GEOTESS_EXP_IMP IFStreamAscii
 	/**
 	 * Read a single line from the underlying istream.
 	 */
-	void getline(string& s) { std::getline(ifs, s); };
+	void getline(string& s) { getLine(s); };
 
 		/**
 		 * Default constructor.
 		 */
-											IFStreamAscii() :	strFileName(""), strTotlLinesRead(0),
+											IFStreamAscii() :	strData(NULL), strSize(0), strPos(0),
+																				strReadOpen(false), strEOF(false),
+																				strFileName(""), strTotlLinesRead(0),
 																				strDataLinesRead(0), strBlankLinesRead(0),
 																				strCommentLinesRead(0), strBlkCommentLinesRead(0),
 																				strBytesRead(0), strBlkCommntSet(false),
@@ -186,18 +261,53 @@ class GEOTESS_EXP_IMP IFStreamAscii
 		void							openForRead(const string& fn);
 		void							openForWrite(const string& fn);
 
+		/**
+		 * Open this stream for read access to a section of another stream that
+		 * is open for read.  The section starts at offset begin, which must be
+		 * the start of a line (see getPosition()), and ends at offset end.  No
+		 * characters are copied, so source must remain open while this stream
+		 * is in use.  Delimiters are copied from source.  Several streams may
+		 * read different sections of the same source concurrently.
+		 * @param source the stream whose contents are to be read.
+		 * @param begin offset in source of the first character to read.
+		 * @param end offset in source of the first character not to read.
+		 * @param linesRead the number of lines of source that precede begin,
+		 * so that line numbers reported in error messages refer to the file.
+		 */
+		void							openForRead(const IFStreamAscii& source, const size_t& begin,
+																	const size_t& end, const int& linesRead);
+
+		/**
+		 * Return the offset of the start of the next line that will be read
+		 * from this stream.
+		 */
+		size_t						getPosition() const { return strPos; }
+
+		/**
+		 * Return true if all the tokens of the lines read so far have been
+		 * consumed and no block comment is open, i.e., the next token will be
+		 * read from the line that starts at getPosition().
+		 */
+		bool							isLineBoundary() const
+											{ return strTokenPtr >= (int) strTokens.size() && !strBlkCommntSet; }
+
 		/**
 		 * Returns true if the stream is open.
 		 */
-		bool							isOpen() { return (ifs.is_open() || ofs.is_open()) ? true : false; }
+		bool							isOpen() { return (strReadOpen || ofs.is_open()) ? true : false; }
 
 		/**
 		 * Close the input stream if it is open.
 		 */
 		void							close()
 											{
-												if (ifs.is_open())
-													ifs.close();
+												if (strReadOpen)
+												{
+													strReadOpen = false;
+													strData = NULL;
+													strSize = strPos = 0;
+													string().swap(strBuffer);
+												}
 												else if (ofs.is_open())
 													ofs.close();
 											}
@@ -378,6 +488,11 @@ class GEOTESS_EXP_IMP IFStreamAscii
 		 */
 		bool							next();
 
+		/**
+		 * Skips the next n tokens.  Return true if SUCCESSFUL
+		 */
+		bool							skip(int n);
+
 		/**
 		 * Read the next string. Return true if SUCCESSFUL
 		 */
@@ -517,37 +632,39 @@ class GEOTESS_EXP_IMP IFStreamAscii
 }; // end class IFStreamAscii
 
 /**
- * Reads and returns a single token from the stream.
+ * Sets beg and end to the first and one past the last character of the next
+ * token in the stream.
  *
- * The new token is contained in the input string reference token. The
- * function returns true if successful. If eof() is reached false is returned.
+ * The function returns true if successful. If eof() is reached false is
+ * returned.
  */
-inline bool IFStreamAscii::read(string& token)
+inline bool IFStreamAscii::readToken(const char*& beg, const char*& end)
 {
-  string ln;
-
   // if the strTokenPtr is >= than strTokens.size() then get more tokens
 
-  if (strTokenPtr >= (int) strTokens.size())
-  {
-    // get more tokens ... reset token pointer and list
-
-    strTokenPtr = 0;
-    strTokens.clear();
-
-    // read another data line from the stream ... if eof() is reached return
-    // true
-
-    if (!readLine(ln)) return false;
-
-    // tokennize the line into the tokens list
+  if ((strTokenPtr >= (int) strTokens.size()) && !readTokenLine()) return false;
 
-    tokenize(ln, strTokens);
-  }
+  // point at the token in the current line ... increment the pointer ... and
+  // return true for success
 
-  // get the token ... increment the pointer ... and return false for success
+  const pair<int, int>& t = strTokens[strTokenPtr++];
+  beg = strLine.data() + t.first;
+  end = beg + t.second;
+  return true;
+}
 
-  token = strTokens[strTokenPtr++];
+/**
+ * Reads and returns a single token from the stream.
+ *
+ * The new token is contained in the input string reference token. The
+ * function returns true if successful. If eof() is reached false is returned.
+ */
+inline bool IFStreamAscii::read(string& token)
+{
+  const char* beg;
+  const char* end;
+  if (!readToken(beg, end)) return false;
+  token.assign(beg, end);
   return true;
 }
 
@@ -556,7 +673,7 @@ inline bool IFStreamAscii::read(string& token)
  */
 inline bool IFStreamAscii::isEOF() const
 {
-  return (ifs.eof() && (strTokenPtr >= (int) strTokens.size()));
+  return (strEOF && (strTokenPtr >= (int) strTokens.size()));
 }
 
 /**
@@ -582,8 +699,21 @@ inline bool IFStreamAscii::readString(string& s)
  */
 inline bool IFStreamAscii::next()
 {
-	string s;
-  return read(s);
+  const char* beg;
+  const char* end;
+  return readToken(beg, end);
+}
+
+/**
+ * Skips the next n tokens.  Return true if SUCCESSFUL
+ */
+inline bool IFStreamAscii::skip(int n)
+{
+  const char* beg;
+  const char* end;
+  for (; n > 0; --n)
+    if (!readToken(beg, end)) return false;
+  return true;
 }
 
 /**
@@ -601,22 +731,19 @@ inline byte IFStreamAscii::readByte()
  */
 inline bool IFStreamAscii::readByte(byte& b)
 {
-  string sb;
+  const char* beg;
+  const char* end;
+  long long l;
 
-  // read token into sb ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(sb)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into b ... if unable issue error and return false
 
-  if (sscanf(sb.c_str(), "%hhd", &b) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readByte" << endl
-			 << "  Could Not Scan Byte From Token = " << sb << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9201);
-  }
+  if (!scanInteger(beg, end, l))
+    throwScanError("readByte", "Byte", beg, end, 9201);
+  b = (byte) l;
 
   // successful ... return true
 
@@ -638,22 +765,19 @@ inline short IFStreamAscii::readShort()
  */
 inline bool IFStreamAscii::readShort(short& s)
 {
-  string ss;
+  const char* beg;
+  const char* end;
+  long long l;
 
-  // read token into ss ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(ss)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into s ... if unable issue error and return false
 
-  if (sscanf(ss.c_str(), "%hd", &s) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readShort" << endl
-			 << "  Could Not Scan Short From Token = " << ss << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9202);
-  }
+  if (!scanInteger(beg, end, l))
+    throwScanError("readShort", "Short", beg, end, 9202);
+  s = (short) l;
 
   // successful ... return true
 
@@ -675,22 +799,19 @@ inline int IFStreamAscii::readInteger()
  */
 inline bool IFStreamAscii::readInteger(int& i)
 {
-  string si;
+  const char* beg;
+  const char* end;
+  long long l;
 
-  // read token into si ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(si)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into i ... if unable issue error and return false
 
-  if (sscanf(si.c_str(), "%d", &i) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readInteger" << endl
-			 << "  Could Not Scan Integer From Token = " << si << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9203);
-  }
+  if (!scanInteger(beg, end, l))
+    throwScanError("readInteger", "Integer", beg, end, 9203);
+  i = (int) l;
 
   // successful ... return true
 
@@ -712,22 +833,19 @@ inline LONG_INT IFStreamAscii::readLong()
  */
 inline bool IFStreamAscii::readLong(LONG_INT& l)
 {
-  string sl;
+  const char* beg;
+  const char* end;
+  long long ll;
 
-  // read token into sl ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(sl)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into l ... if unable issue error and return false
 
-  if (sscanf(sl.c_str(), LONG_INT_F, &l) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readLong" << endl
-			 << "  Could Not Scan Long From Token = " << sl << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9204);
-  }
+  if (!scanInteger(beg, end, ll))
+    throwScanError("readLong", "Long", beg, end, 9204);
+  l = (LONG_INT) ll;
 
   // successful ... return true
 
@@ -749,22 +867,17 @@ inline float IFStreamAscii::readFloat()
  */
 inline bool IFStreamAscii::readFloat(float& f)
 {
-  string sf;
+  const char* beg;
+  const char* end;
 
-  // read token into sf ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(sf)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into f ... if unable issue error and return false
 
-  if (sscanf(sf.c_str(), "%f", &f) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readFloat" << endl
-			 << "  Could Not Scan Float From Token = " << sf << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9205);
-  }
+  if (!scanFloat(beg, end, f))
+    throwScanError("readFloat", "Float", beg, end, 9205);
 
   // successful ... return true
 
@@ -786,22 +899,17 @@ inline double IFStreamAscii::readDouble()
  */
 inline bool IFStreamAscii::readDouble(double& d)
 {
-  string sd;
+  const char* beg;
+  const char* end;
 
-  // read token into sd ... if eof or stream not open return false
+  // read token ... if eof or stream not open return false
 
-  if (!read(sd)) return false;
+  if (!readToken(beg, end)) return false;
 
   // attempt to scan token into d ... if unable issue error and return false
 
-  if (sscanf(sd.c_str(), "%lf", &d) != 1)
-  {
-    ostringstream os;
-		os << endl << "ERROR in IFStreamAscii::readDouble" << endl
-			 << "  Could Not Scan Double From Token = " << sd << endl
-       << "  On File Line: " << strTotlLinesRead << " ..." << endl;
-   	throw GeoTessException(os, __FILE__, __LINE__, 9206);
-  }
+  if (!scanDouble(beg, end, d))
+    throwScanError("readDouble", "Double", beg, end, 9206);
 
   // successful ... return true
 
@@ -44,6 +44,7 @@
 #include <fstream>
 #include <vector>
 #include <sstream>
+#include <algorithm>
 
 // use standard library objects
 using namespace std;
@@ -121,13 +122,38 @@ class GEOTESS_EXP_IMP IFStreamBinary
 
 		int							bMemIncr;
 
+		/**
+		 * The file to which the buffer is written, one block at a time, when
+		 * this IFStreamBinary is open for streaming write (see openForWrite()).
+		 * NULL otherwise.
+		 */
+		ofstream*				bStream;
+
+		/**
+		 * The temporary file, next to bFileName, that bStream writes.  close()
+		 * renames it to bFileName, so an existing file is not replaced until
+		 * the new one is complete.
+		 */
+		string					bTempFileName;
+
+		/**
+		 * The number of bytes that have been written to bStream.
+		 */
+		long long				bFlushed;
+
+		/**
+		 * When open for streaming write, the buffer is written to bStream
+		 * whenever it would otherwise grow beyond this many bytes.
+		 */
+		int							bBlockSize;
+
     /**
 		 * Ensure that the buffer position pointer (dbDataPos) is
 		 * aligned on a 4 byte boundary.
      */
     void						align2Byte()
 		{
-			int sm = bDataPos % CPPUtils::SSHT;
+			int sm = (int) ((bFlushed + bDataPos) % CPPUtils::SSHT);
 			if (sm && bAlign) bDataPos += CPPUtils::SSHT - sm;
 		}
 
@@ -137,7 +163,7 @@ class GEOTESS_EXP_IMP IFStreamBinary
      */
     void						align4Byte()
 		{
-			int sm = bDataPos % CPPUtils::SINT;
+			int sm = (int) ((bFlushed + bDataPos) % CPPUtils::SINT);
 			if (sm && bAlign) bDataPos += CPPUtils::SINT - sm;
 		}
 
@@ -147,24 +173,38 @@ class GEOTESS_EXP_IMP IFStreamBinary
      */
     void						align8Byte()
 		{
-			int sm = bDataPos % CPPUtils::SDBL;
+			int sm = (int) ((bFlushed + bDataPos) % CPPUtils::SDBL);
 			if (sm && bAlign) bDataPos += CPPUtils::SDBL - sm;
 		}
 
 		/**
 		 * This function checks to make sure that the buffer is large enough to
 		 * contain sincr more bytes ... if not it is resized so that it can.
+		 * The capacity is at least doubled each time it is exceeded so that
+		 * writing a large buffer does not copy it repeatedly. When open for
+		 * streaming write, the buffer is first written to the file if it would
+		 * otherwise grow beyond bBlockSize.
 		 */
     void						checkBufferSize(int sincr)
 		{
+			if ((bStream != NULL) && (bDataPos > 0) && (bDataPos + sincr > bBlockSize))
+				flushBlock();
+
 			if (bDataPos + sincr > (int) bData->size())
 			{
-				if (sincr + bData->size() > bData->capacity())
-					bData->reserve(bData->capacity() + bMemIncr);
-				bData->append(bDataPos + sincr - bData->size(), ' ');
+				size_t sze = (size_t) bDataPos + sincr;
+				size_t cap = bData->capacity();
+				if (sze > cap)
+					bData->reserve(max(sze, cap + max(cap, (size_t) bMemIncr)));
+				bData->append(sze - bData->size(), ' ');
 			}
 		}
 
+		/**
+		 * Write the contents of the buffer to bStream and empty the buffer.
+		 */
+		void						flushBlock();
+
 		/*
 		 * Reverses each s-byte element of array a containing n elements
 		 * (s*n bytes). The element size s must be 2, 4, or 8.
@@ -243,6 +283,46 @@ class GEOTESS_EXP_IMP IFStreamBinary
 		 */
 		static bool 		exists(const string& filename);
 
+		/**
+		 * Open a file for streaming write.  Data subsequently written to this
+		 * IFStreamBinary are accumulated in the buffer, which is written to
+		 * the file whenever it would otherwise grow beyond blockSize bytes, so
+		 * the memory used is bounded by blockSize (or the largest single array
+		 * written) rather than by the size of the file.  Functions that take a
+		 * buffer position address only the bytes that have not yet been
+		 * written to the file.  The bytes go to a temporary file in the same
+		 * directory, and an existing file named filename is left untouched
+		 * until close() writes the remaining bytes and renames the temporary
+		 * file to filename.
+		 * @param filename the name of the file to write.
+		 * @param blockSize the number of bytes accumulated before they are
+		 * written to the file.
+		 */
+		void						openForWrite(const string& filename, int blockSize = 4194304);
+
+		/**
+		 * Write any bytes remaining in the buffer to the file opened by
+		 * openForWrite() and close the file.  Does nothing if no file is open
+		 * for streaming write.
+		 */
+		void						close();
+
+		/**
+		 * Abandon a streaming write: close the temporary file opened by
+		 * openForWrite() without writing the bytes remaining in the buffer,
+		 * and delete it.  The file named in openForWrite() is not touched.
+		 * The destructor calls this if close() was never called, so a write
+		 * interrupted by an exception neither leaves a truncated file nor
+		 * destroys the previous one.  Does nothing if no file is open for
+		 * streaming write.
+		 */
+		void						discard();
+
+		/**
+		 * Return true if a file is open for streaming write.
+		 */
+		bool						isOpenForWrite() const { return bStream != NULL; }
+
 		/**
 		 * Write the buffer to the output file name.
 		 */
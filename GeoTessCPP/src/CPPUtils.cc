@@ -33,6 +33,15 @@
 //-
 //- ****************************************************************************
 
+#include <algorithm>
+
+#if defined WIN32 || defined _WIN32
+	#include <io.h>
+#else
+	#include <dirent.h>
+	#include <sys/stat.h>
+#endif
+
 #include "CPPUtils.h"
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
@@ -542,4 +551,37 @@ string CPPUtils::replace(const string& s, const string& r, const string& n)
 	return newString;
 }
 
+bool CPPUtils::listFiles(const string& directory, vector<string>& names)
+{
+	names.clear();
+
+#if defined WIN32 || defined _WIN32
+	struct _finddata_t entry;
+	intptr_t h = _findfirst(insertPathSeparator(directory, "*").c_str(), &entry);
+	if (h == -1)
+		return false;
+	do
+	{
+		if ((entry.attrib & _A_SUBDIR) == 0)
+			names.push_back(entry.name);
+	}
+	while (_findnext(h, &entry) == 0);
+	_findclose(h);
+#else
+	DIR* dir = opendir(directory.c_str());
+	if (dir == NULL)
+		return false;
+	struct dirent* entry;
+	struct stat info;
+	while ((entry = readdir(dir)) != NULL)
+		if (stat(insertPathSeparator(directory, entry->d_name).c_str(), &info) == 0
+				&& S_ISREG(info.st_mode))
+			names.push_back(entry->d_name);
+	closedir(dir);
+#endif
+
+	sort(names.begin(), names.end());
+	return true;
+}
+
 } // end namespace geotess
@@ -35,6 +35,11 @@
 
 #include "CpuTimer.h"
 
+#include <chrono>
+#if !(defined WIN32 || defined _WIN32)
+#include <time.h>
+#endif
+
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
 
 namespace geotess {
@@ -60,10 +65,43 @@ void CpuTimer::initTimer()
 {
   // initialize real and cpu times
 
-  cpuRealTime = getCurrRealTime();
+  cpuRealTime = getNanoTime();
   cpuCPUTime  = getCurrCPUTime();
 }
 
+/**
+ * Returns the current CPU time (msec) since process start.
+ */
+double CpuTimer::getCurrCPUTime()
+{
+#if defined WIN32 || defined _WIN32
+  return (double) 1000.0 * clock() / CLOCKS_PER_SEC;
+#else
+  struct timespec ts;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+    return (double) 1000.0 * clock() / CLOCKS_PER_SEC;
+  return 1.0e3 * ts.tv_sec + 1.0e-6 * ts.tv_nsec;
+#endif
+}
+
+/**
+ * Returns the current real time (wall clock) in msec since 1970.
+ */
+double CpuTimer::getCurrRealTime()
+{
+  return 1.0e-3 * (double) chrono::duration_cast<chrono::microseconds>(
+      chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Returns the current value of a monotonic clock in nsec.
+ */
+long long CpuTimer::getNanoTime()
+{
+  return (long long) chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 /**
  * Returns the elapsed cpu time (msec) since the last time the cpu
  * time was initialized.
@@ -91,7 +129,7 @@ double CpuTimer::cpuTimeInit()
  */
 double CpuTimer::realTime()
 {
-  return getCurrRealTime() - cpuRealTime;
+  return 1.0e-6 * (getNanoTime() - cpuRealTime);
 }
 
 /**
@@ -101,10 +139,10 @@ double CpuTimer::realTime()
  */
 double CpuTimer::realTimeInit()
 {
-  double old_time = cpuRealTime;
-  cpuRealTime = getCurrRealTime();
+  long long old_time = cpuRealTime;
+  cpuRealTime = getNanoTime();
 
-  return (cpuRealTime - old_time);
+  return 1.0e-6 * (cpuRealTime - old_time);
 }
 
 /**
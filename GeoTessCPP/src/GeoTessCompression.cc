@@ -0,0 +1,723 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+// **** _SYSTEM INCLUDES_ ******************************************************
+
+#include <cstring>
+#include <cmath>
+#include <climits>
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "GeoTessCompression.h"
+#include "GeoTessMetaData.h"
+#include "GeoTessException.h"
+#include "GeoTessParallel.h"
+#include "GeoTessData.h"
+#include "GeoTessProfile.h"
+#include "GeoTessProfileEmpty.h"
+#include "GeoTessProfileThin.h"
+#include "GeoTessProfileConstant.h"
+#include "GeoTessProfileNPoint.h"
+#include "GeoTessProfileSurface.h"
+#include "GeoTessProfileSurfaceEmpty.h"
+#include "IFStreamBinary.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _EXPLICIT TEMPLATE INSTANTIATIONS_ *************************************
+
+// **** _STATIC INITIALIZATIONS_************************************************
+
+const int GeoTessCompression::BLOCK_VERTICES;
+
+// **** _FUNCTION IMPLEMENTATIONS_ *********************************************
+
+// LZ77 coder.  The compressed data are a sequence of tokens.  Each token is
+// a byte whose high nibble is the number of literal bytes that follow it and
+// whose low nibble is the length of a match minus LZ_MIN_MATCH.  A nibble
+// of 15 is followed by additional length bytes that are summed until a byte
+// less than 255 is found.  The literals are followed by the 2 byte, little
+// endian, distance back to the match.  The last token has only literals.
+
+static const int LZ_MIN_MATCH = 4;
+static const int LZ_HASH_BITS = 14;
+static const int LZ_MAX_OFFSET = 65535;
+
+static inline unsigned int lzRead32(const uByte* p)
+{
+	unsigned int v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static inline int lzHash(const uByte* p)
+{
+	return (int) ((lzRead32(p) * 2654435761U) >> (32 - LZ_HASH_BITS));
+}
+
+static inline void lzWriteLength(vector<uByte>& output, int length)
+{
+	for (; length >= 255; length -= 255)
+		output.push_back(255);
+	output.push_back((uByte) length);
+}
+
+static void lzWriteSequence(vector<uByte>& output, const uByte* literals, int nLiterals,
+		int offset, int matchLength)
+{
+	int m = matchLength - LZ_MIN_MATCH;
+	output.push_back((uByte) (((nLiterals < 15 ? nLiterals : 15) << 4)
+			| (matchLength == 0 ? 0 : (m < 15 ? m : 15))));
+	if (nLiterals >= 15)
+		lzWriteLength(output, nLiterals - 15);
+	output.insert(output.end(), literals, literals + nLiterals);
+
+	if (matchLength > 0)
+	{
+		output.push_back((uByte) (offset & 255));
+		output.push_back((uByte) (offset >> 8));
+		if (m >= 15)
+			lzWriteLength(output, m - 15);
+	}
+}
+
+static void corrupt(const string& message)
+{
+	ostringstream os;
+	os << endl << "ERROR in GeoTessCompression" << endl
+			<< "Compressed profile data are corrupt: " << message << endl;
+	throw GeoTessException(os, __FILE__, __LINE__, 12001);
+}
+
+static inline int lzReadLength(const uByte* input, int& ip, const int& inputLength)
+{
+	int length = 0;
+	uByte b;
+	do
+	{
+		if (ip >= inputLength)
+			corrupt("length runs past the end of the block");
+		b = input[ip++];
+		length += b;
+	}
+	while (b == 255);
+	return length;
+}
+
+void GeoTessCompression::compress(const vector<uByte>& input, vector<uByte>& output)
+{
+	output.clear();
+	int n = (int) input.size();
+	output.reserve(n / 2 + 16);
+
+	const uByte* in = n > 0 ? &input[0] : NULL;
+	vector<int> table(1 << LZ_HASH_BITS, -1);
+
+	// a match must leave at least LZ_MIN_MATCH bytes to compare.
+	int limit = n - LZ_MIN_MATCH;
+	int anchor = 0, i = 0, misses = 0;
+	while (i <= limit)
+	{
+		int h = lzHash(in + i);
+		int candidate = table[h];
+		table[h] = i;
+
+		if (candidate < 0 || i - candidate > LZ_MAX_OFFSET
+				|| lzRead32(in + candidate) != lzRead32(in + i))
+		{
+			// skip ahead faster through data that do not compress.
+			i += 1 + (++misses >> 6);
+			continue;
+		}
+		misses = 0;
+
+		int length = LZ_MIN_MATCH;
+		while (i + length < n && in[candidate + length] == in[i + length])
+			++length;
+
+		lzWriteSequence(output, in + anchor, i - anchor, i - candidate, length);
+
+		int end = i + length;
+		for (int k = i + 1; k < end && k <= limit; k += 2)
+			table[lzHash(in + k)] = k;
+
+		i = anchor = end;
+	}
+
+	lzWriteSequence(output, in + anchor, n - anchor, 0, 0);
+}
+
+void GeoTessCompression::decompress(const uByte* input, const int& inputLength,
+		uByte* output, const int& outputLength)
+{
+	int ip = 0, op = 0;
+	while (true)
+	{
+		if (ip >= inputLength)
+			corrupt("unexpected end of block");
+
+		int token = input[ip++];
+		int nLiterals = token >> 4;
+		if (nLiterals == 15)
+			nLiterals += lzReadLength(input, ip, inputLength);
+		if (nLiterals > inputLength - ip || nLiterals > outputLength - op)
+			corrupt("literals overrun the block");
+		memcpy(output + op, input + ip, nLiterals);
+		ip += nLiterals;
+		op += nLiterals;
+
+		// the last sequence has no match
+		if (ip == inputLength)
+			break;
+
+		if (ip + 2 > inputLength)
+			corrupt("unexpected end of block");
+		int offset = input[ip] | (input[ip + 1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > op)
+			corrupt("match offset out of range");
+
+		int length = token & 15;
+		if (length == 15)
+			length += lzReadLength(input, ip, inputLength);
+		length += LZ_MIN_MATCH;
+		if (length > outputLength - op)
+			corrupt("match overruns the block");
+
+		// matches may overlap the bytes they produce, so copy forward.
+		uByte* match = output + op - offset;
+		for (int k = 0; k < length; ++k)
+			output[op + k] = match[k];
+		op += length;
+	}
+
+	if (op != outputLength)
+		corrupt("decompressed block has the wrong length");
+}
+
+// Raw block streams.  Multi-byte values are split into byte planes, least
+// significant byte first, so the layout does not depend on the byte order
+// of the machine.
+
+/**
+ * Sequential reader of a raw block that checks every access.
+ */
+struct GeoTessBlockReader
+{
+	const vector<uByte>& raw;
+	size_t pos;
+
+	GeoTessBlockReader(const vector<uByte>& r) : raw(r), pos(0) {}
+
+	const uByte* take(size_t n)
+	{
+		if (n > raw.size() - pos)
+			corrupt("block is truncated");
+		const uByte* p = raw.empty() ? NULL : &raw[pos];
+		pos += n;
+		return p;
+	}
+
+	unsigned long long varint()
+	{
+		unsigned long long v = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			uByte b = *take(1);
+			v |= (unsigned long long) (b & 127) << shift;
+			if (b < 128)
+				return v;
+		}
+		corrupt("malformed variable length integer");
+		return 0;
+	}
+};
+
+static inline void putVarint(vector<uByte>& raw, unsigned long long v)
+{
+	for (; v >= 128; v >>= 7)
+		raw.push_back((uByte) (v | 128));
+	raw.push_back((uByte) v);
+}
+
+template <typename U>
+static void putPlanes(vector<uByte>& raw, const vector<U>& bits)
+{
+	size_t n = bits.size(), base = raw.size();
+	if (n == 0) return;
+	raw.resize(base + n * sizeof(U));
+	for (size_t k = 0; k < sizeof(U); ++k)
+	{
+		uByte* plane = &raw[base + k * n];
+		for (size_t i = 0; i < n; ++i)
+			plane[i] = (uByte) (bits[i] >> (8 * k));
+	}
+}
+
+template <typename U>
+static void getPlanes(GeoTessBlockReader& reader, size_t n, vector<U>& bits)
+{
+	const uByte* p = reader.take(n * sizeof(U));
+	bits.assign(n, 0);
+	for (size_t k = 0; k < sizeof(U); ++k)
+		for (size_t i = 0; i < n; ++i)
+			bits[i] |= (U) ((U) p[k * n + i] << (8 * k));
+}
+
+/**
+ * Store attribute a of every data object as the exclusive-or of consecutive
+ * values.  T is the type of the data, S the fixed width type that is stored
+ * and U the unsigned integer with the width of S.
+ */
+template <typename T, typename S, typename U>
+static void encodeExact(const vector<GeoTessData*>& data, int a, vector<uByte>& raw)
+{
+	vector<U> bits(data.size());
+	U previous = 0;
+	T t;
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i]->getValue(a, t);
+		S s = (S) t;
+		U u;
+		memcpy(&u, &s, sizeof(U));
+		bits[i] = u ^ previous;
+		previous = u;
+	}
+	putPlanes(raw, bits);
+}
+
+template <typename T, typename S, typename U>
+static void decodeExact(GeoTessBlockReader& reader, vector<GeoTessData*>& data, int a)
+{
+	vector<U> bits;
+	getPlanes(reader, data.size(), bits);
+	U previous = 0;
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		previous ^= bits[i];
+		if (a >= 0)
+		{
+			S s;
+			memcpy(&s, &previous, sizeof(U));
+			data[i]->setValue(a, (T) s);
+		}
+	}
+}
+
+// quantized value that represents NaN
+static const long long QUANTIZED_NAN = LLONG_MIN;
+
+/**
+ * Store attribute a of every data object rounded to the nearest multiple of
+ * precision, as zigzag encoded differences of consecutive values.
+ */
+template <typename T>
+static void encodeQuantized(const vector<GeoTessData*>& data, int a, double precision,
+		vector<uByte>& raw)
+{
+	long long previous = 0;
+	T t;
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i]->getValue(a, t);
+		double x = t / precision;
+		long long q;
+		if (std::isnan(x))
+			q = QUANTIZED_NAN;
+		else if (fabs(x) < 4.e18)
+			q = llround(x);
+		else
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessCompression::writeProfiles" << endl
+					<< "Cannot quantize value " << t << " of attribute " << a
+					<< " with precision " << precision << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 12002);
+		}
+
+		unsigned long long delta = (unsigned long long) q - (unsigned long long) previous;
+		previous = q;
+		putVarint(raw, (delta << 1) ^ (unsigned long long) ((long long) delta >> 63));
+	}
+}
+
+template <typename T>
+static void decodeQuantized(GeoTessBlockReader& reader, vector<GeoTessData*>& data, int a,
+		double precision)
+{
+	unsigned long long previous = 0;
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		unsigned long long z = reader.varint();
+		previous += (z >> 1) ^ (0ULL - (z & 1));
+		if (a >= 0)
+		{
+			long long q = (long long) previous;
+			data[i]->setValue(a, q == QUANTIZED_NAN ? (T) NaN_DOUBLE : (T) (q * precision));
+		}
+	}
+}
+
+void GeoTessCompression::encodeBlock(GeoTessProfile*** profiles, const int& first,
+		const int& last, GeoTessMetaData& metaData, vector<uByte>& raw)
+{
+	raw.clear();
+	int nLayers = metaData.getNLayers();
+
+	vector<unsigned int> radii;
+	vector<GeoTessData*> data;
+
+	// profile types
+	for (int v = first; v < last; ++v)
+		for (int j = 0; j < nLayers; ++j)
+			raw.push_back((uByte) profiles[v][j]->getType().ordinal());
+
+	// node counts of NPOINT profiles, then collect radii and data
+	unsigned int previous = 0;
+	for (int v = first; v < last; ++v)
+		for (int j = 0; j < nLayers; ++j)
+		{
+			GeoTessProfile* p = profiles[v][j];
+			if (p->getType().ordinal() == GeoTessProfileType::NPOINT.ordinal())
+				putVarint(raw, p->getNRadii());
+
+			for (int i = 0; i < p->getNRadii(); ++i)
+			{
+				float r = p->getRadius(i);
+				unsigned int u;
+				memcpy(&u, &r, 4);
+				radii.push_back(u ^ previous);
+				previous = u;
+			}
+			for (int i = 0; i < p->getNData(); ++i)
+				data.push_back(p->getData(i));
+		}
+	putPlanes(raw, radii);
+
+	// one stream per attribute
+	for (int a = 0; a < metaData.getNAttributes(); ++a)
+	{
+		double precision = metaData.getQuantization(a);
+		switch (metaData.getDataType().ordinal())
+		{
+		case 0 : // DOUBLE
+			if (precision > 0.)
+				encodeQuantized<double>(data, a, precision, raw);
+			else
+				encodeExact<double, double, unsigned long long>(data, a, raw);
+			break;
+		case 1 : // FLOAT
+			if (precision > 0.)
+				encodeQuantized<float>(data, a, precision, raw);
+			else
+				encodeExact<float, float, unsigned int>(data, a, raw);
+			break;
+		case 2 : // LONG
+			encodeExact<LONG_INT, long long, unsigned long long>(data, a, raw);
+			break;
+		case 3 : // INT
+			encodeExact<int, int, unsigned int>(data, a, raw);
+			break;
+		case 4 : // SHORT
+			encodeExact<short, short, unsigned short>(data, a, raw);
+			break;
+		case 5 : // BYTE
+			encodeExact<byte, byte, uByte>(data, a, raw);
+			break;
+		default :
+			ostringstream os;
+			os << endl << "ERROR in GeoTessCompression::writeProfiles" << endl
+					<< metaData.getDataType().toString() << " is not a recognized data type." << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 12003);
+		}
+	}
+}
+
+void GeoTessCompression::decodeBlock(const vector<uByte>& raw, const int& first,
+		const int& last, GeoTessMetaData& metaData, GeoTessProfile*** profiles)
+{
+	GeoTessBlockReader reader(raw);
+	int nLayers = metaData.getNLayers();
+	int nProfiles = (last - first) * nLayers;
+
+	// profile types, node counts and the resulting numbers of radii and data
+	const uByte* types = reader.take(nProfiles);
+	vector<int> nNodes(nProfiles);
+	size_t nRadii = 0, nData = 0;
+	for (int p = 0; p < nProfiles; ++p)
+	{
+		switch (types[p])
+		{
+		case 0 : // EMPTY
+			nNodes[p] = 2; nRadii += 2; break;
+		case 1 : // THIN
+			nNodes[p] = 1; nRadii += 1; nData += 1; break;
+		case 2 : // CONSTANT
+			nNodes[p] = 2; nRadii += 2; nData += 1; break;
+		case 3 : // NPOINT
+			nNodes[p] = (int) reader.varint();
+			if (nNodes[p] < 1 || nNodes[p] > (int) raw.size())
+				corrupt("invalid number of profile nodes");
+			nRadii += nNodes[p]; nData += nNodes[p]; break;
+		case 4 : // SURFACE
+			nNodes[p] = 0; nData += 1; break;
+		case 5 : // SURFACE_EMPTY
+			nNodes[p] = 0; break;
+		default :
+			corrupt("unrecognized profile type");
+		}
+	}
+
+	vector<unsigned int> bits;
+	getPlanes(reader, nRadii, bits);
+	vector<float> radii(nRadii);
+	unsigned int previous = 0;
+	for (size_t i = 0; i < nRadii; ++i)
+	{
+		previous ^= bits[i];
+		memcpy(&radii[i], &previous, 4);
+	}
+
+	// attributes that are excluded by the attribute filter are decoded
+	// but not stored.
+	vector<int> target;
+	if (metaData.applyAttributeFilter())
+		target = metaData.getAttributeFilter();
+	else
+		for (int a = 0; a < metaData.getNAttributes(); ++a)
+			target.push_back(a);
+
+	vector<GeoTessData*> data(nData, (GeoTessData*) NULL);
+	size_t handedOver = 0;
+	try
+	{
+		for (size_t i = 0; i < nData; ++i)
+			data[i] = GeoTessData::getData(metaData.getDataType(), metaData.getNAttributes());
+
+		for (int a = 0; a < (int) target.size(); ++a)
+		{
+			double precision = metaData.getQuantization(a);
+			switch (metaData.getDataType().ordinal())
+			{
+			case 0 : // DOUBLE
+				if (precision > 0.)
+					decodeQuantized<double>(reader, data, target[a], precision);
+				else
+					decodeExact<double, double, unsigned long long>(reader, data, target[a]);
+				break;
+			case 1 : // FLOAT
+				if (precision > 0.)
+					decodeQuantized<float>(reader, data, target[a], precision);
+				else
+					decodeExact<float, float, unsigned int>(reader, data, target[a]);
+				break;
+			case 2 : // LONG
+				decodeExact<LONG_INT, long long, unsigned long long>(reader, data, target[a]);
+				break;
+			case 3 : // INT
+				decodeExact<int, int, unsigned int>(reader, data, target[a]);
+				break;
+			case 4 : // SHORT
+				decodeExact<short, short, unsigned short>(reader, data, target[a]);
+				break;
+			case 5 : // BYTE
+				decodeExact<byte, byte, uByte>(reader, data, target[a]);
+				break;
+			default :
+				ostringstream os;
+				os << endl << "ERROR in GeoTessCompression::readProfiles" << endl
+						<< metaData.getDataType().toString() << " is not a recognized data type." << endl;
+				throw GeoTessException(os, __FILE__, __LINE__, 12004);
+			}
+		}
+
+		if (reader.pos != raw.size())
+			corrupt("unexpected data at the end of the block");
+
+		// assemble the profiles, which take ownership of the data objects
+		size_t r = 0;
+		int p = 0;
+		for (int v = first; v < last; ++v)
+			for (int j = 0; j < nLayers; ++j, ++p)
+			{
+				GeoTessProfile* profile = NULL;
+				switch (types[p])
+				{
+				case 0 :
+					profile = new GeoTessProfileEmpty(radii[r], radii[r + 1]);
+					break;
+				case 1 :
+					profile = new GeoTessProfileThin(radii[r], data[handedOver]);
+					++handedOver;
+					break;
+				case 2 :
+					profile = new GeoTessProfileConstant(radii[r], radii[r + 1], data[handedOver]);
+					++handedOver;
+					break;
+				case 3 :
+					profile = new GeoTessProfileNPoint(&radii[r], &data[handedOver], nNodes[p]);
+					handedOver += nNodes[p];
+					break;
+				case 4 :
+					profile = new GeoTessProfileSurface(data[handedOver]);
+					++handedOver;
+					break;
+				case 5 :
+					profile = new GeoTessProfileSurfaceEmpty();
+					break;
+				}
+				r += nNodes[p];
+				profiles[v][j] = profile;
+			}
+	}
+	catch (...)
+	{
+		for (size_t i = handedOver; i < nData; ++i)
+			delete data[i];
+		throw;
+	}
+}
+
+void GeoTessCompression::writeProfiles(IFStreamBinary& output, GeoTessProfile*** profiles,
+		GeoTessMetaData& metaData)
+{
+	int nVertices = metaData.getNVertices();
+	int blockVertices = BLOCK_VERTICES;
+	int nBlocks = (nVertices + blockVertices - 1) / blockVertices;
+
+	vector<uByte> method(nBlocks);
+	vector<int> rawLength(nBlocks);
+	vector<vector<uByte> > blocks(nBlocks);
+
+	GeoTessParallel::forEach(nBlocks, 1, [&](int first, int last, int)
+	{
+		vector<uByte> raw;
+		for (int b = first; b < last; ++b)
+		{
+			int end = (b + 1) * blockVertices;
+			encodeBlock(profiles, b * blockVertices, end < nVertices ? end : nVertices,
+					metaData, raw);
+			rawLength[b] = (int) raw.size();
+			compress(raw, blocks[b]);
+
+			// store blocks that do not compress as they are
+			method[b] = 1;
+			if (blocks[b].size() >= raw.size())
+			{
+				blocks[b].swap(raw);
+				method[b] = 0;
+			}
+		}
+	});
+
+	output.writeInt(blockVertices);
+	output.writeInt(nBlocks);
+	for (int b = 0; b < nBlocks; ++b)
+	{
+		output.writeByte((byte) method[b]);
+		output.writeInt(rawLength[b]);
+		output.writeInt((int) blocks[b].size());
+		if (!blocks[b].empty())
+			output.writeByteArray((const byte*) &blocks[b][0], (int) blocks[b].size());
+	}
+}
+
+void GeoTessCompression::readProfiles(IFStreamBinary& input, GeoTessProfile*** profiles,
+		GeoTessMetaData& metaData)
+{
+	int nVertices = metaData.getNVertices();
+	for (int i = 0; i < nVertices; ++i)
+		for (int j = 0; j < metaData.getNLayers(); ++j)
+			profiles[i][j] = NULL;
+
+	int blockVertices = input.readInt();
+	int nBlocks = input.readInt();
+	if (blockVertices < 1 || nBlocks != (nVertices + blockVertices - 1) / blockVertices)
+		corrupt("block count is inconsistent with the number of vertices");
+
+	vector<uByte> method(nBlocks);
+	vector<int> rawLength(nBlocks);
+	vector<vector<uByte> > blocks(nBlocks);
+	for (int b = 0; b < nBlocks; ++b)
+	{
+		method[b] = (uByte) input.readByte();
+		rawLength[b] = input.readInt();
+		int n = input.readInt();
+		if (method[b] > 1 || rawLength[b] < 0 || n < 0 || (method[b] == 0 && n != rawLength[b]))
+			corrupt("invalid block header");
+		blocks[b].resize(n);
+		if (n > 0)
+			input.readByteArray((byte*) &blocks[b][0], n);
+	}
+
+	GeoTessParallel::forEach(nBlocks, 1, [&](int first, int last, int)
+	{
+		vector<uByte> raw;
+		for (int b = first; b < last; ++b)
+		{
+			if (method[b] == 1)
+			{
+				raw.resize(rawLength[b]);
+				decompress(blocks[b].empty() ? NULL : &blocks[b][0], (int) blocks[b].size(),
+						raw.empty() ? NULL : &raw[0], rawLength[b]);
+			}
+			else
+				raw.swap(blocks[b]);
+			vector<uByte>().swap(blocks[b]);
+
+			int end = (b + 1) * blockVertices;
+			decodeBlock(raw, b * blockVertices, end < nVertices ? end : nVertices,
+					metaData, profiles);
+		}
+	});
+
+	// the quantization recorded in the file refers to the attributes in the
+	// file.  Map it to the attributes that were loaded.
+	if (metaData.applyAttributeFilter())
+	{
+		vector<int>& filter = metaData.getAttributeFilter();
+		vector<double> quantization(metaData.getNAttributes(), 0.);
+		for (int i = 0; i < (int) filter.size(); ++i)
+			if (filter[i] >= 0)
+				quantization[filter[i]] = metaData.getQuantization(i);
+		metaData.setQuantization(quantization);
+	}
+}
+
+} // end namespace geotess
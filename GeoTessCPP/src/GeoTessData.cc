@@ -54,7 +54,7 @@ namespace geotess {
 
 // **** _STATIC INITIALIZATIONS_************************************************
 
-int       GeoTessData::aClassCount    = 0;
+atomic<int> GeoTessData::aClassCount(0);
 
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
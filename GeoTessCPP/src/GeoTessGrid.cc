@@ -99,7 +99,7 @@ GeoTessGrid::GeoTessGrid(GeoTessGrid &other, double** eulerRotationMatrix) :
 	descendants(NULL), gridID(other.gridID),
 	gridInputFile(other.gridInputFile), gridOutputFile(other.gridOutputFile),
 	gridSoftwareVersion(other.gridSoftwareVersion),
-	gridGenerationDate(other.gridGenerationDate), refCount(0)
+	gridGenerationDate(other.gridGenerationDate), refCount(0), initializeTime(-1.)
 {
 	nVertices = other.nVertices;
 	vertices = CPPUtils::new2DArray<double>(nVertices, 3);
@@ -762,6 +762,8 @@ int GeoTessGrid::getTriangle(int triangleIndex, const double* vector)
  */
 void GeoTessGrid::initialize()
 {
+	CpuTimer timer;
+
 	// first, populate vtxTriangles, which is an
 	// nLevels x nVertices x n array of triangle indices
 	// that contains the list of triangles a vertex touches
@@ -973,6 +975,8 @@ void GeoTessGrid::initialize()
 		}
 	}
 	connectedVertices.resize(nLevels);
+
+	initializeTime = timer.realTime() * 1e-3;
 }
 
 void GeoTessGrid::computeSpokeLists(const int& level) const
@@ -1406,11 +1410,12 @@ void GeoTessGrid::writeGrid(const string& fileName)
 void GeoTessGrid::writeGridBinary(const string& fileName)
 {
 	IFStreamBinary ofs;
+	ofs.openForWrite(fileName);
 	if (!CPPUtils::isBigEndian()) ofs.byteOrderReverseOn();
 	ofs.boundaryAlignmentOff();
 
 	writeGridBinary(ofs);
-	ofs.writeToFile(fileName);
+	ofs.close();
 }
 
 /**
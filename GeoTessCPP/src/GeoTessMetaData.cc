@@ -35,6 +35,7 @@
 
 #include "GeoTessMetaData.h"
 #include "CpuTimer.h"
+#include "GeoTessPolygon.h"
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
 
@@ -51,7 +52,8 @@ GeoTessMetaData::GeoTessMetaData(const GeoTessMetaData& other)
 		  dataType(&GeoTessDataType::NONE), nAttributes(-1), attributeNames(NULL),
 		  attributeUnits(NULL), boolAttributeFilter(false), attributeFilterString(""),
 		  inputModelFile("none"), inputGridFile("none"), loadTimeModel(-1.0),
-		  outputModelFile("none"), outputGridFile("none"), writeTimeModel(-1.0), refCount(0),
+		  outputModelFile("none"), outputGridFile("none"), writeTimeModel(-1.0), compressed(false),
+		  lazyLoading(false), loadRegion(NULL), loadRegionHalo(2), refCount(0),
 		  reuseGrids(true), modelSoftwareVersion(""), modelGenerationDate("")
 {
 	if (nLayers > 0)
@@ -133,6 +135,11 @@ GeoTessMetaData& GeoTessMetaData::operator=(const GeoTessMetaData& other)
 	inputModelFile = other.inputModelFile;
 	inputGridFile = other.inputGridFile;
 	loadTimeModel = other.loadTimeModel;
+	loadProfile = other.loadProfile;
+	compressed = other.compressed;
+	quantization = other.quantization;
+	lazyLoading = other.lazyLoading;
+	setLoadRegion(other.loadRegion, other.loadRegionHalo);
 	outputModelFile = other.outputModelFile;
 	outputGridFile = other.outputGridFile;
 	writeTimeModel = other.writeTimeModel;
@@ -176,6 +183,23 @@ GeoTessMetaData::~GeoTessMetaData()
 		layerTessIds = NULL;
 	}
 	setEulerRotationAngles(NULL);
+	setLoadRegion(NULL);
+}
+
+void GeoTessMetaData::setLoadRegion(GeoTessPolygon* polygon, int halo)
+{
+	if (polygon != NULL)
+		polygon->addReference();
+
+	if (loadRegion != NULL)
+	{
+		loadRegion->removeReference();
+		if (loadRegion->isNotReferenced())
+			delete loadRegion;
+	}
+
+	loadRegion = polygon;
+	loadRegionHalo = halo < 0 ? 0 : halo;
 }
 
 bool GeoTessMetaData::operator==(const GeoTessMetaData& other)
@@ -589,6 +613,10 @@ string GeoTessMetaData::toString(const string& className, LONG_INT modelMemory,
 	<< "  " << modelGenerationDate << endl
 	<< "Model Load Time: " << CPPUtils::dtos(loadTimeModel, "%.3f sec") << endl;
 
+	for (int i = 0; i < (int) loadProfile.size(); ++i)
+		os << "  " << left << setw(18) << loadProfile[i].first + ":" << right
+		<< CPPUtils::dtos(loadProfile[i].second, "%.3f sec") << endl;
+
 	os << endl;
 
 	os << "Model memory: " << setw(6) << fixed << setprecision(2) << modelMemory/1024./1024. << " MB" << endl;
@@ -762,6 +790,11 @@ void GeoTessMetaData::writeMetaData(IFStreamBinary& output, const string& modelC
 
 	output.writeCharArray("GEOTESSMODEL", 12);
 
+	// compressed profiles are flagged in the properties, which were
+	// introduced in file format 3.
+	if (compressed && modelFileFormat < 3)
+		modelFileFormat = 3;
+
 	output.writeInt(modelFileFormat);
 
 	if (modelFileFormat >= 3)
@@ -774,6 +807,16 @@ void GeoTessMetaData::writeMetaData(IFStreamBinary& output, const string& modelC
 		// properties map and will be written out right here.
 		updateProperties();
 
+		if (compressed)
+		{
+			properties["profileCompression"] = "blocks";
+			ostringstream q;
+			q << setprecision(17);
+			for (int i = 0; i < nAttributes; ++i)
+				q << (i == 0 ? "" : "; ") << getQuantization(i);
+			properties["attributeQuantization"] = q.str();
+		}
+
 		output.writeInt(properties.size());
 		for (std::map<string, string>::iterator it=properties.begin(); it!=properties.end(); ++it)
 		{
@@ -1052,6 +1095,11 @@ void GeoTessMetaData::updateProperties()
 	properties["dataType"] = getDataType().toString();
 	properties["layerNames"] = getLayerNamesString();
 	properties["eulerRotationAngles"] = getEulerRotationAnglesString();
+
+	// compression only applies to binary files.  writeMetaData(IFStreamBinary&)
+	// adds these properties back when they are needed.
+	properties.erase("profileCompression");
+	properties.erase("attributeQuantization");
 }
 
 /**
@@ -1084,6 +1132,47 @@ void GeoTessMetaData::readProperties()
 		}
 	}
 
+	compressed = false;
+	quantization.clear();
+	it = properties.find("profileCompression");
+	if (it != properties.end())
+	{
+		if (it->second != "blocks")
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessMetaData::readProperties" << endl
+					<< "profileCompression = " << it->second << " is not supported by this version of GeoTessCPP ("
+					<< GeoTessUtils::getVersion() << ")." << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 6029);
+		}
+		compressed = true;
+
+		it = properties.find("attributeQuantization");
+		if (it != properties.end())
+		{
+			vector<string> tokens;
+			CPPUtils::tokenizeString(it->second, ";", tokens);
+			for (int i = 0; i < (int) tokens.size(); ++i)
+				quantization.push_back(CPPUtils::stod(CPPUtils::trim(tokens[i])));
+		}
+	}
+
+}
+
+void GeoTessMetaData::setQuantization(int attributeIndex, double precision)
+{
+	if (attributeIndex < 0 || attributeIndex >= nAttributes || !(precision >= 0.))
+	{
+		ostringstream os;
+		os << endl << "ERROR in GeoTessMetaData::setQuantization" << endl
+				<< "attributeIndex = " << attributeIndex << " (nAttributes = " << nAttributes
+				<< "), precision = " << precision << endl
+				<< "attributeIndex must be in range and precision must be >= 0." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 6030);
+	}
+	if ((int) quantization.size() < nAttributes)
+		quantization.resize(nAttributes, 0.);
+	quantization[attributeIndex] = precision;
 }
 
 } // end namespace geotess
@@ -50,7 +50,11 @@
 #include "GeoTessMetaData.h"
 #include "GeoTessProfile.h"
 #include "GeoTessProfileEmpty.h"
+#include "GeoTessProfileLazy.h"
+#include "GeoTessPolygon.h"
 #include "CpuTimer.h"
+#include "GeoTessParallel.h"
+#include "GeoTessCompression.h"
 #include "EarthShape.h"
 
 #include "GeoTessPosition.h"
@@ -65,18 +69,21 @@ namespace geotess
 // **** _STATIC INITIALIZATIONS_************************************************
 
 map<string, GeoTessGrid*> GeoTessModel::reuseGridMap;
+mutex GeoTessModel::reuseGridMutex;
 
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
 GeoTessModel::GeoTessModel()
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
 }
 
 GeoTessModel::GeoTessModel(const string& inputFile)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -85,7 +92,8 @@ GeoTessModel::GeoTessModel(const string& inputFile)
 }
 
 GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPath)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -94,7 +102,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPa
 }
 
 GeoTessModel::GeoTessModel(vector<int>& attributeFilter)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -102,7 +111,8 @@ GeoTessModel::GeoTessModel(vector<int>& attributeFilter)
 }
 
 GeoTessModel::GeoTessModel(const string& inputFile, vector<int>& attributeFilter)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -114,7 +124,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, vector<int>& attributeFilter
 
 GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPath,
 		vector<int>& attributeFilter)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -126,7 +137,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPa
 
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -134,7 +146,8 @@ GeoTessModel::GeoTessModel(const GeoTessOptimizationType* optimization)
 
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(const string& inputFile, const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -145,7 +158,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, const GeoTessOptimizationTyp
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPath,
 		const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -155,7 +169,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPa
 
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(vector<int>& attributeFilter, const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -164,7 +179,8 @@ GeoTessModel::GeoTessModel(vector<int>& attributeFilter, const GeoTessOptimizati
 
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(const string& inputFile, vector<int>& attributeFilter, const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -177,7 +193,8 @@ GeoTessModel::GeoTessModel(const string& inputFile, vector<int>& attributeFilter
 // DEPRECATED because GeoTessOptimizationType is always SPEED.
 GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPath,
 		vector<int>& attributeFilter, const GeoTessOptimizationType* optimization)
-: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+  lazyProfileData(NULL)
 {
 	metaData = new GeoTessMetaData();
 	metaData->addReference();
@@ -187,13 +204,15 @@ GeoTessModel::GeoTessModel(const string& inputFile, const string& relativeGridPa
 }
 
 GeoTessModel::GeoTessModel(const string& gridFileName, GeoTessMetaData* md)
-		: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+		: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+		  lazyProfileData(NULL)
 {
 	constructor(gridFileName, NULL, md);
 }
 
 GeoTessModel::GeoTessModel(GeoTessGrid* grd, GeoTessMetaData* md)
-		: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL)
+		: grid(NULL), profiles(NULL), metaData(NULL), pointMap(NULL),
+		  lazyProfileData(NULL)
 {
 	constructor("", grd, md);
 }
@@ -221,56 +240,41 @@ void GeoTessModel::constructor(const string& gridFileName, GeoTessGrid* grd, Geo
 		// called with gridFile name, not an actual grid object
 		if (metaData->isGridReuseOn())
 		{
-			// see if grid exists in reuse map
+			// see if grid exists in reuse map ... if not, create grid and add to map
 
 			string gridID = GeoTessGrid::getGridID(gridFileName);
-			map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(gridID);
-			if (it == reuseGridMap.end())
+			grid = acquireReuseGrid(gridID);
+			if (grid == NULL)
 			{
-				// map does not contain grid ... create grid and add to map
-
-				grid = new GeoTessGrid();
-				grid->loadGrid(gridFileName);
-				reuseGridMap[gridID] = grid;
+				GeoTessGrid* g = new GeoTessGrid();
+				g->loadGrid(gridFileName);
+				grid = registerReuseGrid(g, gridID, true);
 			}
-			else
-				// map contains grid ... assign it from map
-				grid = it->second;
 		}
 		else // reuse grids flag is not on ... create the grid and assign
 		{
 			grid = new GeoTessGrid();
 			grid->loadGrid(gridFileName);
+			grid->addReference();
 		}
 	}
 	else
 	{
-		// called with grid object, not a file name.
+		// called with grid object, not a file name.  If grid reuse is on and
+		// the map contains the grid, assign it from the map, otherwise use
+		// the supplied grid without adding it to the map.
+		grid = NULL;
 		if (metaData->isGridReuseOn())
-		{
-			// see if grid exists in reuse map
+			grid = acquireReuseGrid(grd->getGridID());
 
-			map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(grd->getGridID());
-			if (it == reuseGridMap.end())
-			{
-				// map does not contain grid ... set reference
-				grid = grd;
-			}
-			else
-			{
-				// map contains grid ... assign it from map
-				grid = it->second;
-			}
-		}
-		else // reuse grids flag is not on ... create the grid and assign
+		if (grid == NULL)
 		{
+			lock_guard<mutex> lock(reuseGridMutex);
 			grid = grd;
+			grid->addReference();
 		}
-
 	}
 
-	grid->addReference();
-
 	metaData->setNVertices(grid->getNVertices());
 
 	metaData->setInputGridFile(grid->getGridInputFile());
@@ -303,28 +307,8 @@ GeoTessModel::~GeoTessModel()
 
 	if (grid != NULL)
 	{
-		grid->removeReference();
-		if (grid->isNotReferenced())
-		{
-			// see if the grid is contained in the reuse map ... if it is identically
-			// (i.e. the grid id matches and the pointer match) then remove the grid
-			// from the map. It is possible that the grid id matches but that this was
-			// a different instance of grid created before the grid reuse flag
-			// (reuseGrids) was turned on or by using the constructor where a grid
-			// instance is passed in but it is different than the one stored in the
-			// reuse map (different instance but same grid). If that is true then
-			// simply delete this grid.
-
-			map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(
-					grid->getGridID());
-			if ((it != reuseGridMap.end()) && (it->second == grid))
-				reuseGridMap.erase(it);
-
-			// delete the grid
-
-			delete grid;
-			grid = NULL;
-		}
+		releaseGrid(grid);
+		grid = NULL;
 	}
 
 	// delete the metadata if it is no longer referenced
@@ -341,6 +325,60 @@ GeoTessModel::~GeoTessModel()
 
 }
 
+GeoTessGrid* GeoTessModel::acquireReuseGrid(const string& gridID)
+{
+	lock_guard<mutex> lock(reuseGridMutex);
+	map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(gridID);
+	if (it == reuseGridMap.end())
+		return NULL;
+	it->second->addReference();
+	return it->second;
+}
+
+GeoTessGrid* GeoTessModel::registerReuseGrid(GeoTessGrid* grid, const string& gridID,
+		bool reuse)
+{
+	lock_guard<mutex> lock(reuseGridMutex);
+	if (reuse)
+	{
+		map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(gridID);
+		if (it == reuseGridMap.end())
+			reuseGridMap[gridID] = grid;
+		else
+		{
+			// another thread loaded the same grid while this one was reading it.
+			delete grid;
+			grid = it->second;
+		}
+	}
+	grid->addReference();
+	return grid;
+}
+
+void GeoTessModel::releaseGrid(GeoTessGrid* grid)
+{
+	lock_guard<mutex> lock(reuseGridMutex);
+	grid->removeReference();
+	if (grid->isNotReferenced())
+	{
+		// see if the grid is contained in the reuse map ... if it is identically
+		// (i.e. the grid id matches and the pointer match) then remove the grid
+		// from the map. It is possible that the grid id matches but that this was
+		// a different instance of grid created before the grid reuse flag
+		// (reuseGrids) was turned on or by using the constructor where a grid
+		// instance is passed in but it is different than the one stored in the
+		// reuse map (different instance but same grid). If that is true then
+		// simply delete this grid.
+
+		map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(
+				grid->getGridID());
+		if ((it != reuseGridMap.end()) && (it->second == grid))
+			reuseGridMap.erase(it);
+
+		delete grid;
+	}
+}
+
 /**
  * Test a file to see if it is a GeoTessModel file.
  *
@@ -486,6 +524,124 @@ void GeoTessModel::deleteProfiles()
 		CPPUtils::delete2DArray<GeoTessProfile*>(profiles);
 		profiles = NULL;
 	}
+
+	if (lazyProfileData != NULL)
+	{
+		delete lazyProfileData;
+		lazyProfileData = NULL;
+	}
+}
+
+void GeoTessModel::applyLoadRegion()
+{
+	CpuTimer timer;
+	GeoTessPolygon* polygon = metaData->getLoadRegion();
+	int nVertices = grid->getNVertices();
+	int nLayers = metaData->getNLayers();
+
+	// find the vertices inside the polygon.  Every vertex outside the
+	// polygon's bounding cap is on the same side of the polygon boundary, so
+	// only vertices inside the cap are tested.
+
+	vector<char> keep(nVertices, 0);
+	double capCenter[3];
+	double capRadius = polygon->getBoundingCap(capCenter);
+	double cosCap = cos(capRadius);
+	bool useCap = capRadius < PI;
+	bool outsideCap = useCap && polygon->containsExterior();
+
+	GeoTessParallel::forEach(nVertices, 1024, [&](int first, int last, int)
+	{
+		const double* u;
+		for (int vertex = first; vertex < last; ++vertex)
+		{
+			u = grid->getVertex(vertex);
+			if (useCap && GeoTessUtils::dot(capCenter, u) < cosCap)
+				keep[vertex] = outsideCap;
+			else
+				keep[vertex] = polygon->contains(u);
+		}
+	});
+
+	// add rings of neighbors, connected by triangles on the top level of
+	// each tessellation used by the model, so that positions near the edge
+	// of the region can be interpolated.
+
+	set<int> tessIds(metaData->getLayerTessIds(), metaData->getLayerTessIds() + nLayers);
+	vector<char> ring;
+	const int* t;
+	for (int halo = 0; halo < metaData->getLoadRegionHalo(); ++halo)
+	{
+		ring = keep;
+		for (set<int>::iterator it = tessIds.begin(); it != tessIds.end(); ++it)
+		{
+			int level = grid->getTopLevel(*it);
+			int lastTriangle = grid->getLastTriangle(*it, level);
+			for (int triangle = grid->getFirstTriangle(*it, level); triangle <= lastTriangle; ++triangle)
+			{
+				t = grid->getTriangleVertexIndexes(triangle);
+				if (ring[t[0]] || ring[t[1]] || ring[t[2]])
+					keep[t[0]] = keep[t[1]] = keep[t[2]] = 1;
+			}
+		}
+	}
+
+	// replace the profiles of the other vertices with empty profiles.  When
+	// the region was requested without lazy loading, the profiles that are
+	// kept are decoded now and the encoded profiles are released.
+
+	bool lazy = metaData->isLazyLoading() || lazyProfileData == NULL;
+	GeoTessParallel::forEach(nVertices, 256, [&](int first, int last, int)
+	{
+		GeoTessProfile* p;
+		GeoTessProfileLazy* proxy;
+		for (int vertex = first; vertex < last; ++vertex)
+			for (int layer = 0; layer < nLayers; ++layer)
+			{
+				p = profiles[vertex][layer];
+				if (!keep[vertex])
+				{
+					if (p->getType() == GeoTessProfileType::SURFACE
+							|| p->getType() == GeoTessProfileType::SURFACE_EMPTY)
+						profiles[vertex][layer] = new GeoTessProfileSurfaceEmpty();
+					else
+						profiles[vertex][layer] = new GeoTessProfileEmpty(
+								p->getRadiusBottom(), p->getRadiusTop());
+					delete p;
+				}
+				else if (!lazy && (proxy = dynamic_cast<GeoTessProfileLazy*>(p)) != NULL)
+				{
+					profiles[vertex][layer] = proxy->release();
+					delete proxy;
+				}
+			}
+	});
+
+	if (!lazy)
+	{
+		delete lazyProfileData;
+		lazyProfileData = NULL;
+	}
+	else if (lazyProfileData != NULL)
+	{
+		// the encoded profiles of discarded vertices remain in the store;
+		// compact it so that it only holds the profiles that were kept.
+
+		IFStreamBinary* store = new IFStreamBinary(false);
+		store->setByteOrderReverse(lazyProfileData->isByteOrderReversalOn());
+		for (int vertex = 0; vertex < nVertices; ++vertex)
+			if (keep[vertex])
+				for (int layer = 0; layer < nLayers; ++layer)
+				{
+					GeoTessProfileLazy* proxy = dynamic_cast<GeoTessProfileLazy*>(profiles[vertex][layer]);
+					if (proxy != NULL)
+						proxy->moveTo(*store);
+				}
+		delete lazyProfileData;
+		lazyProfileData = store;
+	}
+
+	metaData->addLoadTime("region", timer.realTime() * 1e-3);
 }
 
 /**
@@ -530,6 +686,34 @@ GeoTessPosition* GeoTessModel::getPosition(const GeoTessInterpolatorType& horizo
 	}
 }
 
+/**
+ * Compute everything that is computed lazily during interpolation so that
+ * positions may subsequently be used concurrently.
+ */
+void GeoTessModel::prepareInterpolation(const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType)
+{
+	if (&horizontalType == &GeoTessInterpolatorType::NATURAL_NEIGHBOR)
+	{
+		grid->computeCircumCenters();
+		for (int level = 0; level < grid->getNLevels(); ++level)
+			grid->getSpokeList(level);
+	}
+
+	if (&radialType == &GeoTessInterpolatorType::CUBIC_SPLINE)
+	{
+		int nLayers = getNLayers();
+		GeoTessProfile*** p = profiles;
+		GeoTessParallel::forEach(getNVertices(), 256,
+				[&](int first, int last, int)
+		{
+			for (int vertex = first; vertex < last; ++vertex)
+				for (int layer = 0; layer < nLayers; ++layer)
+					p[vertex][layer]->prepareInterpolation(radialType);
+		});
+	}
+}
+
 /**
  * Return true if this and the input other model are equal. i.e., their grids have the same
  * gridIDs, they have the same number of layers, and all their Profiles are equal. For
@@ -780,10 +964,16 @@ GeoTessModel* GeoTessModel::loadModel(const string& inputFile,
 	else
 		loadModelBinary(inputFile, relGridFilePath);
 
-	metaData->setLoadTimeModel(timr.realTime() * 1e-3);
+	if (metaData->getLoadRegion() != NULL)
+		applyLoadRegion();
+
+	metaData->setLoadTimeModel(timr.realTimeInit() * 1e-3);
 
 	pointMap = new GeoTessPointMap(*this);
+	metaData->addLoadTime("point map", timr.realTimeInit() * 1e-3);
+
 	setActiveRegion();
+	metaData->addLoadTime("active region", timr.realTime() * 1e-3);
 
 	return this;
 }
@@ -862,16 +1052,67 @@ void GeoTessModel::loadModelAscii(const string& inputFile,
 void GeoTessModel::loadModelAscii(IFStreamAscii& input,
 		const string& inputDirectory, const string& relGridFilePath)
 {
+	CpuTimer timer;
+	metaData->clearLoadProfile();
+
 	metaData->loadMetaData(input);
+	metaData->addLoadTime("metadata", timer.realTimeInit() * 1e-3);
 
 	// loop over all the vertices of the 2D grid and load the data
 
+	int nVertices = metaData->getNVertices();
+	int nLayers = metaData->getNLayers();
+
 	deleteProfiles();
-	profiles = CPPUtils::new2DArray<GeoTessProfile*>(metaData->getNVertices(),
-			metaData->getNLayers());
-	for (int i = 0; i < metaData->getNVertices(); ++i)
-		for (int j = 0; j < metaData->getNLayers(); ++j)
-			profiles[i][j] = GeoTessProfile::newProfile(input, *metaData);
+	profiles = CPPUtils::new2DArray<GeoTessProfile*>(nVertices, nLayers);
+
+	if ((GeoTessParallel::getNThreads(nVertices, 1024) > 1) && input.isLineBoundary())
+	{
+		// profiles can only be parsed once the preceding profiles have been
+		// tokenized, so make a quick pass through the profile section that
+		// records where each chunk of 1024 vertices begins.  A chunk must
+		// begin at the start of a line; chunks that do not are merged with the
+		// previous chunk.  The chunks are then parsed concurrently, each with
+		// its own stream that reads the chunk's section of input.
+
+		vector<int> firstVertex;
+		vector<size_t> position;
+		vector<int> linesRead;
+		for (int i = 0; i < nVertices; ++i)
+		{
+			if ((i % 1024 == 0) && input.isLineBoundary())
+			{
+				firstVertex.push_back(i);
+				position.push_back(input.getPosition());
+				linesRead.push_back(input.getTotalLinesRead());
+			}
+			for (int j = 0; j < nLayers; ++j)
+				GeoTessProfile::skipProfile(input, *metaData);
+		}
+		firstVertex.push_back(nVertices);
+		position.push_back(input.getPosition());
+
+		GeoTessProfile*** p = profiles;
+		GeoTessMetaData& md = *metaData;
+		GeoTessParallel::forEach((int) firstVertex.size() - 1, 1,
+				[&](int first, int last, int)
+		{
+			for (int chunk = first; chunk < last; ++chunk)
+			{
+				IFStreamAscii section;
+				section.openForRead(input, position[chunk], position[chunk + 1],
+						linesRead[chunk]);
+				for (int i = firstVertex[chunk]; i < firstVertex[chunk + 1]; ++i)
+					for (int j = 0; j < nLayers; ++j)
+						p[i][j] = GeoTessProfile::newProfile(section, md);
+			}
+		});
+	}
+	else
+		for (int i = 0; i < nVertices; ++i)
+			for (int j = 0; j < nLayers; ++j)
+				profiles[i][j] = GeoTessProfile::newProfile(input, *metaData);
+	metaData->addLoadTime("profiles", timer.realTimeInit() * 1e-3);
 
 	string gridFileName;
 	input.readLine(gridFileName);
@@ -905,16 +1146,37 @@ void GeoTessModel::loadModelAscii(IFStreamAscii& input,
 void GeoTessModel::loadModelBinary(IFStreamBinary& input,
 		const string& inputDirectory, const string& relGridFilePath)
 {
+	CpuTimer timer;
+	metaData->clearLoadProfile();
+
 	metaData->loadMetaData(input);
+	metaData->addLoadTime("metadata", timer.realTimeInit() * 1e-3);
 
 	// loop over all the vertices of the 2D grid and load the data
 
 	deleteProfiles();
 	profiles = CPPUtils::new2DArray<GeoTessProfile*>(metaData->getNVertices(),
 			metaData->getNLayers());
-	for (int i = 0; i < metaData->getNVertices(); ++i)
-		for (int j = 0; j < metaData->getNLayers(); ++j)
-			profiles[i][j] = GeoTessProfile::newProfile(input, *metaData);
+	if (metaData->isCompressed())
+		GeoTessCompression::readProfiles(input, profiles, *metaData);
+	else if (metaData->isLazyLoading() || metaData->getLoadRegion() != NULL)
+	{
+		// keep the encoded profiles and decode each one when it is first used.
+		// If a region of interest was specified, profiles outside it are
+		// discarded by applyLoadRegion() without ever being decoded.
+
+		lazyProfileData = new IFStreamBinary(false);
+		lazyProfileData->setByteOrderReverse(input.isByteOrderReversalOn());
+		for (int i = 0; i < metaData->getNVertices(); ++i)
+			for (int j = 0; j < metaData->getNLayers(); ++j)
+				profiles[i][j] = GeoTessProfileLazy::newProfile(input, *metaData,
+						*lazyProfileData);
+	}
+	else
+		for (int i = 0; i < metaData->getNVertices(); ++i)
+			for (int j = 0; j < metaData->getNLayers(); ++j)
+				profiles[i][j] = GeoTessProfile::newProfile(input, *metaData);
+	metaData->addLoadTime("profiles", timer.realTimeInit() * 1e-3);
 
 	// read the name of the gridFile
 
@@ -998,13 +1260,17 @@ void GeoTessModel::writeModel(const string& outputFile,
 void GeoTessModel::writeModelBinary(const string& outputFile,
 		const string& gridFileName)
 {
+	// stream the model to the file in blocks rather than assembling the
+	// whole file in memory first
+
 	IFStreamBinary ofs;
+	ofs.openForWrite(outputFile);
 	if (!CPPUtils::isBigEndian())
 		ofs.byteOrderReverseOn();
 	ofs.boundaryAlignmentOff();
 
 	writeModelBinary(ofs, gridFileName);
-	ofs.writeToFile(outputFile);
+	ofs.close();
 }
 
 /**
@@ -1026,9 +1292,12 @@ void GeoTessModel::writeModelBinary(IFStreamBinary& output,
 {
 	metaData->writeMetaData(output, class_name(), grid->getNVertices());
 
-	for (int i = 0; i < grid->getNVertices(); ++i)
-		for (int j = 0; j < metaData->getNLayers(); ++j)
-			profiles[i][j]->write(output);
+	if (metaData->isCompressed())
+		GeoTessCompression::writeProfiles(output, profiles, *metaData);
+	else
+		for (int i = 0; i < grid->getNVertices(); ++i)
+			for (int j = 0; j < metaData->getNLayers(); ++j)
+				profiles[i][j]->write(output);
 
 	output.writeString(gridFileName);
 	output.writeString(grid->getGridID());
@@ -1117,11 +1386,18 @@ void GeoTessModel::getWeights(GeoTessGreatCircle& greatCircle, const double& poi
 
 	double u[3], r, delta = greatCircle.getDistance()/nIntervals;
 
+	// compute all the points along the path in one pass
+	vector<double> points(3*nIntervals);
+	double* x = &points[0];
+	double* y = x+nIntervals;
+	double* z = y+nIntervals;
+	greatCircle.getPoints(x, y, z, nIntervals, true);
+
 	GeoTessPosition* pos = getPosition(horizontalType, GeoTessInterpolatorType::LINEAR);
 
 	for (int i = 0; i < nIntervals; ++i)
 	{
-		greatCircle.getPoint((i+0.5)*delta, u);
+		u[0] = x[i]; u[1] = y[i]; u[2] = z[i];
 		r = radius > 0. ? radius : getEarthShape().getEarthRadius(u);
 		pos->set(0, u, r);
 		pos->getWeights(weights, delta*r);
@@ -1372,10 +1648,17 @@ double GeoTessModel::getPathIntegral2D(const int& attribute,
 
 	double u[3], r, integral=0., delta = greatCircle.getDistance()/nIntervals;
 
+	// compute all the points along the path in one pass
+	vector<double> points(3*nIntervals);
+	double* x = &points[0];
+	double* y = x+nIntervals;
+	double* z = y+nIntervals;
+	greatCircle.getPoints(x, y, z, nIntervals, true);
+
 	if (attribute < 0 && weights == NULL)
 		for (int i = 0; i < nIntervals; ++i)
 		{
-			greatCircle.getPoint((i+0.5)*delta, u);
+			u[0] = x[i]; u[1] = y[i]; u[2] = z[i];
 			r = earthRadius > 0. ? earthRadius : getEarthShape().getEarthRadius(u);
 			integral += delta*r;
 		}
@@ -1384,7 +1667,7 @@ double GeoTessModel::getPathIntegral2D(const int& attribute,
 		GeoTessPosition* pos = getPosition(horizontalType, GeoTessInterpolatorType::LINEAR);
 		for (int i = 0; i < nIntervals; ++i)
 		{
-			greatCircle.getPoint((i+0.5)*delta, u);
+			u[0] = x[i]; u[1] = y[i]; u[2] = z[i];
 			r = earthRadius > 0. ? earthRadius : getEarthShape().getEarthRadius(u);
 			pos->set(0, u, r);
 			integral += attribute < 0 ? delta*r : delta*r * pos->getValue(attribute);
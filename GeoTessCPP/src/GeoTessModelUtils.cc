@@ -33,6 +33,7 @@
 //-
 //- ****************************************************************************
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 
@@ -42,6 +43,7 @@
 #include "GeoTessModel.h"
 #include "GeoTessMetaData.h"
 #include "GeoTessPosition.h"
+#include "GeoTessParallel.h"
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
 
@@ -52,8 +54,26 @@ namespace geotess
 
 // **** _STATIC INITIALIZATIONS_************************************************
 
+const int GeoTessModelUtils::MAP_BAND;
+
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
+/**
+ * Copy a contiguous [nlat*nlon*nAttributes] map into a 3D vector.
+ */
+static void unflatten(const vector<double>& flat, int nlat, int nlon, int nAttributes,
+		vector<vector<vector<double> > >& values)
+{
+	vector<double>::const_iterator it = flat.begin();
+	values.resize(nlat);
+	for (int i = 0; i < nlat; ++i)
+	{
+		values[i].resize(nlon);
+		for (int j = 0; j < nlon; ++j, it += nAttributes)
+			values[i][j].assign(it, it + nAttributes);
+	}
+}
+
 /**
  * Evaluates maximum number of nodes per layer. On input, pointsPerLayer is an array of length
  * nLayers where each element contains a current estimate of the number of nodes that must be
@@ -94,6 +114,54 @@ int GeoTessModelUtils::updatePointsPerLayer(GeoTessPosition& pos, int firstLayer
 	return nTotal;
 }
 
+/**
+ * Evaluate f(pos, i, j) at every node of an nlat x nlon map, processing
+ * bands of MAP_BAND rows concurrently on separate GeoTessPosition objects.
+ * Rows within a band are traversed in serpentine order.
+ */
+template <typename F>
+void GeoTessModelUtils::forEachMapNode(GeoTessModel& model,
+		const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType,
+		const int& nlat, const int& nlon, F f)
+{
+	int nThreads = GeoTessParallel::getNThreads(nlat, MAP_BAND);
+
+	// lazily computed model state must exist before positions are shared
+	// among threads.
+	if (nThreads > 1)
+		model.prepareInterpolation(horizontalType, radialType);
+
+	vector<GeoTessPosition*> positions(nThreads, (GeoTessPosition*) NULL);
+	try
+	{
+		for (int t = 0; t < nThreads; ++t)
+			positions[t] = model.getPosition(horizontalType, radialType);
+
+		GeoTessParallel::forEach(nlat, MAP_BAND,
+				[&](int first, int last, int thread)
+		{
+			GeoTessPosition* pos = positions[thread];
+			for (int i = first; i < last; ++i)
+				if ((i - first) % 2 == 0)
+					for (int j = 0; j < nlon; ++j)
+						f(pos, i, j);
+				else
+					for (int j = nlon-1; j >= 0; --j)
+						f(pos, i, j);
+		});
+	}
+	catch (...)
+	{
+		for (int t = 0; t < nThreads; ++t)
+			delete positions[t];
+		throw;
+	}
+
+	for (int t = 0; t < nThreads; ++t)
+		delete positions[t];
+}
+
 /**
  * Retrieve a map of attribute values at a constant specified depth on a
  * regular latitude-longitude grid. For every point on the map, if the
@@ -112,37 +180,47 @@ int GeoTessModelUtils::updatePointsPerLayer(GeoTessPosition& pos, int firstLayer
  *            InterpolatorType.NATURAL_NEIGHBOR
  * @param reciprocal if false, return value; if true, return 1./value.
  * @param attributes index(es) of the attributes to interpolate.
- * @return double[nlat][nlon][nAttributes]
+ * @return double[nlat*nlon*nAttributes]
  * @throws GeoTessException
  */
 void GeoTessModelUtils::getMapValuesDepth(GeoTessModel& model,
 		vector<double>& latitudes, vector<double>& longitudes, int layerId,
 		double depth, const GeoTessInterpolatorType& horizontalType,
 		const GeoTessInterpolatorType& radialType, bool reciprocal,
-		vector<int>& attributes, vector<vector<vector<double> > >& values)
+		vector<int>& attributes, vector<double>& values)
 {
-	int nlat = latitudes.size();
 	int nlon = longitudes.size();
+	int nAttributes = attributes.size();
 
-	GeoTessPosition* pos = model.getPosition(horizontalType, radialType);
+	values.resize(latitudes.size() * nlon * nAttributes);
 
-	values.resize(nlat);
-	for (int i = 0; i < nlat; ++i)
+	forEachMapNode(model, horizontalType, radialType, latitudes.size(), nlon,
+			[&](GeoTessPosition* pos, int i, int j)
 	{
-		values[i].resize(nlon);
-		for (int j = 0; j < nlon; ++j)
-		{
-			values[i][j].resize(attributes.size());
-			pos->set(layerId, latitudes[i], longitudes[j], depth);
-			for (int k = 0; k < (int) attributes.size(); ++k)
-				values[i][j][k] =
-						reciprocal ?
-								1. / pos->getValue(attributes[k]) :
-								pos->getValue(attributes[k]);
-		}
-	}
+		double* v = &values[(i * nlon + j) * nAttributes];
+		pos->set(layerId, latitudes[i], longitudes[j], depth);
+		for (int k = 0; k < nAttributes; ++k)
+			v[k] = reciprocal ? 1. / pos->getValue(attributes[k]) : pos->getValue(attributes[k]);
+	});
+}
 
-	delete pos;
+/**
+ * Retrieve a map of attribute values at a constant specified depth on a
+ * regular latitude-longitude grid.
+ *
+ * @return double[nlat][nlon][nAttributes]
+ * @throws GeoTessException
+ */
+void GeoTessModelUtils::getMapValuesDepth(GeoTessModel& model,
+		vector<double>& latitudes, vector<double>& longitudes, int layerId,
+		double depth, const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType, bool reciprocal,
+		vector<int>& attributes, vector<vector<vector<double> > >& values)
+{
+	vector<double> flat;
+	getMapValuesDepth(model, latitudes, longitudes, layerId, depth, horizontalType,
+			radialType, reciprocal, attributes, flat);
+	unflatten(flat, latitudes.size(), longitudes.size(), attributes.size(), values);
 }
 
 /**
@@ -161,6 +239,36 @@ void GeoTessModelUtils::getMapValuesDepth(GeoTessModel& model,
  *            InterpolatorType.NATURAL_NEIGHBOR
  * @param reciprocal if false, return value; if true, return 1./value.
  * @param attributes index(es) of the attributes to interpolate.
+ * @return double[nlat*nlon*nAttributes]
+ * @throws GeoTessException
+ */
+void GeoTessModelUtils::getMapValuesLayer(GeoTessModel& model,
+		vector<double>& latitudes, vector<double>& longitudes, int layerId,
+		double fractionalRadius, const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType, bool reciprocal,
+		vector<int>& attributes, vector<double>& values)
+{
+	int nlon = longitudes.size();
+	int nAttributes = attributes.size();
+
+	values.resize(latitudes.size() * nlon * nAttributes);
+
+	forEachMapNode(model, horizontalType, radialType, latitudes.size(), nlon,
+			[&](GeoTessPosition* pos, int i, int j)
+	{
+		double* v = &values[(i * nlon + j) * nAttributes];
+		pos->set(layerId, latitudes[i], longitudes[j], 0.);
+		pos->setRadius(layerId,
+				pos->getRadiusBottom() + (fractionalRadius * pos->getLayerThickness()));
+		for (int k = 0; k < nAttributes; ++k)
+			v[k] = reciprocal ? 1. / pos->getValue(attributes[k]) : pos->getValue(attributes[k]);
+	});
+}
+
+/**
+ * Retrieve a map of attribute values at some fractional thickness with
+ * a layer.
+ *
  * @return double[nlat][nlon][nAttributes]
  * @throws GeoTessException
  */
@@ -170,32 +278,34 @@ void GeoTessModelUtils::getMapValuesLayer(GeoTessModel& model,
 		const GeoTessInterpolatorType& radialType, bool reciprocal,
 		vector<int>& attributes, vector<vector<vector<double> > >& values)
 {
-	int nlat = latitudes.size();
+	vector<double> flat;
+	getMapValuesLayer(model, latitudes, longitudes, layerId, fractionalRadius,
+			horizontalType, radialType, reciprocal, attributes, flat);
+	unflatten(flat, latitudes.size(), longitudes.size(), attributes.size(), values);
+}
+
+void GeoTessModelUtils::getMapLayerBoundary(GeoTessModel& model,
+		vector<double>& latitudes, vector<double>& longitudes, int layerId,
+		bool top, bool convertToDepth, const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType,
+		vector<double>& values)
+{
 	int nlon = longitudes.size();
 
-	GeoTessPosition* pos = model.getPosition(horizontalType, radialType);
+	values.resize(latitudes.size() * nlon);
 
-	values.resize(nlat);
-	for (int i = 0; i < nlat; ++i)
+	forEachMapNode(model, horizontalType, radialType, latitudes.size(), nlon,
+			[&](GeoTessPosition* pos, int i, int j)
 	{
-		values[i].resize(nlon);
-		for (int j = 0; j < nlon; ++j)
-		{
-			values[i][j].resize(attributes.size());
-			pos->set(layerId, latitudes[i], longitudes[j], 0.);
-			pos->setRadius(
-					layerId,
-					pos->getRadiusBottom()
-							+ (fractionalRadius * pos->getLayerThickness()));
-			for (int k = 0; k < (int) attributes.size(); ++k)
-				values[i][j][k] =
-						reciprocal ?
-								1. / pos->getValue(attributes[k]) :
-								pos->getValue(attributes[k]);
-		}
-	}
-
-	delete pos;
+		double u[3];
+		GeoTessUtils::getVectorDegrees(latitudes[i], longitudes[j], u);
+		if (top)
+			pos->setTop(layerId, u);
+		else
+			pos->setBottom(layerId, u);
+
+		values[i * nlon + j] = convertToDepth ? pos->getDepth() : pos->getRadius();
+	});
 }
 
 void GeoTessModelUtils::getMapLayerBoundary(GeoTessModel& model,
@@ -206,27 +316,14 @@ void GeoTessModelUtils::getMapLayerBoundary(GeoTessModel& model,
 {
 	int nlat = latitudes.size();
 	int nlon = longitudes.size();
-	double u[3];
-	values.resize(nlat);
 
-	GeoTessPosition* pos = model.getPosition(horizontalType, radialType);
+	vector<double> flat;
+	getMapLayerBoundary(model, latitudes, longitudes, layerId, top, convertToDepth,
+			horizontalType, radialType, flat);
 
+	values.resize(nlat);
 	for (int i = 0; i < nlat; ++i)
-	{
-		values[i].resize(nlon);
-		for (int j = 0; j < nlon; ++j)
-		{
-			GeoTessUtils::getVectorDegrees(latitudes[i], longitudes[j], u);
-			if (top)
-				pos->setTop(layerId, u);
-			else
-				pos->setBottom(layerId, u);
-
-			values[i][j] = convertToDepth ? pos->getDepth() : pos->getRadius();
-		}
-	}
-
-	delete pos;
+		values[i].assign(flat.begin() + i * nlon, flat.begin() + (i+1) * nlon);
 }
 
 /**
@@ -434,7 +531,7 @@ void GeoTessModelUtils::getBorehole(GeoTessPosition& pos, vector<int>& pointsPer
  * @param attributes
  *            index(es) of the attributes to interpolate. If omitted, all
  *            attributes are reported.
- * @return double[nx][nPoints][spatialCoordinates.length + nAttributes]. The
+ * @return double[nx*nPoints*(spatialCoordinates.length + nAttributes)]. The
  *         values of spatial cooridinates will be output first, followed
  *         attribute values. Points will be evenly spaced radially within
  *         each layer, with two points on each layer boundary, one
@@ -450,17 +547,19 @@ void GeoTessModelUtils::getSlice(GeoTessModel& model, const double* const x0, co
 		               int lastLayer, const GeoTessInterpolatorType& horizontalType,
 		               const GeoTessInterpolatorType& radialType,
 		               const string& spatialCoordinates, bool reciprocal,
-		               const vector<int>& attributes, vector<vector<vector<double> > >& transect)
+		               const vector<int>& attributes, vector<double>& transect,
+		               int& nPoints, int& nValues)
 {
 	int nLayers = model.getNLayers();
 
 	if (lastLayer >= nLayers) lastLayer = nLayers - 1;
 
-	vector<string> coordinates;
-	CPPUtils::tokenizeString(spatialCoordinates, ",", coordinates);
-
-	vector<int> pointsPerLayer;
-	pointsPerLayer.resize(nLayers, 0);
+	// parse the requested coordinates once.
+	vector<SliceCoordinate> coordinates;
+	bool cartesian = parseSliceCoordinates(spatialCoordinates, coordinates);
+	int nCoordinates = coordinates.size();
+	int nAttributes = attributes.size();
+	nValues = nCoordinates + nAttributes;
 
 	// delta is total distance in radians between x0 and x1
 	double delta = GeoTessUtils::angle(x0, x1);
@@ -477,104 +576,163 @@ void GeoTessModelUtils::getSlice(GeoTessModel& model, const double* const x0, co
 	double* greatCircle[2] = {&gcs[0], &gcs[3]};
 	GeoTessUtils::getGreatCircle(x0, x1, greatCircle);
 
+	// compute the nx points along the great circle once.
+	vector<double> points(3*nx);
+	double* px = &points[0];
+	double* py = px+nx;
+	double* pz = py+nx;
+	GeoTessUtils::getGreatCirclePoints(greatCircle, 0., dx, nx, px, py, pz);
+
 	double tf[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
 	double* transform[3] = {&tf[0], &tf[3], &tf[6]};
-	for (int i = 0; i < (int) coordinates.size(); ++i)
-	{
-		string s = CPPUtils::trim(CPPUtils::lowercase_string(coordinates[i]), " ");
-		if ((s == "x") || (s == "y") || (s == "z"))
-		{
-			GeoTessUtils::getTransform(x0, x1, transform);
-		}
-	}
-
-	// intantiate a GeoTessPosition object to use for interpolation.
-	GeoTessPosition* pos = model.getPosition(horizontalType, radialType);
+	if (cartesian)
+		GeoTessUtils::getTransform(x0, x1, transform);
 
-	double u[3], g[3], tloc[3];
-
-	// loop over points along great circle and figure out how many
-	// nodes are required in each layer so that (1) the number of
-	// nodes in a given layer will be constant along the slice, and
+	// figure out how many nodes are required in each layer so that (1) the
+	// number of nodes in a given layer will be constant along the slice, and
 	// (2) the radial node spacing in a given layer will not exceed
-	// maxSpacing.
-	for (int i = 0; i < nx; ++i)
+	// maxSpacing.  Each column records its own requirements, which are
+	// then combined.
+	vector<int> columnPoints(nx * nLayers, 0);
+	forEachMapNode(model, horizontalType, radialType, nx, 1,
+			[&](GeoTessPosition* pos, int i, int)
 	{
-		// find unit vector for current point.
-		GeoTessUtils::getGreatCirclePoint(greatCircle, i * dx, u);
-
-		// loop over the requested layers
+		double u[3] = {px[i], py[i], pz[i]};
+		vector<int> ppl(nLayers, 0);
 		for (int j = firstLayer; j <= lastLayer; ++j)
 		{
-			// set the interpolation point
 			pos->setTop(j, u);
-
-			// update pointsPerLayer
-			updatePointsPerLayer(*pos, j, j, maxRadialSpacing, pointsPerLayer);
+			updatePointsPerLayer(*pos, j, j, maxRadialSpacing, ppl);
 		}
-	}
+		std::copy(ppl.begin(), ppl.end(), columnPoints.begin() + i * nLayers);
+	});
 
-	vector<double> output;
-	int layerid = nLayers - 1;
-
-	// loop over all the points along the great circle and populate the
-	// data values.
+	vector<int> pointsPerLayer(nLayers, 0);
 	for (int i = 0; i < nx; ++i)
-	{
-		double distance = i * dx; // radians
+		for (int j = 0; j < nLayers; ++j)
+			if (columnPoints[i * nLayers + j] > pointsPerLayer[j])
+				pointsPerLayer[j] = columnPoints[i * nLayers + j];
 
-		// find unit vector for current point.
-		GeoTessUtils::getGreatCirclePoint(greatCircle, distance, u);
+	nPoints = 0;
+	for (int j = 0; j < nLayers; ++j)
+		if (pointsPerLayer[j] >= 2)
+			nPoints += pointsPerLayer[j];
 
-		// set the interpolation point
-		pos->setTop(layerid, u);
+	transect.resize(nx * nPoints * nValues);
 
-		// get borehole at this position. First element is radius,
-		// followed by attribute values.
-		getBorehole(*pos, pointsPerLayer, false, reciprocal, attributes, transect[i]);
+	// populate the columns.  Each column is a borehole from the bottom of
+	// firstLayer to the top of lastLayer.
+	forEachMapNode(model, horizontalType, radialType, nx, 1,
+			[&](GeoTessPosition* pos, int i, int)
+	{
+		double u[3] = {px[i], py[i], pz[i]};
+		double g[3] = {0., 0., 0.}, tloc[3];
+		double distance = CPPUtils::toDegrees(i * dx);
+		double* v = &transect[i * nPoints * nValues];
 
-		for (int j = 0; j < (int)transect[i].size(); ++j)
-		{
-			pos->setRadius(layerid, transect[i][j][0]);
+		pos->setTop(nLayers - 1, u);
 
-			// convert current position from unit vector to full vector
-			pos->copyVector(tloc);
-			for (int k = 0; k < 3; ++k)	tloc[k] *= pos->getRadius();
-			// apply transform to tloc and put resulting vector in g
-			GeoTessUtils::transform(tloc, transform, g);
+		for (int layer = 0; layer < nLayers; ++layer)
+		{
+			if (pointsPerLayer[layer] < 2)
+				continue;
 
-			for (int k = 0; k < (int) coordinates.size(); ++k)
+			double dr = pos->getLayerThickness(layer) / (pointsPerLayer[layer] - 1);
+			for (int p = 0; p < pointsPerLayer[layer]; ++p, v += nValues)
 			{
-				string coord = CPPUtils::trim(CPPUtils::lowercase_string(coordinates[i]), " ");
-				if (coord == "x")
-					output.push_back(g[0]);
-				else if (coord == "y")
-					output.push_back(g[1]);
-				else if (coord == "z")
-					output.push_back(g[2]);
-				else if (coord == "distance")
-					output.push_back(CPPUtils::toDegrees(distance));
-				else if (coord == "depth")
-					output.push_back(pos->getDepth());
-				else if (coord == "radius")
-					output.push_back(pos->getRadius());
-				else if (coord == "lat")
-					output.push_back(GeoTessUtils::getLatDegrees(pos->getVector()));
-				else if (coord == "lon")
-					output.push_back(GeoTessUtils::getLonDegrees(pos->getVector()));
-				else
-					output.push_back(NA_VALUE);
+				pos->setRadius(layer, p * dr + pos->getRadiusBottom(layer));
+				double radius = pos->getRadius();
+
+				if (cartesian)
+				{
+					// convert current position from unit vector to full vector
+					// and apply transform to tloc and put resulting vector in g
+					pos->copyVector(tloc);
+					for (int k = 0; k < 3; ++k) tloc[k] *= radius;
+					GeoTessUtils::transform(tloc, transform, g);
+				}
+
+				for (int k = 0; k < nCoordinates; ++k)
+					switch (coordinates[k])
+					{
+					case SLICE_X: v[k] = g[0]; break;
+					case SLICE_Y: v[k] = g[1]; break;
+					case SLICE_Z: v[k] = g[2]; break;
+					case SLICE_DISTANCE: v[k] = distance; break;
+					case SLICE_DEPTH: v[k] = pos->getDepth(); break;
+					case SLICE_RADIUS: v[k] = radius; break;
+					case SLICE_LAT: v[k] = GeoTessUtils::getLatDegrees(pos->getVector()); break;
+					case SLICE_LON: v[k] = GeoTessUtils::getLonDegrees(pos->getVector()); break;
+					default: v[k] = NA_VALUE;
+					}
+
+				for (int a = 0; a < nAttributes; ++a)
+					v[nCoordinates + a] = reciprocal ?
+							1.0 / pos->getValue(attributes[a]) : pos->getValue(attributes[a]);
 			}
-			for (int k = 1; k < (int) attributes.size() + 1; ++k)
-				output.push_back(transect[i][j][k]);
-
-			transect[i][j].clear();
-			for (int k=0; i< (int) output.size(); ++k)
-				transect[i][j].push_back(output[k]);
-			output.clear();
 		}
+	});
+}
 
+/**
+ * Retrieve attribute values interpolated on a vertical slice through a
+ * model.
+ *
+ * @return double[nx][nPoints][spatialCoordinates.length + nAttributes].
+ * @throws GeoTessException
+ */
+void GeoTessModelUtils::getSlice(GeoTessModel& model, const double* const x0, const double* const x1,
+		               int nx, double maxRadialSpacing, int firstLayer,
+		               int lastLayer, const GeoTessInterpolatorType& horizontalType,
+		               const GeoTessInterpolatorType& radialType,
+		               const string& spatialCoordinates, bool reciprocal,
+		               const vector<int>& attributes, vector<vector<vector<double> > >& transect)
+{
+	vector<double> flat;
+	int nPoints, nValues;
+	getSlice(model, x0, x1, nx, maxRadialSpacing, firstLayer, lastLayer, horizontalType,
+			radialType, spatialCoordinates, reciprocal, attributes, flat, nPoints, nValues);
+	unflatten(flat, nx, nPoints, nValues, transect);
+}
+
+/**
+ * Parse a comma delimited list of spatial coordinate names into a list of
+ * SliceCoordinates.  Returns true if any of them are x, y or z.
+ */
+bool GeoTessModelUtils::parseSliceCoordinates(const string& spatialCoordinates,
+		vector<SliceCoordinate>& coordinates)
+{
+	vector<string> tokens;
+	CPPUtils::tokenizeString(spatialCoordinates, ",", tokens);
+
+	bool cartesian = false;
+	coordinates.clear();
+	for (int i = 0; i < (int) tokens.size(); ++i)
+	{
+		string s = CPPUtils::trim(CPPUtils::lowercase_string(tokens[i]), " ");
+		if (s == "distance")
+			coordinates.push_back(SLICE_DISTANCE);
+		else if (s == "depth")
+			coordinates.push_back(SLICE_DEPTH);
+		else if (s == "radius")
+			coordinates.push_back(SLICE_RADIUS);
+		else if (s == "lat")
+			coordinates.push_back(SLICE_LAT);
+		else if (s == "lon")
+			coordinates.push_back(SLICE_LON);
+		else if (s == "x")
+			coordinates.push_back(SLICE_X);
+		else if (s == "y")
+			coordinates.push_back(SLICE_Y);
+		else if (s == "z")
+			coordinates.push_back(SLICE_Z);
+		else
+			coordinates.push_back(SLICE_UNKNOWN);
+
+		if (coordinates.back() >= SLICE_X && coordinates.back() <= SLICE_Z)
+			cartesian = true;
 	}
+	return cartesian;
 }
 
 } // end namespace geotess
@@ -36,6 +36,11 @@
 #include "GeoTessPointMap.h"
 #include "GeoTessModel.h"
 #include "GeoTessHorizon.h"
+#include "GeoTessDataArray.h"
+#include "GeoTessDataValue.h"
+#include "GeoTessParallel.h"
+
+#include <typeinfo>
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
 
@@ -46,6 +51,8 @@ namespace geotess
 
 // **** _STATIC INITIALIZATIONS_************************************************
 
+const int GeoTessPointMap::VERTEX_CHUNK;
+
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
 /**
@@ -54,28 +61,22 @@ namespace geotess
  */
 GeoTessPointMap::GeoTessPointMap(GeoTessModel& model)
 : grid(model.getGrid()), profiles(model.getProfiles()), metaData(model.getMetaData()),
-  polygon(NULL), populated(false)
+  generation(0), populated(false)
 {
 }
 
 GeoTessPointMap::GeoTessPointMap(GeoTessPointMap& other)
 : grid(other.grid), profiles(other.profiles), metaData(other.metaData),
-  polygon(other.polygon), populated(other.populated)
+  polygons(other.polygons), generation(0),
+  populated(other.populated)
 {
-	if (polygon != NULL)
-		polygon->addReference();
+	for (int i = 0; i < (int)polygons.size(); ++i)
+		polygons[i]->addReference();
 
 	if (populated)
 	{
-		vector<int> v3(3,0);
-		pointMap.resize(other.pointMap.size(), v3);
-
-		for (int i=0; i<(int)other.pointMap.size(); ++i)
-		{
-			pointMap[i][0] = other.pointMap[i][0];
-			pointMap[i][1] = other.pointMap[i][1];
-			pointMap[i][2] = other.pointMap[i][2];
-		}
+		pointMap = other.pointMap;
+		coverage = other.coverage;
 	}
 }
 
@@ -89,25 +90,27 @@ GeoTessPointMap& GeoTessPointMap::operator=(const GeoTessPointMap& other)
 	metaData = other.metaData;
 	profiles = other.profiles;
 
-	polygon = other.polygon;
-	polygon->addReference();
+	if (this == &other)
+		return *this;
+
+	releasePolygons();
+	polygons = other.polygons;
+	for (int i = 0; i < (int)polygons.size(); ++i)
+		polygons[i]->addReference();
 
 	populated = other.populated;
 
 	if (populated)
 	{
-		vector<int> v3(3,0);
-		pointMap.resize(other.pointMap.size(), v3);
-
-		for (int i=0; i<(int)other.pointMap.size(); ++i)
-		{
-			pointMap[i][0] = other.pointMap[i][0];
-			pointMap[i][1] = other.pointMap[i][1];
-			pointMap[i][2] = other.pointMap[i][2];
-		}
+		pointMap = other.pointMap;
+		coverage = other.coverage;
 	}
 	else
+	{
 		pointMap.clear();
+		coverage.clear();
+	}
+	pointMapChanged();
 
 	return *this;
 }
@@ -135,16 +138,7 @@ bool GeoTessPointMap::operator==(const GeoTessPointMap& other)
 	if (!populated)
 		setActiveRegion();
 
-	if (pointMap.size() != other.pointMap.size()) return false;
-
-	for (int i=0; i<(int)pointMap.size(); ++i)
-	{
-		if (pointMap[i][0] != other.pointMap[i][0]) return false;
-		if (pointMap[i][1] != other.pointMap[i][1]) return false;
-		if (pointMap[i][2] != other.pointMap[i][2]) return false;
-	}
-
-	return true;
+	return pointMap == other.pointMap;
 																								}
 
 GeoTessPointMap::~GeoTessPointMap()
@@ -155,15 +149,11 @@ GeoTessPointMap::~GeoTessPointMap()
 void GeoTessPointMap::clear()
 {
 	pointMap.clear();
+	coverage.clear();
 	populated = false;
+	pointMapChanged();
 
-	if (polygon != NULL)
-	{
-		polygon->removeReference();
-		if (polygon->isNotReferenced())
-			delete polygon;
-		polygon = NULL;
-	}
+	releasePolygons();
 
 	GeoTessProfile** pp;
 	for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
@@ -180,6 +170,17 @@ void GeoTessPointMap::setActiveRegion()
 
 	GeoTessProfile** pp;
 	GeoTessProfile* p;
+
+	// count the points so that pointMap is allocated exactly once.
+	LONG_INT nPoints = 0;
+	for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
+	{
+		pp = profiles[vertex];
+		for (int layer = 0; layer < metaData.getNLayers(); ++layer)
+			nPoints += pp[layer]->getNData();
+	}
+	pointMap.reserve(3*nPoints);
+
 	for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
 	{
 		pp = profiles[vertex];
@@ -187,91 +188,380 @@ void GeoTessPointMap::setActiveRegion()
 		{
 			p = pp[layer];
 			for (int node = 0; node < p->getNData(); ++node)
-			{
-				p->setPointIndex(node, (int)pointMap.size());
-				vector<int> v(3,0);
-				v[0] = vertex;
-				v[1] = layer;
-				v[2] = node;
-				pointMap.push_back(v);
-			}
+				addPoint(p, vertex, layer, node);
 		}
 	}
 	populated = true;
+	pointMapChanged();
+}
+
+void GeoTessPointMap::releasePolygons()
+{
+	for (int i = 0; i < (int)polygons.size(); ++i)
+	{
+		polygons[i]->removeReference();
+		if (polygons[i]->isNotReferenced())
+			delete polygons[i];
+	}
+	polygons.clear();
 }
 
-void GeoTessPointMap::setActiveRegion(GeoTessPolygon* _polygon)
+void GeoTessPointMap::setActiveRegion(GeoTessPolygon* polygon)
 {
+	// hold a reference so that clear() does not delete polygon if it is
+	// the polygon that currently defines the active region.
+	polygon->addReference();
 	clear();
+	addPolygon(polygon);
+	polygon->removeReference();
+	populated = true;
+}
+
+void GeoTessPointMap::addActiveRegion(GeoTessPolygon* polygon)
+{
+	if (!populated || polygons.empty())
+		setActiveRegion(polygon);
+	else
+		addPolygon(polygon);
+}
+
+void GeoTessPointMap::findVertices(GeoTessPolygon* polygon, vector<char>& inside,
+		vector<double>& radii, int& layerBottom, int& layerTop)
+{
+	int nVertices = grid.getNVertices();
+	inside.assign(nVertices, 0);
+	radii.clear();
+
+	layerBottom = 0;
+	layerTop = metaData.getNLayers()-1;
+
+	GeoTessPolygon3D* polygon3D = polygon->class_name() == "Polygon3D"
+			? (GeoTessPolygon3D*)polygon : NULL;
+	if (polygon3D != NULL)
+	{
+		radii.assign(2*nVertices, 0.);
+
+		int layer = polygon3D->getTop()->getLayerIndex();
+		if (layer >= 0 && layer < metaData.getNLayers())
+			layerTop = layer;
+
+		layer = polygon3D->getBottom()->getLayerIndex();
+		if (layer > 0)
+			layerBottom = layer;
+	}
+
+	// every vertex outside the polygon's bounding cap is on the same side
+	// of the polygon boundary, so only vertices inside the cap are tested.
+	double capCenter[3];
+	double capRadius = polygon->getBoundingCap(capCenter);
+	double cosCap = cos(capRadius);
+	bool useCap = capRadius < PI;
+	bool outsideCap = useCap && polygon->containsExterior();
+
+	GeoTessParallel::forEach(nVertices, VERTEX_CHUNK,
+			[&](int first, int last, int)
+	{
+		const double* u;
+		for (int vertex = first; vertex < last; ++vertex)
+		{
+			u = grid.getVertex(vertex);
+			if (useCap && GeoTessUtils::dot(capCenter, u) < cosCap)
+				inside[vertex] = outsideCap;
+			else
+				inside[vertex] = polygon->contains(u);
+
+			if (inside[vertex] && polygon3D != NULL)
+			{
+				radii[2*vertex] = polygon3D->getBottom()->getRadius(u, profiles[vertex]);
+				radii[2*vertex+1] = polygon3D->getTop()->getRadius(u, profiles[vertex]);
+			}
+		}
+	});
+}
 
-	polygon = _polygon;
+void GeoTessPointMap::addPolygon(GeoTessPolygon* polygon)
+{
 	polygon->addReference();
+	polygons.push_back(polygon);
+
+	vector<char> inside;
+	vector<double> radii;
+	int layerBottom, layerTop;
+	findVertices(polygon, inside, radii, layerBottom, layerTop);
+
+	bool is3D = !radii.empty();
 
 	GeoTessProfile** pp;
 	GeoTessProfile* p;
+	double rBottom = 0., rTop = 0., r;
+	int index;
 
-	if (polygon->class_name() == "Polygon")
-	{
-		for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
-			if (polygon->contains(grid.getVertex(vertex)))
+	// assign point indexes serially, in vertex, layer, node order, so that
+	// the result does not depend on the number of threads.
+	for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
+		if (inside[vertex])
+		{
+			pp = profiles[vertex];
+			if (is3D)
+			{
+				rBottom = radii[2*vertex];
+				rTop = radii[2*vertex+1];
+			}
+
+			for (int layer = layerBottom; layer <= layerTop; ++layer)
 			{
-				pp = profiles[vertex];
-				for (int layer = 0; layer < metaData.getNLayers(); ++layer)
+				p = pp[layer];
+				for (int node = 0; node < p->getNData(); ++node)
 				{
-					p = pp[layer];
-					for (int node = 0; node < p->getNData(); ++node)
+					if (is3D)
 					{
-						p->setPointIndex(node, (int)pointMap.size());
-						vector<int> v(3,0);
-						v[0] = vertex;
-						v[1] = layer;
-						v[2] = node;
-						pointMap.push_back(v);
+						r = p->getRadius(node);
+						if (r < rBottom || r > rTop)
+							continue;
 					}
+
+					index = p->getPointIndex(node);
+					if (index < 0)
+					{
+						addPoint(p, vertex, layer, node);
+						coverage.push_back(1);
+					}
+					else
+						++coverage[index];
 				}
 			}
+		}
 
-	}
-	else
-	{
-		GeoTessHorizon* top = ((GeoTessPolygon3D*)polygon)->getTop();
-		GeoTessHorizon* bottom = ((GeoTessPolygon3D*)polygon)->getBottom();
+	pointMapChanged();
+}
 
-		double rTop, rBottom;
+void GeoTessPointMap::removeActiveRegion(GeoTessPolygon* polygon)
+{
+	int which = -1;
+	for (int i = 0; i < (int)polygons.size(); ++i)
+		if (polygons[i] == polygon)
+		{
+			which = i;
+			break;
+		}
 
-		int layerTop = top->getLayerIndex();
-		if (layerTop < 0 || layerTop >= metaData.getNLayers())
-			layerTop = metaData.getNLayers()-1;
+	if (which < 0)
+	{
+		ostringstream os;
+		os << endl << "ERROR in PointMap::removeActiveRegion" << endl
+				<< "The specified polygon does not define part of the active region." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 8004);
+	}
 
-		int layerBottom = bottom->getLayerIndex();
-		if (layerBottom < 0)
-			layerBottom = 0;
+	if (polygons.size() == 1)
+	{
+		clear();
+		return;
+	}
 
-		for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
-			if (polygon->contains(grid.getVertex(vertex)))
-			{
-				pp = profiles[vertex];
+	// decrement the coverage of every point contained in polygon.  The
+	// nodes are found exactly as they were when the polygon was added.
+	vector<char> inside;
+	vector<double> radii;
+	int layerBottom, layerTop;
+	findVertices(polygon, inside, radii, layerBottom, layerTop);
 
-				rBottom = bottom->getRadius(grid.getVertex(vertex), profiles[vertex]);
-				rTop = top->getRadius(grid.getVertex(vertex), profiles[vertex]);
+	bool is3D = !radii.empty();
 
-				for (int layer = layerBottom; layer <= layerTop; ++layer)
+	GeoTessProfile* p;
+	double r;
+	int index;
+	for (int vertex = 0; vertex < grid.getNVertices(); ++vertex)
+		if (inside[vertex])
+			for (int layer = layerBottom; layer <= layerTop; ++layer)
+			{
+				p = profiles[vertex][layer];
+				for (int node = 0; node < p->getNData(); ++node)
 				{
-					p = pp[layer];
-					for (int node = 0; node < p->getNData(); ++node)
-						if (p->getRadius(node) >= rBottom && p->getRadius(node) <= rTop)
-						{
-							p->setPointIndex(node, (int)pointMap.size());
-							vector<int> v(3,0);
-							v[0] = vertex;
-							v[1] = layer;
-							v[2] = node;
-							pointMap.push_back(v);
-						}
+					if (is3D)
+					{
+						r = p->getRadius(node);
+						if (r < radii[2*vertex] || r > radii[2*vertex+1])
+							continue;
+					}
+					index = p->getPointIndex(node);
+					if (index >= 0)
+						--coverage[index];
 				}
 			}
+
+	// compact pointMap and coverage, renumbering the points that remain.
+	int n = 0;
+	int* map;
+	for (int i = 0; i < size(); ++i)
+	{
+		map = &pointMap[3*i];
+		p = profiles[map[0]][map[1]];
+		if (coverage[i] > 0)
+		{
+			p->setPointIndex(map[2], n);
+			coverage[n] = coverage[i];
+			pointMap[3*n] = map[0];
+			pointMap[3*n+1] = map[1];
+			pointMap[3*n+2] = map[2];
+			++n;
+		}
+		else
+			p->setPointIndex(map[2], -1);
+	}
+	pointMap.resize(3*n);
+	coverage.resize(n);
+
+	polygons.erase(polygons.begin()+which);
+	polygon->removeReference();
+	if (polygon->isNotReferenced())
+		delete polygon;
+
+	pointMapChanged();
+}
+
+void GeoTessPointMap::checkPointRange(const string& method, int attributeIndex,
+		int firstPoint, int lastPoint)
+{
+	if (attributeIndex < 0 || attributeIndex >= metaData.getNAttributes())
+	{
+		ostringstream os;
+		os << endl << "ERROR in PointMap::" << method << endl
+				<< "attributeIndex " << attributeIndex << " is out of range [0, "
+				<< metaData.getNAttributes() << ")" << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 8002);
+	}
+
+	if (firstPoint < 0 || lastPoint > size() || firstPoint > lastPoint)
+	{
+		ostringstream os;
+		os << endl << "ERROR in PointMap::" << method << endl
+				<< "point range [" << firstPoint << ", " << lastPoint
+				<< ") is invalid.  PointMap has " << size() << " points." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 8003);
+	}
+}
+
+template <typename T>
+void GeoTessPointMap::copyPointValues(int attributeIndex, double* values,
+		int firstPoint, int lastPoint)
+{
+	// consecutive points usually belong to the same profile so only look up
+	// the profile when the vertex or layer changes.
+	GeoTessProfile* p = NULL;
+	GeoTessData* d;
+	int vertex = -1, layer = -1;
+	const int* map = pointMap.empty() ? NULL : &pointMap[3*firstPoint];
+	for (int i = firstPoint; i < lastPoint; ++i, map += 3)
+	{
+		if (map[0] != vertex || map[1] != layer)
+		{
+			vertex = map[0];
+			layer = map[1];
+			p = profiles[vertex][layer];
+		}
+		d = p->getData(map[2]);
+
+		// only take the direct path when the concrete type is known exactly.
+		const type_info& type = typeid(*d);
+		if (type == typeid(GeoTessDataArray<T>))
+			*values++ = (double) static_cast<GeoTessDataArray<T>*>(d)->getValuesArray()[attributeIndex];
+		else if (type == typeid(GeoTessDataValue<T>))
+			*values++ = (double) static_cast<GeoTessDataValue<T>*>(d)->getValuesArray()[attributeIndex];
+		else
+			*values++ = d->getDouble(attributeIndex);
+	}
+}
+
+template <typename T>
+void GeoTessPointMap::copyPointValues(int attributeIndex, const double* values,
+		int firstPoint, int lastPoint)
+{
+	GeoTessProfile* p = NULL;
+	GeoTessData* d;
+	int vertex = -1, layer = -1;
+	const int* map = pointMap.empty() ? NULL : &pointMap[3*firstPoint];
+	for (int i = firstPoint; i < lastPoint; ++i, map += 3)
+	{
+		if (map[0] != vertex || map[1] != layer)
+		{
+			vertex = map[0];
+			layer = map[1];
+			p = profiles[vertex][layer];
+		}
+		d = p->getData(map[2]);
+
+		const type_info& type = typeid(*d);
+		if (type == typeid(GeoTessDataArray<T>))
+			static_cast<GeoTessDataArray<T>*>(d)->getValuesArray()[attributeIndex] = (T) *values++;
+		else if (type == typeid(GeoTessDataValue<T>))
+			static_cast<GeoTessDataValue<T>*>(d)->getValuesArray()[attributeIndex] = (T) *values++;
+		else
+			d->setValue(attributeIndex, *values++);
+	}
+}
+
+void GeoTessPointMap::getPointValues(int attributeIndex, double* values,
+		int firstPoint, int lastPoint)
+{
+	checkPointRange("getPointValues", attributeIndex, firstPoint, lastPoint);
+
+	switch (metaData.getDataType().ordinal())
+	{
+	case 0 : // DOUBLE
+		copyPointValues<double>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 1 : // FLOAT
+		copyPointValues<float>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 2 : // LONG
+		copyPointValues<LONG_INT>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 3 : // INT
+		copyPointValues<int>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 4 : // SHORT
+		copyPointValues<short>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 5 : // BYTE
+		copyPointValues<byte>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	default :
+		// unrecognized DataType; fall back on the virtual accessors.
+		for (int i = firstPoint; i < lastPoint; ++i)
+			*values++ = getPointValueDouble(i, attributeIndex);
+	}
+}
+
+void GeoTessPointMap::setPointValues(int attributeIndex, const double* values,
+		int firstPoint, int lastPoint)
+{
+	checkPointRange("setPointValues", attributeIndex, firstPoint, lastPoint);
+
+	switch (metaData.getDataType().ordinal())
+	{
+	case 0 : // DOUBLE
+		copyPointValues<double>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 1 : // FLOAT
+		copyPointValues<float>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 2 : // LONG
+		copyPointValues<LONG_INT>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 3 : // INT
+		copyPointValues<int>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 4 : // SHORT
+		copyPointValues<short>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	case 5 : // BYTE
+		copyPointValues<byte>(attributeIndex, values, firstPoint, lastPoint);
+		break;
+	default :
+		for (int i = firstPoint; i < lastPoint; ++i)
+			setPointValue(i, attributeIndex, *values++);
 	}
-	populated = true;
 }
 
 /**
@@ -305,9 +595,9 @@ void GeoTessPointMap::getPointNeighbors(set<int>& pointNeighbors, int pointIndex
 {
 	// find the vertexID, layerID and nodeID of point in question
 
-	int vertex = pointMap[pointIndex][0];
-	int layer = pointMap[pointIndex][1];
-	int node = pointMap[pointIndex][2];
+	int vertex = pointMap[3*pointIndex];
+	int layer = pointMap[3*pointIndex+1];
+	int node = pointMap[3*pointIndex+2];
 
 	// find the tessID, levelID and radius of point in question
 	int tessid = metaData.getTessellation(layer);
@@ -58,7 +58,8 @@ double GeoTessPolygon::TOLERANCE = 1e-7;
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
 GeoTessPolygon::GeoTessPolygon()
-: referencePoint(NULL), referenceIn(true), global(true), lonFirst(false), refCount(0), attachment(NULL)
+: referencePoint(NULL), referenceIn(true), global(true), lonFirst(false), capRadius(PI),
+  refCount(0), attachment(NULL)
 {
 	referencePoint = new double[3];
 	referencePoint[0] = 1.;
@@ -67,13 +68,15 @@ GeoTessPolygon::GeoTessPolygon()
 }
 
 GeoTessPolygon::GeoTessPolygon(vector<double*>& points)
-: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), refCount(0), attachment(NULL)
+: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), capRadius(PI),
+  refCount(0), attachment(NULL)
 {
 	setup(points);
 }
 
 GeoTessPolygon::GeoTessPolygon(const double* center, double radius, int nEdges)
-: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), refCount(0), attachment(NULL)
+: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), capRadius(PI),
+  refCount(0), attachment(NULL)
 {
 	vector<double*> points;
 	points.reserve((size_t)nEdges);
@@ -105,7 +108,8 @@ GeoTessPolygon::GeoTessPolygon(const double* center, double radius, int nEdges)
 }
 
 GeoTessPolygon::GeoTessPolygon(string inputFileName)
-: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), refCount(0), attachment(NULL)
+: referencePoint(NULL), referenceIn(false), global(false), lonFirst(false), capRadius(PI),
+  refCount(0), attachment(NULL)
 {
 	if (inputFileName.find(".kmz", inputFileName.length() - 4) != string::npos
 			|| inputFileName.find(".kml", inputFileName.length() - 4) != string::npos)
@@ -378,6 +382,95 @@ void GeoTessPolygon::setup(vector<double*>& points)
 		}
 	}
 
+	computeBoundingCap();
+}
+
+void GeoTessPolygon::computeBoundingCap()
+{
+	capRadius = PI;
+
+	vector<double*> points;
+	points.reserve(edges.size());
+	for (int i=0; i<(int)edges.size(); ++i)
+		points.push_back(edges[i]->getFirst());
+
+	GeoTessUtils::center(points, capCenter);
+	if (capCenter[0] == 0. && capCenter[1] == 0. && capCenter[2] == 0.)
+		return;
+
+	// find the smallest value of dot(capCenter, p) for all points p on the
+	// boundary.  Along an edge, p(t) = cos(t)*first + sin(t)*tangent, where
+	// tangent = normal x first, so dot(capCenter, p(t)) = a*cos(t) + b*sin(t).
+	// The minimum of that function is -sqrt(a^2 + b^2) at t = atan2(-b, -a).
+	// If that angle lies beyond the end of the edge, the minimum is at one
+	// of the edge's end points.
+	double minDot = 1., a, b, t, tangent[3];
+	for (int i=0; i<(int)edges.size(); ++i)
+	{
+		GeoTessGreatCircle* edge = edges[i];
+		GeoTessUtils::cross(edge->getNormal(), edge->getFirst(), tangent);
+
+		a = GeoTessUtils::dot(capCenter, edge->getFirst());
+		b = GeoTessUtils::dot(capCenter, tangent);
+
+		t = atan2(-b, -a);
+		if (t < 0.) t += 2*PI;
+
+		// getDistance() is evaluated lazily.  Calling it here, once, also
+		// ensures that contains() does not modify the edges, so polygons
+		// can be shared by multiple threads.
+		if (t <= edge->getDistance())
+			a = -sqrt(a*a + b*b);
+		else
+			a = min(a, GeoTessUtils::dot(capCenter, edge->getLast()));
+
+		if (a < minDot) minDot = a;
+	}
+
+	// pad the cap so that points within TOLERANCE of the boundary,
+	// which contains() considers to be on the boundary, are inside the cap.
+	capRadius = acos(max(-1., min(1., minDot))) + 4*TOLERANCE;
+	if (capRadius > PI - 1e-3)
+		capRadius = PI;
+}
+
+void GeoTessPolygon::buildIndex(int depth)
+{
+	if (global)
+		return;
+
+	// build into a temporary so that contains() does not consult a
+	// partially built index.
+	index.clear();
+	GeoTessPolygonIndex idx;
+	idx.build(*this, edges, depth);
+	index = idx;
+}
+
+bool GeoTessPolygon::containsExterior()
+{
+	// test a point halfway between the edge of the cap and the anti-pode of
+	// capCenter.  The anti-pode itself is avoided because, for polygons
+	// whose referencePoint is capCenter, it is the one point for which
+	// contains() cannot construct a great circle from the reference point.
+	double delta = 0.5*(PI - capRadius);
+
+	double axis[3] = { 0., 0., 0. }, w[3];
+	axis[abs(capCenter[0]) < 0.5 ? 0 : 2] = 1.;
+	GeoTessUtils::cross(capCenter, axis, w);
+	GeoTessUtils::normalize(w);
+
+	double x[3];
+	for (int i=0; i<3; ++i)
+		x[i] = -cos(delta)*capCenter[i] + sin(delta)*w[i];
+
+	// if x happens to be close to the anti-pode of referencePoint,
+	// use the point on the opposite side of the anti-pode of capCenter.
+	if (GeoTessUtils::dot(x, referencePoint) < -cos(0.5*delta))
+		for (int i=0; i<3; ++i)
+			x[i] -= 2*sin(delta)*w[i];
+
+	return contains(x);
 }
 
 /**
@@ -0,0 +1,300 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#include "GeoTessPolygonIndex.h"
+#include "GeoTessPolygon.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess {
+
+// **** _EXPLICIT TEMPLATE INSTANTIATIONS_ *************************************
+
+// **** _STATIC INITIALIZATIONS_************************************************
+
+// **** _FUNCTION IMPLEMENTATIONS_ *********************************************
+
+void GeoTessPolygonIndex::toFace(const double* x, int& f, double& u, double& v)
+{
+	f = 0;
+	if (abs(x[1]) > abs(x[f])) f = 1;
+	if (abs(x[2]) > abs(x[f])) f = 2;
+
+	double a = abs(x[f]);
+	u = x[(f+1)%3]/a;
+	v = x[(f+2)%3]/a;
+
+	if (x[f] < 0.) f += 3;
+}
+
+void GeoTessPolygonIndex::fromFace(const int& f, const double& u, const double& v, double* x)
+{
+	int k = f%3;
+	x[k] = f < 3 ? 1. : -1.;
+	x[(k+1)%3] = u;
+	x[(k+2)%3] = v;
+	GeoTessUtils::normalize(x);
+}
+
+bool GeoTessPolygonIndex::near(GeoTessGreatCircle* edge, const double* x, const double& radius)
+{
+	// distance from x to the great circle that contains edge.
+	const double* normal = edge->getNormal();
+	double s = GeoTessUtils::dot(x, normal);
+	if (abs(s) > sin(radius))
+		return false;
+
+	// if the point on the great circle closest to x lies within the edge,
+	// then the edge is near x.
+	double p[3], tangent[3];
+	p[0] = x[0] - s*normal[0];
+	p[1] = x[1] - s*normal[1];
+	p[2] = x[2] - s*normal[2];
+	GeoTessUtils::cross(normal, edge->getFirst(), tangent);
+
+	double t = atan2(GeoTessUtils::dot(p, tangent), GeoTessUtils::dot(p, edge->getFirst()));
+	if (t < 0.) t += 2*PI;
+	if (t <= edge->getDistance())
+		return true;
+
+	// otherwise, the closest points of the edge are its end points.
+	double c = cos(radius);
+	return GeoTessUtils::dot(x, edge->getFirst()) >= c
+			|| GeoTessUtils::dot(x, edge->getLast()) >= c;
+}
+
+bool GeoTessPolygonIndex::nearBoundary(const vector<GeoTessGreatCircle*>& edges,
+		const int* list, const int& n, const double* x)
+{
+	double tolerance = 10*GeoTessPolygon::getTolerance();
+	for (int i = 0; i < n; ++i)
+		if (near(edges[list[i]], x, tolerance))
+			return true;
+	return false;
+}
+
+int GeoTessPolygonIndex::classify(const vector<GeoTessGreatCircle*>& edges,
+		const int* list, const int& n, const double* ref, const int& refStatus,
+		const double* x)
+{
+	if (refStatus < 0)
+		return -1;
+
+	double tolerance = GeoTessPolygon::getTolerance();
+	double cosTol = cos(tolerance), sinTol = sin(tolerance);
+
+	// reference points are never within 10*tolerance of the boundary.
+	if (GeoTessUtils::dot(ref, x) > cosTol)
+		return refStatus;
+
+	double normal[3];
+	GeoTessUtils::crossNormal(ref, x, normal);
+
+	// count the edges that cross the arc from ref to x.  Arcs ab and cd
+	// cross if c and d are on opposite sides of ab, a and b are on opposite
+	// sides of cd, and the two arcs are not on opposite sides of the sphere.
+	double sc, sd, ta, tb;
+	GeoTessGreatCircle* edge;
+	int crossings = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		edge = edges[list[i]];
+
+		// x is very close to a polygon vertex, which contains() defines
+		// to be inside the polygon.
+		if (GeoTessUtils::dot(x, edge->getFirst()) >= cosTol
+				|| GeoTessUtils::dot(x, edge->getLast()) >= cosTol)
+			return 1;
+
+		sc = GeoTessUtils::dot(edge->getFirst(), normal);
+		sd = GeoTessUtils::dot(edge->getLast(), normal);
+		ta = GeoTessUtils::dot(ref, edge->getNormal());
+		tb = GeoTessUtils::dot(x, edge->getNormal());
+
+		if (abs(sc) <= sinTol) sc = 0.;
+		if (abs(sd) <= sinTol) sd = 0.;
+		if (abs(ta) <= sinTol) ta = 0.;
+		if (abs(tb) <= sinTol) tb = 0.;
+
+		if (sc*sd > 0. || ta*tb > 0.)
+			continue;
+
+		// a vertex on the arc, or x on the edge.  Can't decide robustly.
+		if (sc == 0. || sd == 0. || ta == 0. || tb == 0.)
+			return -1;
+
+		if (sd*ta > 0.)
+			++crossings;
+	}
+	return crossings % 2 == 0 ? refStatus : 1 - refStatus;
+}
+
+void GeoTessPolygonIndex::build(GeoTessPolygon& polygon, const vector<GeoTessGreatCircle*>& edges,
+		const int& _depth)
+{
+	if (_depth < 0 || _depth > 14)
+	{
+		ostringstream os;
+		os << endl << "ERROR in GeoTessPolygonIndex::build" << endl
+				<< "depth = " << _depth << " but must be in range [0, 14]" << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 10006);
+	}
+
+	clear();
+	depth = _depth;
+
+	// the 6 faces of the cube map are cells 0 through 5.
+	child.assign(6, -1);
+	status.assign(6, -1);
+	reference.assign(18, 0.);
+	edgeFirst.assign(6, 0);
+	edgeCount.assign(6, 0);
+
+	vector<int> all(edges.size());
+	for (int i = 0; i < (int)edges.size(); ++i)
+		all[i] = i;
+
+	for (int f = 0; f < 6; ++f)
+		buildCell(polygon, edges, f, f, 0, 0, 0, all, NULL, -1);
+}
+
+void GeoTessPolygonIndex::buildCell(GeoTessPolygon& polygon, const vector<GeoTessGreatCircle*>& edges,
+		const int& node, const int& f, const int& level, const int& i, const int& j,
+		const vector<int>& parentEdges, const double* parentRef, const int& parentStatus)
+{
+	double du = 2./(1 << level);
+	double u0 = -1. + i*du, v0 = -1. + j*du;
+
+	// the cell is enclosed by a cap centered on the center of the cell
+	// that extends to the farthest corner.
+	double center[3], corners[4][3], radius = 0.;
+	fromFace(f, u0+0.5*du, v0+0.5*du, center);
+	for (int k = 0; k < 4; ++k)
+	{
+		fromFace(f, u0+(k/2)*du, v0+(k%2)*du, corners[k]);
+		radius = max(radius, GeoTessUtils::angle(center, corners[k]));
+	}
+	radius += 10*GeoTessPolygon::getTolerance();
+
+	vector<int> cellEdges;
+	for (int k = 0; k < (int)parentEdges.size(); ++k)
+		if (near(edges[parentEdges[k]], center, radius))
+			cellEdges.push_back(parentEdges[k]);
+
+	// find a reference point that is not near the boundary and establish
+	// its status, from the parent's reference point if possible.  Try the
+	// center of the cell first, then points between the center and each
+	// corner.
+	double ref[3];
+	int refStatus = -1;
+	for (int k = -1; k < 4 && refStatus < 0; ++k)
+	{
+		if (k < 0)
+		{
+			ref[0] = center[0]; ref[1] = center[1]; ref[2] = center[2];
+		}
+		else
+		{
+			for (int m = 0; m < 3; ++m)
+				ref[m] = 0.7*center[m] + 0.3*corners[k][m];
+			GeoTessUtils::normalize(ref);
+		}
+
+		if (!cellEdges.empty() && nearBoundary(edges, &cellEdges[0], (int)cellEdges.size(), ref))
+			continue;
+
+		if (parentStatus >= 0)
+			refStatus = classify(edges, parentEdges.empty() ? NULL : &parentEdges[0],
+					(int)parentEdges.size(), parentRef, parentStatus, ref);
+
+		if (refStatus < 0)
+			refStatus = polygon.contains(ref) ? 1 : 0;
+	}
+
+	status[node] = (signed char)refStatus;
+	reference[3*node] = ref[0];
+	reference[3*node+1] = ref[1];
+	reference[3*node+2] = ref[2];
+
+	if (cellEdges.empty() || level == depth)
+	{
+		edgeFirst[node] = (int)edgeList.size();
+		edgeCount[node] = (int)cellEdges.size();
+		edgeList.insert(edgeList.end(), cellEdges.begin(), cellEdges.end());
+		return;
+	}
+
+	int first = (int)child.size();
+	child[node] = first;
+	child.resize(first+4, -1);
+	status.resize(first+4, -1);
+	reference.resize(3*(first+4), 0.);
+	edgeFirst.resize(first+4, 0);
+	edgeCount.resize(first+4, 0);
+
+	for (int k = 0; k < 4; ++k)
+		buildCell(polygon, edges, first+k, f, level+1, 2*i+k/2, 2*j+k%2,
+				cellEdges, ref, refStatus);
+}
+
+int GeoTessPolygonIndex::classify(const vector<GeoTessGreatCircle*>& edges, const double* x) const
+{
+	if (child.empty())
+		return -1;
+
+	int f;
+	double u, v;
+	toFace(x, f, u, v);
+
+	int n = 1 << depth;
+	int iu = (int)((u+1.)*0.5*n), iv = (int)((v+1.)*0.5*n);
+	if (iu < 0) iu = 0; else if (iu >= n) iu = n-1;
+	if (iv < 0) iv = 0; else if (iv >= n) iv = n-1;
+
+	int node = f, shift = depth;
+	while (child[node] >= 0)
+	{
+		--shift;
+		node = child[node] + 2*((iu >> shift) & 1) + ((iv >> shift) & 1);
+	}
+
+	if (edgeCount[node] == 0)
+		return status[node];
+
+	return classify(edges, &edgeList[edgeFirst[node]], edgeCount[node],
+			&reference[3*node], status[node], x);
+}
+
+} // end namespace geotess
@@ -34,6 +34,7 @@
 //- ****************************************************************************
 
 #include <sstream>
+#include <iomanip>
 #include <climits>
 #include <cmath>
 
@@ -59,6 +60,36 @@ const double GeoTessPosition::TWALK_TOLERANCE = -1e-15;
 
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
+/**
+ * Return a one-line summary of the counters.
+ */
+string GeoTessPositionCounters::toString() const
+{
+	ostringstream os;
+	os << "walkSteps=" << walkSteps
+			<< " walkRestarts=" << walkRestarts
+			<< " cacheHits=" << cacheHits
+			<< " radialUpdates=" << radialUpdates
+			<< " update2DCalls=" << update2DCalls
+			<< " update2DTime=" << fixed << setprecision(3) << update2DTime * 1e-6 << "ms"
+			<< " nnPerimeters=" << nnPerimeters
+			<< " nnPerimeterEdges=" << nnPerimeterEdges
+			<< " nnPerimeterMax=" << nnPerimeterMax;
+	return os.str();
+}
+
+/**
+ * Return true if GeoTess was compiled with GEOTESS_POSITION_COUNTERS defined.
+ */
+bool GeoTessPosition::isCountersEnabled()
+{
+#ifdef GEOTESS_POSITION_COUNTERS
+	return true;
+#else
+	return false;
+#endif
+}
+
 /**
  * Constructor that takes a reference to the 3D model that is to be interrogated by this
  * GeoTessPosition3D object.
@@ -263,6 +294,7 @@ void GeoTessPosition::updatePosition2D(int lid, const double* const uVector)
 		// start walk from current triangle
 		if ((triangle[tessid] < 0) || GeoTessUtils::dot(uVector, unitVector) < 0.961261696)
 		{
+			GEOTESS_POSITION_COUNT(++counters.walkRestarts);
 			triangle[tessid] = grid.getTriangle(tessid, 0, 0);
 			tessLevels[tessid] = 0;
 		}
@@ -288,8 +320,11 @@ void GeoTessPosition::updatePosition2D(int lid, const double* const uVector)
 		clearRadialCoefficients();
 	}
 	else
+	{
 		// the 2D position did not change but the layerId/tessid might have.
+		GEOTESS_POSITION_COUNT(++counters.cacheHits);
 		checkTessellation(tessid);
+	}
 }
 
 /**
@@ -317,6 +352,7 @@ void GeoTessPosition::getContainingTriangle(int tid)
 
 	while (true)
 	{
+		GEOTESS_POSITION_COUNT(++counters.walkSteps);
 		c[0] = GeoTessUtils::dot(gridEdges[t][0]->normal, u);
 		if (c[0] > GeoTessPosition::TWALK_TOLERANCE)
 		{
@@ -337,7 +373,10 @@ void GeoTessPosition::getContainingTriangle(int tid)
 
 						// Update the 2D vertices and horizontal interpolation coefficients.
 						// Different types of interpolators will handle this differently.
+						GEOTESS_POSITION_COUNT(long long t0 = CpuTimer::getNanoTime());
 						update2D(tid, u);
+						GEOTESS_POSITION_COUNT(++counters.update2DCalls;
+								counters.update2DTime += CpuTimer::getNanoTime() - t0);
 
 						return;
 					}
@@ -212,6 +212,11 @@ void GeoTessPositionNaturalNeighbor::update2D(int tessId, const double* const uV
 		prev = edge->vj;
 	}
 
+	GEOTESS_POSITION_COUNT(++counters.nnPerimeters;
+			counters.nnPerimeterEdges += edges.size();
+			if ((long long) edges.size() > counters.nnPerimeterMax)
+				counters.nnPerimeterMax = edges.size());
+
 	double ip1[3], ip2[3], ip3[3], work1[3], work2[3], work3[3];
 
 	vt.clear();
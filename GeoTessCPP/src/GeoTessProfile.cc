@@ -39,6 +39,7 @@
 
 #include "GeoTessException.h"
 #include "GeoTessProfile.h"
+#include "GeoTessMetaData.h"
 #include "GeoTessProfileEmpty.h"
 #include "GeoTessProfileSurfaceEmpty.h"
 #include "GeoTessProfileThin.h"
@@ -57,7 +58,7 @@ namespace geotess
 
 // **** _STATIC INITIALIZATIONS_************************************************
 
-int GeoTessProfile::aClassCount = 0;
+atomic<int> GeoTessProfile::aClassCount(0);
 
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
@@ -374,4 +375,49 @@ GeoTessProfile* GeoTessProfile::newProfile(IFStreamAscii& ifs, GeoTessMetaData&
 	}
 }
 
+void GeoTessProfile::skipProfile(IFStreamAscii& ifs, GeoTessMetaData& gtmd)
+{
+	// the number of attribute values that are stored in the file for each
+	// data object
+
+	int nValues = gtmd.applyAttributeFilter() ? (int) gtmd.getAttributeFilter().size()
+			: gtmd.getNAttributes();
+
+	// read ProfileType and skip the radii and data of that type of Profile.
+
+	int profileType = -1;
+	ifs.readInteger(profileType);
+	switch (profileType)
+	{
+	case 0:
+		// EMPTY: two radii
+		ifs.skip(2);
+		break;
+	case 1:
+		// THIN: one radius and one data object
+		ifs.skip(1 + nValues);
+		break;
+	case 2:
+		// CONSTANT: two radii and one data object
+		ifs.skip(2 + nValues);
+		break;
+	case 3:
+		// NPOINT: number of nodes, then a radius and a data object per node
+		ifs.skip(ifs.readInteger() * (1 + nValues));
+		break;
+	case 4:
+		// SURFACE: one data object
+		ifs.skip(nValues);
+		break;
+	case 5:
+		// SURFACE_EMPTY: nothing
+		break;
+	default:
+		ostringstream os;
+		os << endl << "ERROR in Profile::skipProfile" << endl << "Unrecognized ProfileType "
+				<< profileType << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 4004);
+	}
+}
+
 } // end namespace geotess
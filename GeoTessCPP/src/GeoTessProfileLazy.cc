@@ -0,0 +1,204 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+#include <sstream>
+
+// **** _LOCAL INCLUDES_ *******************************************************
+
+#include "GeoTessProfileLazy.h"
+#include "GeoTessException.h"
+#include "GeoTessMetaData.h"
+#include "CPPUtils.h"
+
+// **** _BEGIN GEOTESS NAMESPACE_ **********************************************
+
+namespace geotess
+{
+
+// **** _EXPLICIT TEMPLATE INSTANTIATIONS_ *************************************
+
+// **** _STATIC INITIALIZATIONS_************************************************
+
+// **** _FUNCTION IMPLEMENTATIONS_ *********************************************
+
+/**
+ * Destructor.  Deletes the decoded profile, if there is one.
+ */
+GeoTessProfileLazy::~GeoTessProfileLazy()
+{
+	GeoTessProfile* p = profile.load();
+	if (p != NULL) delete p;
+	if (pointIndices != NULL) delete [] pointIndices;
+}
+
+/**
+ * Static factory method that copies the next profile in input to store
+ * without decoding it.
+ */
+GeoTessProfile* GeoTessProfileLazy::newProfile(IFStreamBinary& input,
+		GeoTessMetaData& metaData, IFStreamBinary& store)
+{
+	int pos = input.getPos();
+	int profileType = input.readByte(pos);
+
+	// surface profiles have no radii and a single data object.  There is
+	// nothing to gain by deferring them.
+
+	if (profileType == GeoTessProfileType::SURFACE.ordinal()
+			|| profileType == GeoTessProfileType::SURFACE_EMPTY.ordinal())
+		return GeoTessProfile::newProfile(input, metaData);
+
+	// number of bytes in the encoding of one Data object.  If an attribute
+	// filter is in effect, the file contains all the attributes in the file,
+	// not just those that will be retained.
+
+	int nValues = metaData.applyAttributeFilter() ?
+			(int) metaData.getAttributeFilter().size() : metaData.getNAttributes();
+	int dataSize;
+	switch (metaData.getDataType().ordinal())
+	{
+	case 0 : dataSize = CPPUtils::SDBL; break;
+	case 1 : dataSize = CPPUtils::SFLT; break;
+	case 2 : dataSize = CPPUtils::SLNG; break;
+	case 3 : dataSize = CPPUtils::SINT; break;
+	case 4 : dataSize = CPPUtils::SSHT; break;
+	case 5 : dataSize = CPPUtils::SBYT; break;
+	default :
+		ostringstream os;
+		os << endl << "ERROR in GeoTessProfileLazy::newProfile" << endl
+				<< metaData.getDataType().toString() << " is not a recognized data type." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 4701);
+	}
+	dataSize *= nValues;
+
+	int start = pos + CPPUtils::SBYT;
+	int length, nRadii, nData;
+	float radiusBottom, radiusTop;
+	switch (profileType)
+	{
+	case 0:
+		// EMPTY: radiusBottom, radiusTop
+		nRadii = 2;
+		nData = 0;
+		radiusBottom = input.readFloat(start);
+		radiusTop = input.readFloat(start + CPPUtils::SFLT);
+		length = 2 * CPPUtils::SFLT;
+		break;
+	case 1:
+		// THIN: radius, data
+		nRadii = 1;
+		nData = 1;
+		radiusBottom = radiusTop = input.readFloat(start);
+		length = CPPUtils::SFLT + dataSize;
+		break;
+	case 2:
+		// CONSTANT: radiusBottom, radiusTop, data
+		nRadii = 2;
+		nData = 1;
+		radiusBottom = input.readFloat(start);
+		radiusTop = input.readFloat(start + CPPUtils::SFLT);
+		length = 2 * CPPUtils::SFLT + dataSize;
+		break;
+	case 3:
+		// NPOINT: nNodes, then radius and data for each node
+		nRadii = nData = input.readInt(start);
+		if (nRadii < 1)
+		{
+			ostringstream os;
+			os << endl << "ERROR in GeoTessProfileLazy::newProfile" << endl
+					<< "NPOINT profile has " << nRadii << " nodes." << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 4702);
+		}
+		radiusBottom = input.readFloat(start + CPPUtils::SINT);
+		radiusTop = input.readFloat(start + CPPUtils::SINT
+				+ (nRadii - 1) * (CPPUtils::SFLT + dataSize));
+		length = CPPUtils::SINT + nRadii * (CPPUtils::SFLT + dataSize);
+		break;
+	default:
+		ostringstream os;
+		os << endl << "ERROR in GeoTessProfileLazy::newProfile" << endl
+				<< profileType << " is not a recognized ProfileType." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 4703);
+	}
+	length += CPPUtils::SBYT;
+
+	int position = store.getPos();
+	store.writeByteArray((const byte*) input.getPosPointer(pos), length);
+	input.incrementPos(length);
+
+	return new GeoTessProfileLazy(&store, position, length, &metaData,
+			*GeoTessProfileType::values()[profileType], nRadii, nData,
+			radiusBottom, radiusTop);
+}
+
+void GeoTessProfileLazy::moveTo(IFStreamBinary& store)
+{
+	if (isLoaded()) return;
+
+	int pos = store.getPos();
+	store.writeByteArray((const byte*) source->getPosPointer(position), length);
+	source = &store;
+	position = pos;
+}
+
+/**
+ * Decode the profile from the store and publish it.  If another thread
+ * published a profile first, the one decoded here is discarded.
+ */
+GeoTessProfile* GeoTessProfileLazy::decode() const
+{
+	IFStreamBinary in(const_cast<string*>(&source->getData()));
+	in.setBoundaryAlignment(false);
+	in.setByteOrderReverse(source->isByteOrderReversalOn());
+	in.incrementPos(position);
+
+	GeoTessProfile* p = GeoTessProfile::newProfile(in, *metaData);
+
+	if (pointIndices != NULL)
+		for (int i = 0; i < nData; ++i)
+			p->setPointIndex(i, pointIndices[i]);
+
+	if (cubic)
+		p->prepareInterpolation(GeoTessInterpolatorType::CUBIC_SPLINE);
+
+	GeoTessProfile* expected = NULL;
+	if (profile.compare_exchange_strong(expected, p))
+		return p;
+
+	delete p;
+	return expected;
+}
+
+} // end namespace geotess
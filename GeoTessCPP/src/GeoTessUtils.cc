@@ -56,6 +56,8 @@ namespace geotess {
  */
 bool 			GeoTessUtils::approximateLatitudes = false;
 
+const int		GeoTessUtils::SINCOS_BLOCK;
+
 
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
@@ -437,6 +439,107 @@ double GeoTessUtils::getGreatCirclePoints(double* ptA, double* ptB, const int& n
 	return dx;
 }
 
+double GeoTessUtils::getGreatCirclePoints(const double* const ptA, const double* const ptB,
+		const int& npoints, const bool& onCenters,
+		double* const x, double* const y, double* const z)
+{
+	if (npoints <= 0) return 0.;
+
+	double distance = angle(ptA, ptB);
+
+	if (distance <= 0.)
+	{
+		for (int i=0; i<npoints; ++i)
+		{
+			x[i] = ptA[0];
+			y[i] = ptA[1];
+			z[i] = ptA[2];
+		}
+		return 0.;
+	}
+
+	double dx = onCenters ? distance / npoints
+			: npoints == 1 ? 0. : distance/(npoints-1);
+
+	double dx0 = onCenters ? dx/2 : 0.;
+
+	double gcs[6];
+	double* gc[2] = {&gcs[0], &gcs[3]};
+	getGreatCircle(ptA, ptB, gc);
+
+	getGreatCirclePoints(gc, dx0, dx, npoints, x, y, z);
+
+	return dx;
+}
+
+void GeoTessUtils::getGreatCirclePoints(double const* const * const greatCircle,
+		const double& dx0, const double& dx, const int& npoints,
+		double* const x, double* const y, double* const z)
+{
+	const double* g0 = greatCircle[0];
+	const double* g1 = greatCircle[1];
+
+	// sin and cos of j*dx for j in [0, SINCOS_BLOCK)
+	double st[SINCOS_BLOCK], ct[SINCOS_BLOCK];
+	sinCos(0., dx, npoints < SINCOS_BLOCK ? npoints : SINCOS_BLOCK, st, ct);
+
+	double sb, cb, sa, ca;
+	for (int i0 = 0; i0 < npoints; i0 += SINCOS_BLOCK)
+	{
+		// exact sin and cos of the first angle in this block
+		sb = sin(dx0 + i0*dx);
+		cb = cos(dx0 + i0*dx);
+
+		int n = npoints - i0 < SINCOS_BLOCK ? npoints - i0 : SINCOS_BLOCK;
+		double* const xb = x+i0;
+		double* const yb = y+i0;
+		double* const zb = z+i0;
+		for (int j = 0; j < n; ++j)
+		{
+			ca = cb*ct[j] - sb*st[j];
+			sa = sb*ct[j] + cb*st[j];
+			xb[j] = ca * g0[0] + sa * g1[0];
+			yb[j] = ca * g0[1] + sa * g1[1];
+			zb[j] = ca * g0[2] + sa * g1[2];
+		}
+	}
+}
+
+void GeoTessUtils::sinCos(const double& a0, const double& da, const int& n,
+		double* const s, double* const c)
+{
+	if (n <= 0) return;
+
+	// tabulate sin and cos of j*da with the rotation recurrence.  The
+	// recurrence runs at most SINCOS_BLOCK steps so error stays at roundoff level.
+	int nt = n < SINCOS_BLOCK ? n : SINCOS_BLOCK;
+	double st[SINCOS_BLOCK], ct[SINCOS_BLOCK];
+	double sd = sin(da), cd = cos(da);
+	st[0] = 0.;
+	ct[0] = 1.;
+	for (int j = 1; j < nt; ++j)
+	{
+		st[j] = st[j-1]*cd + ct[j-1]*sd;
+		ct[j] = ct[j-1]*cd - st[j-1]*sd;
+	}
+
+	double sb, cb;
+	for (int i0 = 0; i0 < n; i0 += SINCOS_BLOCK)
+	{
+		sb = sin(a0 + i0*da);
+		cb = cos(a0 + i0*da);
+
+		int nb = n - i0 < SINCOS_BLOCK ? n - i0 : SINCOS_BLOCK;
+		double* const sp = s+i0;
+		double* const cp = c+i0;
+		for (int j = 0; j < nb; ++j)
+		{
+			sp[j] = sb*ct[j] + cb*st[j];
+			cp[j] = cb*ct[j] - sb*st[j];
+		}
+	}
+}
+
 /**
  * Transform is a 3 x 3 matrix such that when a vector is multiplied by
  * transform, the vector will be projected onto the plane of this
@@ -34,6 +34,11 @@
 //- ****************************************************************************
 
 #include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <limits>
 
 // **** _LOCAL INCLUDES_ *******************************************************
 
@@ -51,13 +56,13 @@ namespace geotess {
 // **** _FUNCTION IMPLEMENTATIONS_ *********************************************
 
 /**
- * Opens a stream for ascii read.
+ * Opens a stream for ascii read.  The whole file is read into memory.
  */
 void	IFStreamAscii::openForRead(const string& fn)
 {
 	resetReader();
 	strFileName = fn;
-	ifs.open(fn.c_str(), std::ios::in);
+	ifstream ifs(fn.c_str(), std::ios::in | std::ios::binary);
 	if (!ifs.is_open())
 	{
 		ostringstream os;
@@ -65,6 +70,49 @@ void	IFStreamAscii::openForRead(const string& fn)
 			 << "Could not open input file: " << fn << endl;
 		throw GeoTessException(os, __FILE__, __LINE__, 9207);
 	}
+
+	ifs.seekg(0, ios::end);
+	streamoff n = ifs.tellg();
+	ifs.seekg(0, ios::beg);
+	strBuffer.resize((size_t) n);
+	if (n > 0) ifs.read(&strBuffer[0], n);
+	if (ifs.gcount() != n)
+	{
+		ostringstream os;
+		os << endl << "ERROR in IFStreamAscii::openForRead" << endl
+			 << "Could not read input file: " << fn << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 9207);
+	}
+	ifs.close();
+
+	strData = strBuffer.data();
+	strSize = strBuffer.size();
+	strReadOpen = true;
+}
+
+/**
+ * Opens a stream for ascii read of a section of another stream.
+ */
+void	IFStreamAscii::openForRead(const IFStreamAscii& source, const size_t& begin,
+		const size_t& end, const int& linesRead)
+{
+	if (!source.strReadOpen || begin > end || end > source.strSize)
+	{
+		ostringstream os;
+		os << endl << "ERROR in IFStreamAscii::openForRead" << endl
+			 << "Section [" << begin << ", " << end << ") is not a valid section of input file "
+			 << source.strFileName << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 9210);
+	}
+
+	resetReader();
+	strFileName = source.strFileName;
+	for (int i = 0; i < 5; ++i) strDelim[i] = source.strDelim[i];
+
+	strData = source.strData + begin;
+	strSize = end - begin;
+	strTotlLinesRead = linesRead;
+	strReadOpen = true;
 }
 
 /**
@@ -99,12 +147,14 @@ void IFStreamAscii::resetReader()
   strTotlLinesRead = strDataLinesRead = strBytesRead = 0;
   strBlankLinesRead = strCommentLinesRead = strBlkCommentLinesRead = 0;
 	strBlkCommntSet  = false;
+	strEOF = false;
   strFileName = "";
 
   // clear tokens and reset token pointer
 
   strTokenPtr = 0;
   strTokens.clear();
+  strLine.clear();
 }
 
 /**
@@ -129,35 +179,40 @@ void IFStreamAscii::setDefaultDelimiters()
 /**
  * Read a new line of text from the input stream.
  *
- * This function reads a line of text from the input stream regardless of how
- * long the line is. The internal buffer is resized until the entire line can
- * be read into the internal buffer. If eof is reached an empty buffer is
- * returned.
+ * This function reads a line of text, regardless of how long the line is,
+ * from the in-memory contents of the stream. The end of line character(s)
+ * are not included in buf. If eof is reached an empty buffer is returned.
  */
 void IFStreamAscii::getLine(string& buf)
 {
-  // set internal buffer to 100 bytes and save current read position
+  // if at the end of the data set eof and return an empty line
 
-  if (buf.size() < 100) buf.resize(100);
-  streampos curr_fp = ifs.tellg();
-
-  // get line ... if line doesn't fit (fail is true) and eof was not reached,
-  // then resize buffer and try again
-
-  ifs.getline(&buf[0], buf.size());
-  while (ifs.fail() && !ifs.eof())
+  if (strPos >= strSize)
   {
-    // buffer was to small ... resize buffer to twice as large as last time
-
-    buf.resize(2 * buf.size());
+    buf.clear();
+    strEOF = true;
+    return;
+  }
 
-    // clear stream flags ... seek back to original read position ... read line
-    // again
+  // find the end of the line ... if there is no end of line character the
+  // line extends to the end of the data and eof is reached
 
-    ifs.clear();
-    ifs.seekg((streamoff) curr_fp, ios::beg);
-    ifs.getline(&buf[0], buf.size());
+  const char* ln = strData + strPos;
+  const char* nl = (const char*) memchr(ln, '\n', strSize - strPos);
+  size_t n;
+  if (nl == NULL)
+  {
+    n = strSize - strPos;
+    strPos = strSize;
+    strEOF = true;
+  }
+  else
+  {
+    n = nl - ln;
+    strPos += n + 1;
   }
+  if ((n > 0) && (ln[n - 1] == '\r')) --n;
+  buf.assign(ln, n);
 }
 
 /**
@@ -173,13 +228,11 @@ void IFStreamAscii::getLine(string& buf)
  */
 bool IFStreamAscii::readLine(string& ln)
 {
-  string buf;
   string::size_type i, j, k;
 
   // exit with true if stream is not assigned or is at eof
 
-  if (!ifs.is_open()) return false;
-  if (ifs.eof()) return false;
+  if (!strReadOpen || strEOF) return false;
 
   // read lines until a valid line is found
 
@@ -188,9 +241,7 @@ bool IFStreamAscii::readLine(string& ln)
     // get next line into buffer and set into string (ln) ... increment total
     // lines read
 
-    getLine(buf);
-		ln = buf.c_str();
-		CPPUtils::removeEOL(ln);
+    getLine(ln);
     ++strTotlLinesRead;
     strBytesRead += ln.length();
     if (ln.length() == 0) ++strBlankLinesRead;
@@ -278,10 +329,10 @@ bool IFStreamAscii::readLine(string& ln)
           // remove any whitespace from the front of line
 
           i = ln.find_first_not_of(strDelim[0]);
-          if (i != string::npos)
-            ln = ln.substr(i, ln.length() - i);
-          else
-            ln = "";
+          if (i == string::npos)
+            ln.clear();
+          else if (i > 0)
+            ln.erase(0, i);
 
           // continue parsing line if not empty
 
@@ -291,9 +342,9 @@ bool IFStreamAscii::readLine(string& ln)
 
             i = ln.find_last_not_of(strDelim[0]);
             if (i != string::npos)
-              ln = ln.substr(0, i + 1);
+              ln.erase(i + 1);
             else
-              ln = "";
+              ln.clear();
 
             // increment data line count and return
 
@@ -306,13 +357,36 @@ bool IFStreamAscii::readLine(string& ln)
 
     // no data was found ... try again if not EOF
 
-  } while (!ifs.eof());
+  } while (!strEOF);
 
   // eof was reached return false
 
   return false;
 }
 
+/**
+ * Read the next data line into strLine and tokenize it into strTokens.
+ *
+ * Returns false if eof is reached before a line containing a token is found.
+ */
+bool IFStreamAscii::readTokenLine()
+{
+  // reset token pointer and list
+
+  strTokenPtr = 0;
+  strTokens.clear();
+
+  // read data lines until one with at least one token is found
+
+  do
+  {
+    if (!readLine(strLine)) return false;
+    tokenize(strLine, strTokens);
+  } while (strTokens.empty());
+
+  return true;
+}
+
 /**
  * Tokenize the input string str into the string vector tokens.
  *
@@ -322,11 +396,46 @@ bool IFStreamAscii::readLine(string& ln)
  * read from the input stream.
  */
 void IFStreamAscii::tokenize(const string& str, vector<string>& tokens)
+{
+  vector<pair<int, int> > spans;
+  tokenize(str, spans);
+  for (int i = 0; i < (int) spans.size(); ++i)
+    tokens.push_back(str.substr(spans[i].first, spans[i].second));
+}
+
+/**
+ * Tokenize the input string str into the offset and length of each token.
+ *
+ * The tokens are identical to those returned by
+ * tokenize(const string&, vector<string>&).
+ */
+void IFStreamAscii::tokenize(const string& str, vector<pair<int, int> >& tokens)
 {
   string::size_type beg_pos, end_pos, strt_strng, strt_equal;
   string& wspc = strDelim[0]; // whitespace delimiter
   string& strg = strDelim[1]; // string delimiter
 
+  // lines of numbers contain no string delimiters ... split them on whitespace
+  // directly
+
+  if (str.find_first_of(strg) == string::npos)
+  {
+    const char* s = str.data();
+    const char* ws = wspc.data();
+    int n = (int) str.length();
+    int nws = (int) wspc.length();
+    int i = 0, j;
+    while (true)
+    {
+      while ((i < n) && memchr(ws, s[i], nws)) ++i;
+      if (i == n) break;
+      for (j = i + 1; (j < n) && !memchr(ws, s[j], nws); ++j);
+      tokens.push_back(pair<int, int>(i, j - i));
+      i = j;
+    }
+    return;
+  }
+
   // loop finding all tokens until done
 
   end_pos = 0;
@@ -357,22 +466,21 @@ void IFStreamAscii::tokenize(const string& str, vector<string>& tokens)
           // sequence before the "=" (including "=") as a separate token
           // increment beg_pos to strt_strng
 
-          tokens.push_back(str.substr(beg_pos, strt_strng - beg_pos));
+          tokens.push_back(pair<int, int>((int) beg_pos, (int) (strt_strng - beg_pos)));
           beg_pos = strt_strng;
         }
       }
 
       // see if a string delimiter is the first character of the next token
 
-      strt_strng = strg.find_first_of(str.substr(beg_pos, 1), 0);
+      strt_strng = strg.find(str[beg_pos]);
       if (strt_strng != string::npos)
       {
         // increment to start of string delimited token ... find matching token
         // at other end ... add string token to the vector
 
         beg_pos++;
-        end_pos = str.find_first_of(strg.substr(strt_strng, 1), beg_pos);
-        tokens.push_back(str.substr(beg_pos, end_pos - beg_pos));
+        end_pos = str.find(strg[strt_strng], beg_pos);
 
         // see if matching string delimiter was found
 
@@ -388,10 +496,12 @@ void IFStreamAscii::tokenize(const string& str, vector<string>& tokens)
 						 << "    String Start: " << strg.substr(strt_strng, 1) << endl;
 					throw GeoTessException(os, __FILE__, __LINE__, 9209);
         }
-        else
-          // else increment to next position after ending string delimiter
 
-          end_pos++;
+        // else add the token and increment to next position after ending
+        // string delimiter
+
+        tokens.push_back(pair<int, int>((int) beg_pos, (int) (end_pos - beg_pos)));
+        end_pos++;
       }
       else
       {
@@ -399,7 +509,8 @@ void IFStreamAscii::tokenize(const string& str, vector<string>& tokens)
         // token to the vector
 
         end_pos = str.find_first_of(wspc, beg_pos);
-        tokens.push_back(str.substr(beg_pos, end_pos - beg_pos));
+        tokens.push_back(pair<int, int>((int) beg_pos, (int) ((end_pos == string::npos ?
+                         str.length() : end_pos) - beg_pos)));
       }
     }
 
@@ -410,4 +521,219 @@ void IFStreamAscii::tokenize(const string& str, vector<string>& tokens)
   }
 }
 
+/**
+ * Parse a plain decimal number, [+-]digits[.digits][(e|E)[+-]digits], that
+ * occupies all of [p, end), into its sign, the integer formed by its
+ * significant digits and the corresponding power of ten.  Returns false if
+ * the token has any other form or more than 19 significant digits.
+ */
+static bool parseDecimal(const char* p, const char* end, bool& negative,
+		unsigned long long& mantissa, int& exponent)
+{
+	int nDigits = 0, nSignificant = 0;
+	negative = false;
+	mantissa = 0;
+	exponent = 0;
+
+	if ((p < end) && ((*p == '-') || (*p == '+'))) negative = (*p++ == '-');
+
+	for (; (p < end) && (*p >= '0') && (*p <= '9'); ++p, ++nDigits)
+		if ((mantissa != 0) || (*p != '0'))
+		{
+			if (++nSignificant > 19) return false;
+			mantissa = 10 * mantissa + (*p - '0');
+		}
+
+	if ((p < end) && (*p == '.'))
+		for (++p; (p < end) && (*p >= '0') && (*p <= '9'); ++p, ++nDigits)
+		{
+			if ((mantissa != 0) || (*p != '0'))
+			{
+				if (++nSignificant > 19) return false;
+				mantissa = 10 * mantissa + (*p - '0');
+			}
+			--exponent;
+		}
+
+	if (nDigits == 0) return false;
+
+	if ((p < end) && ((*p == 'e') || (*p == 'E')))
+	{
+		bool negativeExponent = false;
+		if ((++p < end) && ((*p == '-') || (*p == '+'))) negativeExponent = (*p++ == '-');
+		if ((p == end) || (*p < '0') || (*p > '9')) return false;
+		int x = 0;
+		for (; (p < end) && (*p >= '0') && (*p <= '9'); ++p)
+		{
+			if (x > 100000) return false;
+			x = 10 * x + (*p - '0');
+		}
+		exponent += negativeExponent ? -x : x;
+	}
+
+	return p == end;
+}
+
+/**
+ * Round x, which approximates some number to within a few units in its last
+ * place, to type T.  Returns false if the approximation is too close to the
+ * midpoint between two adjacent values of type T, or outside the range of
+ * normal values of type T, to be sure that t is the correctly rounded
+ * value of the number.
+ */
+template <typename T, typename W>
+static bool roundTo(const W& x, T& t)
+{
+	t = (T) x;
+	T a = fabs(t);
+	if (!(a >= numeric_limits<T>::min()) || (a > numeric_limits<T>::max())) return false;
+
+	W r = x - (W) t;
+	T next = nextafter(t, r > 0 ? numeric_limits<T>::infinity() : -numeric_limits<T>::infinity());
+	W half = fabs((W) next - (W) t) / 2;
+	return fabs(fabs(r) - half) > 4 * fabs(x) * numeric_limits<W>::epsilon();
+}
+
+// Powers of ten that are exactly representable as double and long double.
+
+static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+		1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+		1e21, 1e22 };
+
+#if LDBL_MANT_DIG >= 64
+static const long double POW10L[] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L,
+		1e6L, 1e7L, 1e8L, 1e9L, 1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L,
+		1e17L, 1e18L, 1e19L, 1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L,
+		1e27L };
+#endif
+
+/**
+ * Convert a token to an integer.  Return false if the token does not start
+ * with an integer.
+ */
+bool IFStreamAscii::scanInteger(const char* beg, const char* end, long long& l)
+{
+	// convert an optionally signed sequence of digits directly
+
+	const char* p = beg;
+	bool negative = false;
+	if ((p < end) && ((*p == '-') || (*p == '+'))) negative = (*p++ == '-');
+	if ((p < end) && (*p >= '0') && (*p <= '9'))
+	{
+		unsigned long long v = 0;
+		for (; (p < end) && (*p >= '0') && (*p <= '9') && (v < 100000000000000000ULL); ++p)
+			v = 10 * v + (*p - '0');
+		if ((p == end) || (*p < '0') || (*p > '9'))
+		{
+			l = negative ? -(long long) v : (long long) v;
+			return true;
+		}
+	}
+
+	// anything else, including integers with more than 17 digits, is
+	// converted by the C library
+
+	string s(beg, end);
+	return sscanf(s.c_str(), "%lld", &l) == 1;
+}
+
+/**
+ * Convert a token to a float.  Return false if the token does not start
+ * with a number.
+ */
+bool IFStreamAscii::scanFloat(const char* beg, const char* end, float& f)
+{
+	bool negative;
+	unsigned long long mantissa;
+	int exponent;
+
+	// a plain decimal number is evaluated in double precision, which is then
+	// rounded to float unless the result is too close to call
+
+	if (parseDecimal(beg, end, negative, mantissa, exponent))
+	{
+		if (mantissa == 0)
+		{
+			f = negative ? -0.0F : 0.0F;
+			return true;
+		}
+		if ((exponent >= -22) && (exponent <= 22))
+		{
+			double x = exponent < 0 ? (double) mantissa / POW10[-exponent]
+					: (double) mantissa * POW10[exponent];
+			if (roundTo(x, f))
+			{
+				if (negative) f = -f;
+				return true;
+			}
+		}
+	}
+
+	string s(beg, end);
+	return sscanf(s.c_str(), "%f", &f) == 1;
+}
+
+/**
+ * Convert a token to a double.  Return false if the token does not start
+ * with a number.
+ */
+bool IFStreamAscii::scanDouble(const char* beg, const char* end, double& d)
+{
+	bool negative;
+	unsigned long long mantissa;
+	int exponent;
+
+	if (parseDecimal(beg, end, negative, mantissa, exponent))
+	{
+		if (mantissa == 0)
+		{
+			d = negative ? -0.0 : 0.0;
+			return true;
+		}
+
+		// a mantissa and a power of ten that are both exact doubles give the
+		// correctly rounded result with a single multiplication or division
+
+		if ((mantissa <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22))
+		{
+			d = exponent < 0 ? (double) mantissa / POW10[-exponent]
+					: (double) mantissa * POW10[exponent];
+			if (negative) d = -d;
+			return true;
+		}
+
+#if LDBL_MANT_DIG >= 64
+		// otherwise evaluate in extended precision and round to double unless
+		// the result is too close to call
+
+		if ((exponent >= -27) && (exponent <= 27))
+		{
+			long double x = exponent < 0 ? (long double) mantissa / POW10L[-exponent]
+					: (long double) mantissa * POW10L[exponent];
+			if (roundTo(x, d))
+			{
+				if (negative) d = -d;
+				return true;
+			}
+		}
+#endif
+	}
+
+	string s(beg, end);
+	return sscanf(s.c_str(), "%lf", &d) == 1;
+}
+
+/**
+ * Throw the exception reporting a token that could not be converted.
+ */
+void IFStreamAscii::throwScanError(const string& function, const string& type,
+		const char* beg, const char* end, const int& code)
+{
+	ostringstream os;
+	os << endl << "ERROR in IFStreamAscii::" << function << endl
+		 << "  Could Not Scan " << type << " From Token = " << string(beg, end) << endl
+		 << "  On File Line: " << strTotlLinesRead << " ..." << endl;
+	throw GeoTessException(os, __FILE__, __LINE__, code);
+}
+
 } // end namespace geotess
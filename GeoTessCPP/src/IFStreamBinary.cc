@@ -34,6 +34,7 @@
 //- ****************************************************************************
 
 #include <sstream>
+#include <cstdio>
 
 // **** _LOCAL INCLUDES_ *******************************************************
 
@@ -55,7 +56,8 @@ namespace geotess {
  */
 IFStreamBinary::IFStreamBinary() :	bData(new string("")), bDataPos(0),
 															bSize(0), bAlign(true), bReverse(false),
-															bOwnStr(true), bFileName(""), bMemIncr(1000000)
+															bOwnStr(true), bFileName(""), bMemIncr(1000000),
+															bStream(NULL), bFlushed(0), bBlockSize(4194304)
 {
 }
 
@@ -65,7 +67,8 @@ IFStreamBinary::IFStreamBinary() :	bData(new string("")), bDataPos(0),
 IFStreamBinary::IFStreamBinary(bool align) :	bData(new string("")),
 															bDataPos(0), bSize(0), bAlign(align),
 															bReverse(false), bOwnStr(true), bFileName(""),
-															bMemIncr(1000000)
+															bMemIncr(1000000),
+															bStream(NULL), bFlushed(0), bBlockSize(4194304)
 {
 }
 
@@ -77,7 +80,8 @@ IFStreamBinary::IFStreamBinary(const string& filename) :
 															bData(new string("")), bDataPos(0),
 															bSize(0), bAlign(true), bReverse(false),
 															bOwnStr(true), bFileName(filename),
-															bMemIncr(1000000)
+															bMemIncr(1000000),
+															bStream(NULL), bFlushed(0), bBlockSize(4194304)
 {
 	readFromFile(filename);
 }
@@ -90,7 +94,8 @@ IFStreamBinary::IFStreamBinary(const string& filename, int num_bytes) :
 															bData(new string("")), bDataPos(0),
 															bSize(0), bAlign(true), bReverse(false),
 															bOwnStr(true), bFileName(filename),
-															bMemIncr(1000000)
+															bMemIncr(1000000),
+															bStream(NULL), bFlushed(0), bBlockSize(4194304)
 {
 	readFromFile(filename, num_bytes);
 }
@@ -102,7 +107,8 @@ IFStreamBinary::IFStreamBinary(const string& filename, int num_bytes) :
 IFStreamBinary::IFStreamBinary(string* str) :	bData(str),
 															bDataPos(0), bSize(0), bAlign(true),
 															bReverse(false), bOwnStr(false), bFileName(""),
-															bMemIncr(1000000)
+															bMemIncr(1000000),
+															bStream(NULL), bFlushed(0), bBlockSize(4194304)
 {
 }
 
@@ -114,7 +120,9 @@ IFStreamBinary::IFStreamBinary(const IFStreamBinary& db) :
 															bDataPos(db.bDataPos), bSize(db.bSize),
 															bAlign(db.bAlign), bReverse(db.bReverse),
 															bOwnStr(true), bFileName(db.bFileName),
-															bMemIncr(db.bMemIncr)
+															bMemIncr(db.bMemIncr),
+															bStream(NULL), bFlushed(0),
+															bBlockSize(db.bBlockSize)
 {
   (*bData) = (*db.bData);
 }
@@ -124,6 +132,11 @@ IFStreamBinary::IFStreamBinary(const IFStreamBinary& db) :
  */
 IFStreamBinary::~IFStreamBinary()
 {
+  // a streaming write that was not closed was abandoned (usually by an
+  // exception) ... do not leave a truncated file behind
+
+  if (bStream != NULL) discard();
+
   if (bOwnStr) delete bData;
 }
 
@@ -141,6 +154,7 @@ IFStreamBinary&	IFStreamBinary::operator=(const IFStreamBinary& db)
   bReverse  = db.bReverse;
   bFileName = db.bFileName;
   bMemIncr  = db.bMemIncr;
+  bBlockSize = db.bBlockSize;
   return *this;
 }
 
@@ -181,6 +195,120 @@ bool IFStreamBinary::exists(const string& filename)
 	return opn;
 }
 
+/**
+ * Open a file for streaming write.
+ */
+void	IFStreamBinary::openForWrite(const string& filename, int blockSize)
+{
+	close();
+	clear();
+
+	// write to a temporary file that replaces filename only when close()
+	// succeeds.
+	bTempFileName = filename + ".tmp";
+	bStream = new ofstream(bTempFileName.c_str(), std::ios::out|std::ios::binary);
+	if (!bStream->is_open())
+	{
+		delete bStream;
+		bStream = NULL;
+		ostringstream os;
+		os << endl << "ERROR in IFStreamBinary::openForWrite" << endl
+			 << "Could not open output file: " << bTempFileName << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 9101);
+	}
+
+	bFileName = filename;
+	bFlushed = 0;
+	if (blockSize > 0) bBlockSize = blockSize;
+	bData->reserve(bBlockSize);
+}
+
+/**
+ * Write the remaining buffer to the file opened by openForWrite() and close
+ * the file.
+ */
+void	IFStreamBinary::close()
+{
+	if (bStream == NULL) return;
+
+	// detach the stream before anything can throw so that the destructor does
+	// not try again
+
+	ofstream* ofs = bStream;
+	long long n = bFlushed;
+	bStream = NULL;
+	bFlushed = 0;
+
+	if (bDataPos > bSize) bSize = bDataPos;
+	ofs->write(bData->data(), bSize);
+	n += bSize;
+	ofs->close();
+	bool failed = ofs->fail();
+	delete ofs;
+	clear();
+
+	if (failed)
+	{
+		std::remove(bTempFileName.c_str());
+		ostringstream os;
+		os << endl << "ERROR in IFStreamBinary::close" << endl
+			 << "Error writing " << n << " bytes to file: " << bTempFileName << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 9102);
+	}
+
+	// rename does not replace an existing file on every platform.
+	if (std::rename(bTempFileName.c_str(), bFileName.c_str()) != 0)
+	{
+		std::remove(bFileName.c_str());
+		if (std::rename(bTempFileName.c_str(), bFileName.c_str()) != 0)
+		{
+			std::remove(bTempFileName.c_str());
+			ostringstream os;
+			os << endl << "ERROR in IFStreamBinary::close" << endl
+				 << "Could not rename " << bTempFileName << " to " << bFileName << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 9107);
+		}
+	}
+}
+
+/**
+ * Close the temporary file opened by openForWrite() without writing the
+ * buffer and delete it.
+ */
+void	IFStreamBinary::discard()
+{
+	if (bStream == NULL) return;
+
+	ofstream* ofs = bStream;
+	bStream = NULL;
+	bFlushed = 0;
+
+	ofs->close();
+	delete ofs;
+	clear();
+	std::remove(bTempFileName.c_str());
+}
+
+/**
+ * Write the contents of the buffer to the file opened by openForWrite() and
+ * empty the buffer.
+ */
+void	IFStreamBinary::flushBlock()
+{
+	if (bDataPos > bSize) bSize = bDataPos;
+	bStream->write(bData->data(), bSize);
+	if (bStream->bad())
+	{
+		ostringstream os;
+		os << endl << "ERROR in IFStreamBinary::flushBlock" << endl
+			 << "Error writing " << bFlushed + bSize << " bytes to file: "
+			 << bFileName << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 9102);
+	}
+	bFlushed += bSize;
+	bDataPos = bSize = 0;
+}
+
 /**
  * Write the buffer to the input file name.
  */
@@ -0,0 +1,637 @@
+//- ****************************************************************************
+//- 
+//- Copyright 2009 Sandia Corporation. Under the terms of Contract
+//- DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government
+//- retains certain rights in this software.
+//- 
+//- BSD Open Source License.
+//- All rights reserved.
+//- 
+//- Redistribution and use in source and binary forms, with or without
+//- modification, are permitted provided that the following conditions are met:
+//- 
+//-    * Redistributions of source code must retain the above copyright notice,
+//-      this list of conditions and the following disclaimer.
+//-    * Redistributions in binary form must reproduce the above copyright
+//-      notice, this list of conditions and the following disclaimer in the
+//-      documentation and/or other materials provided with the distribution.
+//-    * Neither the name of Sandia National Laboratories nor the names of its
+//-      contributors may be used to endorse or promote products derived from
+//-      this software without specific prior written permission.
+//- 
+//- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//- AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//- IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//- ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//- LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//- CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//- SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//- INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//- CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//- ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//- POSSIBILITY OF SUCH DAMAGE.
+//-
+//- ****************************************************************************
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+
+#include "CPPUtils.h"
+#include "CpuTimer.h"
+#include "GeoTessGrid.h"
+#include "GeoTessModel.h"
+#include "GeoTessPolygon.h"
+#include "GeoTessPosition.h"
+#include "GeoTessUtils.h"
+#include "IFStreamBinary.h"
+#include "LibCorr3D.h"
+#include "GeoTessBenchmark.h"
+
+using namespace geotess;
+
+/**
+ * Repeatable performance benchmark for the GeoTess and LibCorr3D hot paths.
+ * Everything the benchmark needs is synthesized in memory: an icosahedral
+ * multi-level grid, a 3D model with three layers, a 2D surface model and
+ * a LibCorr3D travel time correction model.  No external model files are
+ * required.  Temporary model files are written to a work directory and
+ * removed when the benchmark completes.
+ * <p>
+ * Results are written to standard output as tab separated records, one per
+ * benchmark, preceded by a single header record:
+ * <pre>
+ * benchmark  count  seconds  nsec_per_op  checksum
+ * </pre>
+ * Lines that begin with '#' describe the configuration and can be ignored
+ * by tools that parse the output.  The checksum is a function of the
+ * computed results; it should not change unless the behavior of the
+ * library changes.
+ * <p>
+ * Usage: geotessbenchmark [workDirectory [gridLevels [nQueries]]]
+ * <br>workDirectory defaults to '.', gridLevels to 6 (10242 vertices on
+ * the top level) and nQueries to 200000.
+ */
+
+/**
+ * Write one benchmark record to standard output.
+ */
+static void report(const string& name, long long count, long long nsec, double checksum)
+{
+	cout << name << "\t" << count << "\t"
+			<< CPPUtils::dtos(nsec * 1e-9, "%.6f") << "\t"
+			<< CPPUtils::dtos(count > 0 ? (double)nsec / count : 0., "%.1f") << "\t"
+			<< CPPUtils::dtos(checksum, "%.8e") << endl;
+}
+
+/**
+ * Write one record for every phase of the load profile collected while
+ * the model was loaded.
+ */
+static void reportLoadProfile(const string& prefix, GeoTessModel& model)
+{
+	const vector<pair<string, double> >& profile = model.getMetaData().getLoadProfile();
+	for (int i = 0; i < (int) profile.size(); ++i)
+	{
+		string phase = profile[i].first;
+		for (int j = 0; j < (int) phase.length(); ++j)
+			if (phase[j] == ' ') phase[j] = '_';
+		report(prefix + "." + phase, 1, (long long) (profile[i].second * 1e9), 0.);
+	}
+}
+
+/**
+ * Build a multi-level grid by recursive subdivision of an icosahedron.
+ * Level 0 has 12 vertices and 20 triangles; each subsequent level splits
+ * every triangle of the previous level into four.  The grid supports a
+ * single tessellation that spans all the levels.
+ */
+static GeoTessGrid* buildIcosahedralGrid(int nLevels, string gridID)
+{
+	double t = (1. + sqrt(5.)) / 2.;
+	double ico[12][3] = { {-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+			{0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+			{t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1} };
+	int icoTriangles[20][3] = { {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10},
+			{0, 10, 11}, {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+			{3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9}, {4, 9, 5},
+			{2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1} };
+
+	vector<double> v;
+	for (int i = 0; i < 12; ++i)
+	{
+		double u[3] = { ico[i][0], ico[i][1], ico[i][2] };
+		GeoTessUtils::normalize(u);
+		v.insert(v.end(), u, u + 3);
+	}
+
+	vector<int> tri;
+	for (int i = 0; i < 20; ++i)
+		tri.insert(tri.end(), icoTriangles[i], icoTriangles[i] + 3);
+
+	// levels[level] = {first triangle, last triangle + 1}
+	vector<int> lev;
+	lev.push_back(0);
+	lev.push_back(20);
+
+	// midpoints of edges that have already been split, keyed on the
+	// (smaller, larger) vertex indices of the edge.
+	map<pair<int, int>, int> midpoints;
+	for (int level = 1; level < nLevels; ++level)
+	{
+		int first = lev[2 * level - 2], last = lev[2 * level - 1];
+		for (int i = first; i < last; ++i)
+		{
+			int c[3] = { tri[3 * i], tri[3 * i + 1], tri[3 * i + 2] }, m[3];
+			for (int e = 0; e < 3; ++e)
+			{
+				int a = c[e], b = c[(e + 1) % 3];
+				pair<int, int> edge(min(a, b), max(a, b));
+				map<pair<int, int>, int>::iterator it = midpoints.find(edge);
+				if (it == midpoints.end())
+				{
+					double u[3] = { v[3 * a] + v[3 * b], v[3 * a + 1] + v[3 * b + 1],
+							v[3 * a + 2] + v[3 * b + 2] };
+					GeoTessUtils::normalize(u);
+					m[e] = midpoints[edge] = (int) v.size() / 3;
+					v.insert(v.end(), u, u + 3);
+				}
+				else
+					m[e] = it->second;
+			}
+			int children[12] = { c[0], m[0], m[2], m[0], c[1], m[1],
+					m[2], m[1], c[2], m[0], m[1], m[2] };
+			tri.insert(tri.end(), children, children + 12);
+		}
+		lev.push_back(last);
+		lev.push_back((int) tri.size() / 3);
+	}
+
+	int nVertices = (int) v.size() / 3;
+	double** vertices = CPPUtils::new2DArray<double>(nVertices, 3);
+	copy(v.begin(), v.end(), vertices[0]);
+
+	// GeoTess requires the vertices of every triangle to be ordered
+	// counter-clockwise when viewed from outside the sphere.
+	int nTriangles = (int) tri.size() / 3;
+	int** triangles = CPPUtils::new2DArray<int>(nTriangles, 3);
+	for (int i = 0; i < nTriangles; ++i)
+	{
+		triangles[i][0] = tri[3 * i];
+		triangles[i][1] = tri[3 * i + 1];
+		triangles[i][2] = tri[3 * i + 2];
+		if (GeoTessUtils::scalarTripleProduct(vertices[triangles[i][0]],
+				vertices[triangles[i][1]], vertices[triangles[i][2]]) > 0.)
+			swap(triangles[i][1], triangles[i][2]);
+	}
+
+	int** levels = CPPUtils::new2DArray<int>(nLevels, 2);
+	copy(lev.begin(), lev.end(), levels[0]);
+
+	int nTessellations = 1;
+	int** tessellations = CPPUtils::new2DArray<int>(1, 2);
+	tessellations[0][0] = 0;
+	tessellations[0][1] = nLevels;
+
+	string inputFile = "null", outputFile = "null";
+	string software = "GeoTessBenchmark", date = CpuTimer::now();
+	return new GeoTessGrid(vertices, nVertices, triangles, nTriangles,
+			levels, nLevels, tessellations, nTessellations,
+			gridID, inputFile, outputFile, software, date);
+}
+
+/**
+ * Fill the metadata entries that every synthetic model shares.
+ */
+static GeoTessMetaData* buildMetaData(const string& description,
+		const string& layerNames, int nLayers,
+		const string& attributeNames, const string& attributeUnits)
+{
+	GeoTessMetaData* metaData = new GeoTessMetaData();
+	metaData->setEarthShape("WGS84");
+	metaData->setDescription(description);
+	metaData->setLayerNames(layerNames);
+	vector<int> layerTessIds(nLayers, 0);
+	metaData->setLayerTessIds(layerTessIds);
+	metaData->setAttributes(attributeNames, attributeUnits);
+	metaData->setDataType(GeoTessDataType::FLOAT);
+	metaData->setModelSoftwareVersion("GeoTessBenchmark " + GeoTessUtils::getVersion());
+	metaData->setModelGenerationDate(CpuTimer::now());
+	return metaData;
+}
+
+/**
+ * Populate every profile of a model with smoothly varying values.  Layer
+ * boundaries are given by layerRadii (nLayers+1 entries) and each layer
+ * receives nNodes[layer] radial nodes.
+ */
+static void populateModel(GeoTessModel& model, const vector<float>& layerRadii,
+		const vector<int>& nNodes)
+{
+	int nAttributes = model.getMetaData().getNAttributes();
+	for (int vertex = 0; vertex < model.getNVertices(); ++vertex)
+	{
+		const double* u = model.getGrid().getVertex(vertex);
+		for (int layer = 0; layer < (int) nNodes.size(); ++layer)
+		{
+			vector<float> radii;
+			vector<vector<float> > values;
+			float r0 = layerRadii[layer], r1 = layerRadii[layer + 1];
+			for (int k = 0; k < nNodes[layer]; ++k)
+			{
+				float r = nNodes[layer] == 1 ? r1 : r0 + k * (r1 - r0) / (nNodes[layer] - 1);
+				radii.push_back(r);
+				vector<float> v(nAttributes);
+				for (int a = 0; a < nAttributes; ++a)
+					v[a] = (float) ((a + 1) * (8. + layer + 0.5 * u[0] * u[1]
+							+ 0.25 * sin(3. * u[2]) + 0.1 * sin(r / 150.)));
+				values.push_back(v);
+			}
+			model.setProfile(vertex, layer, radii, values);
+		}
+	}
+}
+
+/**
+ * Build a 3D model with three layers on the supplied grid.
+ */
+static GeoTessModel* build3DModel(GeoTessGrid* grid)
+{
+	GeoTessMetaData* metaData = buildMetaData("GeoTessBenchmark 3D model\n",
+			"LOWER_MANTLE; UPPER_MANTLE; CRUST", 3,
+			"PSLOWNESS; SSLOWNESS", "sec/km; sec/km");
+
+	GeoTessModel* model = new GeoTessModel(grid, metaData);
+
+	vector<float> radii;
+	radii.push_back(3480.F);
+	radii.push_back(5711.F);
+	radii.push_back(6336.F);
+	radii.push_back(6371.F);
+
+	vector<int> nNodes;
+	nNodes.push_back(12);
+	nNodes.push_back(8);
+	nNodes.push_back(3);
+
+	populateModel(*model, radii, nNodes);
+	return model;
+}
+
+/**
+ * Build a 2D model with one value per vertex on the supplied grid.
+ */
+static GeoTessModel* build2DModel(GeoTessGrid* grid)
+{
+	GeoTessMetaData* metaData = buildMetaData("GeoTessBenchmark 2D model\n",
+			"SURFACE", 1, "SLOWNESS", "sec/km");
+
+	GeoTessModel* model = new GeoTessModel(grid, metaData);
+	for (int vertex = 0; vertex < model->getNVertices(); ++vertex)
+	{
+		const double* u = grid->getVertex(vertex);
+		vector<float> values(1, (float) (0.125 + 0.01 * u[0] * u[2] + 0.005 * cos(4. * u[1])));
+		model->setProfile(vertex, values);
+	}
+	return model;
+}
+
+/**
+ * A GeoTessModel that writes the station information that LibCorr3DModel
+ * expects to find after the GeoTess data (file format version 2), so
+ * that the synthetic model can be loaded through LibCorr3D::loadModel().
+ */
+class BenchmarkLibCorr3DModel : public GeoTessModel
+{
+public:
+
+	BenchmarkLibCorr3DModel(GeoTessGrid* grid, GeoTessMetaData* metaData) :
+		GeoTessModel(grid, metaData) {}
+
+protected:
+
+	void writeModelBinary(IFStreamBinary& output, const string& gridFileName)
+	{
+		GeoTessModel::writeModelBinary(output, gridFileName);
+
+		output.writeString("LibCorr3DModel");
+		output.writeInt(2);
+		output.writeString("BENCH");          // sta
+		output.writeDouble(NA_VALUE);         // on time
+		output.writeDouble(NA_VALUE);         // off time
+		output.writeDouble(35.);              // station lat, degrees
+		output.writeDouble(-106.);            // station lon, degrees
+		output.writeDouble(1.5);              // station elevation, km
+		output.writeString("GeoTessBenchmark station");
+		output.writeString("ss");
+		output.writeString("BENCH");          // refsta
+		output.writeDouble(0.);               // dnorth
+		output.writeDouble(0.);               // deast
+		output.writeString("P");              // phase
+		output.writeString("P, Pn");          // supported phases
+		output.writeString("TT");
+		output.writeString("synthetic travel time corrections");
+		output.writeString("ak135");
+		output.writeString("1.0");
+	}
+};
+
+/**
+ * Generate n random unit vectors uniformly distributed on the sphere.
+ */
+static void randomVectors(mt19937& rng, int n, vector<double>& u)
+{
+	normal_distribution<double> gauss;
+	u.resize(3 * n);
+	for (int i = 0; i < n; ++i)
+	{
+		double* x = &u[3 * i];
+		do
+		{
+			x[0] = gauss(rng);
+			x[1] = gauss(rng);
+			x[2] = gauss(rng);
+		}
+		while (GeoTessUtils::normalize(x) == 0.);
+	}
+}
+
+/**
+ * Generate n unit vectors that sweep the globe in serpentine latitude
+ * rows so that consecutive points are geographic neighbors.
+ */
+static void orderedVectors(int n, vector<double>& u)
+{
+	int nRows = max(1, (int) sqrt((double) n / 2.));
+	int nCols = (n + nRows - 1) / nRows;
+	u.resize(3 * n);
+	for (int i = 0; i < n; ++i)
+	{
+		int row = i / nCols, col = i % nCols;
+		if (row % 2 == 1) col = nCols - 1 - col;
+		double lat = -89.5 + 179. * (row + 0.5) / nRows;
+		double lon = -180. + 360. * (col + 0.5) / nCols;
+		GeoTessUtils::getVectorDegrees(lat, lon, &u[3 * i]);
+	}
+}
+
+/**
+ * Time n calls to GeoTessPosition::set() + getValue() at the supplied
+ * unit vectors and radii.
+ */
+static void benchmarkPositions(GeoTessModel& model, const string& name,
+		const GeoTessInterpolatorType& horizontalType,
+		const GeoTessInterpolatorType& radialType,
+		const vector<double>& u, const vector<double>& radii)
+{
+	GeoTessPosition* pos = model.getPosition(horizontalType, radialType);
+	int n = (int) radii.size();
+	double sum = 0.;
+
+	long long start = CpuTimer::getNanoTime();
+	for (int i = 0; i < n; ++i)
+	{
+		pos->set(&u[3 * i], radii[i]);
+		sum += pos->getValue(0);
+	}
+	long long elapsed = CpuTimer::getNanoTime() - start;
+
+	report(name + "." + horizontalType.toString() + "." + radialType.toString(),
+			n, elapsed, sum);
+	delete pos;
+}
+
+/**
+ * Write the model to file, read it back and report the elapsed times and
+ * the size of the file.
+ */
+static void benchmarkIO(GeoTessModel& model, const string& name, const string& fileName)
+{
+	long long start = CpuTimer::getNanoTime();
+	model.writeModel(fileName, "*");
+	long long elapsed = CpuTimer::getNanoTime() - start;
+
+	// the checksum of the write records is the size of the file in bytes
+	ifstream file(fileName.c_str(), ios::binary | ios::ate);
+	report("write_" + name, 1, elapsed, (double) file.tellg());
+	file.close();
+
+	start = CpuTimer::getNanoTime();
+	GeoTessModel* loaded = new GeoTessModel(fileName);
+	report("load_" + name, 1, CpuTimer::getNanoTime() - start,
+			(double) loaded->getNPoints());
+	reportLoadProfile("load_" + name, *loaded);
+	delete loaded;
+
+	remove(fileName.c_str());
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		string workDir = argc > 1 ? argv[1] : ".";
+		int nLevels = argc > 2 ? atoi(argv[2]) : 6;
+		int nQueries = argc > 3 ? atoi(argv[3]) : 200000;
+		if (nLevels < 1 || nQueries < 1)
+		{
+			cout << "Usage: geotessbenchmark [workDirectory [gridLevels [nQueries]]]" << endl;
+			return -1;
+		}
+		int nPaths = max(10, nQueries / 200);
+		int nPolygonQueries = max(1, nQueries / 10);
+
+		mt19937 rng(20091);
+
+		cout << "# GeoTess version " << GeoTessUtils::getVersion()
+				<< ", LibCorr3D version " << LibCorr3D::getVersion() << endl;
+		cout << "benchmark\tcount\tseconds\tnsec_per_op\tchecksum" << endl;
+
+		long long start = CpuTimer::getNanoTime();
+		GeoTessGrid* grid = buildIcosahedralGrid(nLevels, "GEOTESS_BENCHMARK_GRID");
+		report("build_grid", 1, CpuTimer::getNanoTime() - start, grid->getNVertices());
+
+		start = CpuTimer::getNanoTime();
+		GeoTessModel* model3D = build3DModel(grid);
+		GeoTessModel* model2D = build2DModel(grid);
+		report("build_models", 1, CpuTimer::getNanoTime() - start,
+				model3D->getNPoints() + model2D->getNPoints());
+
+		cout << "# grid levels " << nLevels << ", vertices " << grid->getNVertices()
+				<< ", triangles " << grid->getNTriangles() << endl;
+		cout << "# 3D model points " << model3D->getNPoints()
+				<< ", queries " << nQueries << ", paths " << nPaths << endl;
+
+		// **** model input / output ****
+
+		benchmarkIO(*model3D, "binary", CPPUtils::insertPathSeparator(workDir,
+				"geotess_benchmark_3d.geotess"));
+		benchmarkIO(*model3D, "ascii", CPPUtils::insertPathSeparator(workDir,
+				"geotess_benchmark_3d.ascii"));
+
+		model3D->getMetaData().setCompressed(true);
+		benchmarkIO(*model3D, "compressed", CPPUtils::insertPathSeparator(workDir,
+				"geotess_benchmark_3d_compressed.geotess"));
+		model3D->getMetaData().setQuantization(0, 1e-6);
+		model3D->getMetaData().setQuantization(1, 1e-6);
+		benchmarkIO(*model3D, "quantized", CPPUtils::insertPathSeparator(workDir,
+				"geotess_benchmark_3d_quantized.geotess"));
+		model3D->getMetaData().setCompressed(false);
+
+		// **** GeoTessPosition interpolation ****
+
+		vector<double> randomU, orderedU;
+		randomVectors(rng, nQueries, randomU);
+		orderedVectors(nQueries, orderedU);
+
+		uniform_real_distribution<double> radius(3500., 6370.);
+		vector<double> randomRadii(nQueries), orderedRadii(nQueries);
+		for (int i = 0; i < nQueries; ++i)
+		{
+			randomRadii[i] = radius(rng);
+			// ordered queries sweep radius slowly so that consecutive
+			// queries usually fall in the same profile interval.
+			orderedRadii[i] = 3500. + 2870. * i / nQueries;
+		}
+
+		const GeoTessInterpolatorType* horizontal[2] = { &GeoTessInterpolatorType::LINEAR,
+				&GeoTessInterpolatorType::NATURAL_NEIGHBOR };
+		const GeoTessInterpolatorType* radial[2] = { &GeoTessInterpolatorType::LINEAR,
+				&GeoTessInterpolatorType::CUBIC_SPLINE };
+		for (int h = 0; h < 2; ++h)
+			for (int r = 0; r < 2; ++r)
+			{
+				benchmarkPositions(*model3D, "position_random", *horizontal[h],
+						*radial[r], randomU, randomRadii);
+				benchmarkPositions(*model3D, "position_ordered", *horizontal[h],
+						*radial[r], orderedU, orderedRadii);
+			}
+
+		// **** 2D path integrals and weights ****
+
+		vector<double> pathEnds;
+		randomVectors(rng, 2 * nPaths, pathEnds);
+		double pointSpacing = CPPUtils::toRadians(0.1);
+		for (int h = 0; h < 2; ++h)
+		{
+			double sum = 0.;
+			start = CpuTimer::getNanoTime();
+			for (int i = 0; i < nPaths; ++i)
+				sum += model2D->getPathIntegral2D(0, &pathEnds[6 * i], &pathEnds[6 * i + 3],
+						pointSpacing, -1., *horizontal[h]);
+			report("path_integral_2d." + horizontal[h]->toString(), nPaths,
+					CpuTimer::getNanoTime() - start, sum);
+
+			sum = 0.;
+			map<int, double> weights;
+			start = CpuTimer::getNanoTime();
+			for (int i = 0; i < nPaths; ++i)
+			{
+				model2D->getWeights(&pathEnds[6 * i], &pathEnds[6 * i + 3],
+						pointSpacing, -1., *horizontal[h], weights);
+				sum += weights.size();
+			}
+			report("weights_2d." + horizontal[h]->toString(), nPaths,
+					CpuTimer::getNanoTime() - start, sum);
+		}
+
+		// **** active regions and polygons ****
+
+		double center[3];
+		GeoTessUtils::getVectorDegrees(30., 45., center);
+		GeoTessPolygon* polygon = new GeoTessPolygon(center, CPPUtils::toRadians(40.), 1000);
+		// keep ownership of the polygon; the point map would otherwise
+		// delete it when the active region is reset.
+		polygon->addReference();
+
+		for (int indexed = 0; indexed < 2; ++indexed)
+		{
+			string suffix = indexed ? ".indexed" : "";
+			if (indexed)
+			{
+				start = CpuTimer::getNanoTime();
+				polygon->buildIndex();
+				report("polygon_build_index", 1, CpuTimer::getNanoTime() - start, 0.);
+			}
+
+			int nIn = 0;
+			start = CpuTimer::getNanoTime();
+			for (int i = 0; i < nPolygonQueries; ++i)
+				if (polygon->contains(&randomU[3 * i]))
+					++nIn;
+			report("polygon_contains" + suffix, nPolygonQueries,
+					CpuTimer::getNanoTime() - start, nIn);
+
+			start = CpuTimer::getNanoTime();
+			model3D->setActiveRegion(polygon);
+			report("set_active_region" + suffix, 1, CpuTimer::getNanoTime() - start,
+					model3D->getNPoints());
+		}
+
+		start = CpuTimer::getNanoTime();
+		model3D->setActiveRegion();
+		report("set_active_region.global", 1, CpuTimer::getNanoTime() - start,
+				model3D->getNPoints());
+
+		polygon->removeReference();
+		delete polygon;
+
+		// **** LibCorr3D ****
+
+		GeoTessMetaData* metaData = buildMetaData("GeoTessBenchmark LibCorr3D model\n",
+				"MANTLE", 1, "TT_DELTA_AK135; TT_MODEL_UNCERTAINTY", "seconds; seconds");
+		BenchmarkLibCorr3DModel* lc3dModel = new BenchmarkLibCorr3DModel(
+				buildIcosahedralGrid(nLevels, "GEOTESS_BENCHMARK_LIBCORR3D_GRID"), metaData);
+		vector<float> lc3dRadii(1, 5671.F);
+		lc3dRadii.push_back(6371.F);
+		populateModel(*lc3dModel, lc3dRadii, vector<int>(1, 8));
+
+		string lc3dFile = "geotess_benchmark_libcorr3d.geotess";
+		lc3dModel->writeModel(CPPUtils::insertPathSeparator(workDir, lc3dFile), "*");
+		delete lc3dModel;
+
+		LibCorr3D libcorr3d(workDir);
+		start = CpuTimer::getNanoTime();
+		int handle = libcorr3d.loadModel(lc3dFile);
+		report("libcorr3d_load_model", 1, CpuTimer::getNanoTime() - start, handle);
+		if (libcorr3d.getCurrentErrorCode() != 0)
+			throw GeoTessException(libcorr3d.getCurrentErrorMessage(), __FILE__, __LINE__, 109);
+
+		uniform_real_distribution<double> depth(0., 700.);
+		vector<double> depths(nQueries);
+		for (int i = 0; i < nQueries; ++i)
+			depths[i] = depth(rng);
+
+		double sum = 0., value, uncertainty;
+		start = CpuTimer::getNanoTime();
+		for (int i = 0; i < nQueries; ++i)
+		{
+			double* u = &randomU[3 * i];
+			libcorr3d.setInterpolationLocation(u, GeoTessUtils::getEarthRadius(u) - depths[i]);
+			if (libcorr3d.getModelResult(handle, value, uncertainty))
+				sum += value + uncertainty;
+		}
+		report("libcorr3d_get_model_result", nQueries, CpuTimer::getNanoTime() - start, sum);
+
+		remove(CPPUtils::insertPathSeparator(workDir, lc3dFile).c_str());
+
+		delete model2D;
+		delete model3D;
+	}
+	catch (GeoTessException& ex)
+	{
+		cout << ex.emessage << endl;
+		return 1;
+	}
+	catch(...)
+	{
+		cout << endl << "Unidentified error detected " << endl
+			<<  __FILE__ << "  " << __LINE__ << endl;
+		return 2;
+	}
+
+	return 0;
+}
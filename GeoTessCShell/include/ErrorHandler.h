@@ -61,6 +61,47 @@ GEO_TESS_EXPORT_C char* error_getMessage();
  */
 GEO_TESS_EXPORT_C void error_clean();
 
+/**
+ * Returns whether or not (1 or 0) an error has occurred on the calling thread
+ * since the last call to error_clearLast().
+ * <p>Every error is recorded in storage that is private to the thread that
+ * raised it, in addition to the shared stack read by error_exists() and
+ * error_getMessage().  Threads that share the C shell should use
+ * error_clearLast(), error_lastExists() and error_getLastMessage(), which
+ * only see the errors raised by the calling thread.
+ */
+GEO_TESS_EXPORT_C int error_lastExists();
+
+/**
+ * Copies the most recent error message raised on the calling thread into a
+ * caller supplied buffer.  The message is truncated if necessary and is
+ * always terminated with a null character.  No memory is allocated and the
+ * message remains available until error_clearLast() is called or another
+ * error occurs on the same thread.
+ * @param buffer the array that receives the message.  May be NULL.
+ * @param size the number of chars in buffer.
+ * @return the length of the complete message, which exceeds size-1 if the
+ * message was truncated, or 0 if no error has occurred on this thread since
+ * the last call to error_clearLast().
+ */
+GEO_TESS_EXPORT_C int error_getLastMessage(char* buffer, int size);
+
+/**
+ * Forgets the most recent error message raised on the calling thread, so
+ * that error_lastExists() returns 0 until another error occurs.
+ */
+GEO_TESS_EXPORT_C void error_clearLast();
+
+/**
+ * Specifies whether error messages are pushed onto the shared stack read by
+ * error_exists() and error_getMessage().  The default is 1.  Applications
+ * that retrieve errors only with error_getLastMessage() can specify 0, in
+ * which case failed calls do not contend for the shared stack or leave
+ * messages on it.
+ * @param enabled 1 to push messages onto the shared stack, 0 otherwise.
+ */
+GEO_TESS_EXPORT_C void error_setSharedCache(int enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -537,6 +537,19 @@ GEO_TESS_EXPORT_C int geogrid_getLastTriangle(GeoTessGridC* grid, int tessId, in
  */
 GEO_TESS_EXPORT_C int** geogrid_getTriangles(GeoTessGridC* grid);
 
+/**
+ * Copy the indexes of the 3 vertices that define each triangle of the
+ * tessellation into a caller supplied array, 3 consecutive elements per
+ * triangle.  If the grid has more than 'capacity' triangles, nothing is
+ * written; call with capacity 0 to retrieve the number of triangles.
+ *
+ * @param grid the grid struct to operate on.
+ * @param triangles array of at least 3*capacity elements.
+ * @param capacity the number of triangles that fit in 'triangles'.
+ * @return the number of triangles in the grid, or -1 if an error occurred.
+ */
+GEO_TESS_EXPORT_C int geogrid_copyTriangles(GeoTessGridC* grid, int* triangles, int capacity);
+
 /**
  * Retrieve an int[3] array containing the indexes of the vertices that form
  * the corners of the triangle with index triangleIndex.
@@ -1020,6 +1033,25 @@ GEO_TESS_EXPORT_C char* geogrid_getGridOutputFile(GeoTessGridC* grid);
 GEO_TESS_EXPORT_C void geogrid_getVertices(GeoTessGridC* grid, int tessId, int level,
 		double*** vertices, int* nVertices, int* allocatedSize);
 
+/**
+ * Copy the unit vectors of the vertices that define the specified level of
+ * the specified tessellation into a caller supplied array, 3 consecutive
+ * elements per vertex.  The vertices are the same as those returned by
+ * geogrid_getVertices(), but no memory is allocated.  If there are more than
+ * 'capacity' vertices, nothing is written and the required capacity is
+ * returned, so the caller can enlarge the array and call again.
+ *
+ * @param grid (input) the grid struct to operate on.
+ * @param tessId (input) tessellation index
+ * @param level index of a level relative to the first level of the specified tessellation.
+ * @param vertices (output) array of at least 3*capacity elements.
+ * @param capacity the number of vertices that fit in 'vertices'.
+ * @return the number of vertices, which may exceed 'capacity', or -1 if an
+ * error occurred.
+ */
+GEO_TESS_EXPORT_C int geogrid_copyVertices(GeoTessGridC* grid, int tessId, int level,
+		double* vertices, int capacity);
+
 #ifdef __cplusplus
 }
 #endif
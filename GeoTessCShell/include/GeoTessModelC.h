@@ -1030,6 +1030,44 @@ GEO_TESS_EXPORT_C short geomodel_getPointValueShort(GeoTessModelC* gtm,
 GEO_TESS_EXPORT_C byte geomodel_getPointValueByte(GeoTessModelC* gtm,
 		int pointIndex, int attributeIndex);
 
+/**
+ * Copy the values of one attribute at every point in the model into a
+ * caller supplied array, cast to double if necessary.  This is equivalent
+ * to calling geomodel_getPointValueDouble() for every point, without the
+ * per-point call overhead.
+ *
+ * <p>If the model has more than 'capacity' points, nothing is written
+ * and the required capacity is returned, so the caller can enlarge the
+ * array and call again.
+ *
+ * @param gtm the GeoTessModelC to use.
+ * @param attributeIndex the attributeIndex
+ * @param values array of 'capacity' elements that receives the value of
+ * the attribute at each point, in point order.
+ * @param capacity the number of elements in 'values'
+ * @return the number of points in the model, which may exceed 'capacity',
+ * or -1 if an error occurred.
+ */
+GEO_TESS_EXPORT_C int geomodel_getPointValues(GeoTessModelC* gtm,
+		int attributeIndex, double* values, int capacity);
+
+/**
+ * Modify the values of one attribute at every point in the model.
+ *
+ * <p>If the model has more than 'capacity' points, nothing is modified
+ * and the number of points is returned.
+ *
+ * @param gtm the GeoTessModelC to use.
+ * @param attributeIndex the attributeIndex
+ * @param values array of 'capacity' elements holding the new attribute
+ * value at each point, in point order.
+ * @param capacity the number of elements in 'values'
+ * @return the number of points in the model, which may exceed 'capacity',
+ * or -1 if an error occurred.
+ */
+GEO_TESS_EXPORT_C int geomodel_setPointValues(GeoTessModelC* gtm,
+		int attributeIndex, double* values, int capacity);
+
 /**
  * Modify the attribute value stored at the specified vertex, layer, node, attribute.
  * @param gtm the GeoTessModelC to use.
@@ -1541,6 +1579,35 @@ GEO_TESS_EXPORT_C void geomodel_getWeights2D(GeoTessModelC* gtm,
 		InterpolatorTypeC horizontalType,
 		int** pointIndices, double** weights, int* allocatedSize, int* actualSize);
 
+/**
+ * Compute the same weights as geomodel_getWeights2D(), writing them into
+ * caller supplied arrays instead of arrays allocated by this function.
+ *
+ * <p>If the path touches more than 'capacity' points, nothing is written
+ * and the required capacity is returned, so the caller can enlarge the
+ * arrays and call again.
+ *
+ * @param gtm a GeoTessModel
+ * @param firstPoint unit vector of the first point on the great circle path
+ * @param lastPoint unit vector of the last point on the great circle path
+ * @param pointSpacing maximum point separation in radians.
+ * @param earthRadius the radius of the great circle path, in km.  If the value is less than or
+ * equal to zero then the radius of the Earth determined by the current EarthShape is used.
+ * @param horizontalType (input) the type of interpolator to use in the geographic
+ * dimensions, either LINEAR or NATURAL_NEIGHBOR
+ * @param pointIndices array of 'capacity' elements that receives the
+ * indexes of the model points touched by the path, in increasing order.
+ * @param weights array of 'capacity' elements that receives the weight
+ * associated with each point index in 'pointIndices'
+ * @param capacity the number of elements in 'pointIndices' and 'weights'
+ * @return the number of points touched by the path, which may exceed
+ * 'capacity', or -1 if an error occurred.
+ */
+GEO_TESS_EXPORT_C int geomodel_copyWeights2D(GeoTessModelC* gtm,
+		double* firstPoint, double* lastPoint, double pointSpacing, double earthRadius,
+		InterpolatorTypeC horizontalType,
+		int* pointIndices, double* weights, int capacity);
+
 /**
  * Compute the weights on each model point that results from interpolating positions
  * along the specified ray path.  The following procedure is implemented:
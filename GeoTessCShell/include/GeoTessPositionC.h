@@ -162,6 +162,27 @@ GEO_TESS_EXPORT_C InterpolatorTypeC	geoposition_getInterpolatorType(GeoTessPosit
  */
 GEO_TESS_EXPORT_C double geoposition_getValue(GeoTessPositionC* gtp, int attribute);
 
+/**
+ * Interpolate the values of all the model attributes at each of n
+ * positions.  This is equivalent to calling geoposition_set2() followed by
+ * geoposition_getValue() for every attribute at each position, in a single
+ * call.  On return the GeoTessPosition is left at the last position.
+ *
+ * @param gtp - The GeoTessPositionC to use.
+ * @param uVectors array of 3*n elements holding the unit vector of each
+ * position, one after the other.
+ * @param radii array of n elements holding the radius of each position, in km.
+ * @param n the number of positions.
+ * @param values array of at least n*nAttributes elements that receives
+ * the values, with the nAttributes values of each position stored
+ * contiguously.
+ * @return the number of positions at which an error occurred.  Their
+ * values are set to the error value of the GeoTessPosition.  If the
+ * model cannot be accessed at all, nothing is written and n is returned.
+ */
+GEO_TESS_EXPORT_C int geoposition_getValues(GeoTessPositionC* gtp, const double* uVectors,
+		const double* radii, int n, double* values);
+
 /**
  * Returns true if the current interpolation position has no empty profiles
  * @param gtp - The GeoTessPositionC to use.
@@ -600,6 +621,21 @@ GEO_TESS_EXPORT_C int geoposition_getIndexOfClosestVertex(GeoTessPositionC* gtp)
  */
 GEO_TESS_EXPORT_C void geoposition_getCoefficients(GeoTessPositionC* gtp, int** points, double** coeffs, int* size);
 
+/**
+ * Copy the interpolation coefficients of the current position into caller
+ * supplied arrays, instead of arrays allocated by this function.  If there
+ * are more than 'capacity' coefficients, nothing is written and the
+ * required capacity is returned.
+ * @param gtp - The GeoTessPosition to use.
+ * @param points - array of 'capacity' elements that receives the point indexes.
+ * @param coeffs - array of 'capacity' elements that receives the coefficients
+ * that correlate 1 to 1 with the points.
+ * @param capacity - the number of elements in points and coeffs.
+ * @return the number of coefficients, which may exceed 'capacity', or -1 if
+ * an error occurred.
+ */
+GEO_TESS_EXPORT_C int geoposition_copyCoefficients(GeoTessPositionC* gtp, int* points, double* coeffs, int capacity);
+
 /**
  * Retrieve the index of the tessellation level of the triangle that was
  * found the last time that the walking triangle algorithm was executed.
@@ -111,6 +111,14 @@ int* getIntArr(std::set<int>* s);
  */
 int* getIntArr(const std::set<int>& s);
 
+/**
+ * Copies an array of ints into a newly malloc'ed int*.
+ * @param u - The array to copy.
+ * @param size - The number of elements in u.
+ * @return An int* pointing to a copy of the first size elements of u.
+ */
+int* getIntArr(const int* u, int size);
+
 /**
  * Converts a char** to a string*.
  * @param arr - The array of strings to convert.
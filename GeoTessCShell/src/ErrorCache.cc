@@ -52,6 +52,9 @@ HANDLE lock = CreateMutex( NULL, FALSE, NULL );
 #include "_ErrorCache.h"
 #include "ErrorHandler.h"
 #include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <atomic>
 
 #define DEF_LIM 20
 
@@ -59,6 +62,14 @@ int ec_limit = DEF_LIM;
 ErrorCache* theCache = NULL;
 int numRefs = 0;
 
+// the most recent error message raised on each thread, and whether it
+// has been cleared.  The string keeps its capacity between errors.
+static thread_local std::string lastError;
+static thread_local bool lastErrorSet = false;
+
+// when zero, messages are recorded only in the thread local storage.
+static std::atomic<int> sharedCache(1);
+
 ErrorCache* ec_create()
 {
 	LOCK
@@ -82,6 +93,15 @@ ErrorCache* ec_create()
 
 void ec_push(ErrorCache* e, char* message)
 {
+	lastError.assign(message ? message : "");
+	lastErrorSet = true;
+
+	if (!sharedCache.load(std::memory_order_relaxed))
+	{
+		free(message);
+		return;
+	}
+
 	LOCK
 	int limit = e->limit;
 	if (e->pos == limit)
@@ -105,7 +125,10 @@ char* ec_pop(ErrorCache* e)
 {
 	LOCK
 	if (e->pos == 0)
+	{
+		UNLOCK
 		return NULL;
+	}
 	char* ret = e->msgs[e->pos - 1];
 	e->msgs[--e->pos] = NULL;
 	UNLOCK
@@ -114,7 +137,10 @@ char* ec_pop(ErrorCache* e)
 
 int ec_hasError(ErrorCache* e)
 {
-	return e->pos ? 1 : 0;
+	LOCK
+	int ret = e->pos ? 1 : 0;
+	UNLOCK
+	return ret;
 }
 
 void ec_destroy(ErrorCache* e)
@@ -165,3 +191,50 @@ GEO_TESS_EXPORT_C void error_clean()
 	for (i = 0; i < num; i++)
 		ec_destroy(theCache);
 }
+
+/**
+ * Returns whether or not an error has occurred on the calling thread since
+ * the last call to error_clearLast().
+ */
+int error_lastExists()
+{
+	return lastErrorSet ? 1 : 0;
+}
+
+/**
+ * Copies the most recent error message raised on the calling thread into
+ * the caller supplied buffer, truncating it if necessary.
+ */
+int error_getLastMessage(char* buffer, int size)
+{
+	if (!lastErrorSet)
+	{
+		if (buffer && size > 0)
+			buffer[0] = 0;
+		return 0;
+	}
+	if (buffer && size > 0)
+	{
+		int n = (int) lastError.length() < size-1 ? (int) lastError.length() : size-1;
+		memcpy(buffer, lastError.c_str(), n);
+		buffer[n] = 0;
+	}
+	return (int) lastError.length();
+}
+
+/**
+ * Forgets the most recent error message raised on the calling thread.
+ */
+void error_clearLast()
+{
+	lastErrorSet = false;
+}
+
+/**
+ * Specifies whether error messages are also pushed onto the shared stack
+ * read by error_exists() and error_getMessage().
+ */
+void error_setSharedCache(int enabled)
+{
+	sharedCache.store(enabled ? 1 : 0);
+}
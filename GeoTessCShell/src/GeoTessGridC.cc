@@ -242,7 +242,7 @@ GEO_TESS_EXPORT_C char* geogrid_getGridIDFile(char* fileName)
 	catch (exception& e)
 	{
 		ErrorCache* erc = ec_create();
-		ec_push(erc, (char*) e.what());
+		ec_push(erc, getCharsFromString(e.what()));
 		ec_destroy(erc);
 	}
 	return NULL;
@@ -523,6 +523,40 @@ GEO_TESS_EXPORT_C void geogrid_getVertices(GeoTessGridC* g, int tessellation,
 	*num = -1;
 }
 
+GEO_TESS_EXPORT_C int geogrid_copyVertices(GeoTessGridC* g, int tessellation,
+		int level, double* vertices, int capacity)
+{
+	try
+	{
+		set<const double*> s;
+		getcpp(g)->getVertices(tessellation, level, s);
+		int num = (int) s.size();
+		if (num <= capacity)
+		{
+			double* v = vertices;
+			for (set<const double*>::const_iterator it = s.begin(); it != s.end(); ++it, v += 3)
+			{
+				v[0] = (*it)[0];
+				v[1] = (*it)[1];
+				v[2] = (*it)[2];
+			}
+		}
+		return num;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(g->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		std::stringstream sstm;
+		sstm << ERR_MSG << __FILE__ << " on " << __LINE__;
+		string s = sstm.str();
+		ec_push(g->err, getCharsFromString(s));
+	}
+	return -1;
+}
+
 GEO_TESS_EXPORT_C void geogrid_getVerticesTopLevel(GeoTessGridC* g,
 		int tessellation, double*** vv, int* num, int* allocatedSize)
 {
@@ -793,6 +827,38 @@ GEO_TESS_EXPORT_C int** geogrid_getTriangles(GeoTessGridC* g)
 	return NULL;
 }
 
+GEO_TESS_EXPORT_C int geogrid_copyTriangles(GeoTessGridC* g, int* triangles, int capacity)
+{
+	try
+	{
+		GeoTessGrid* grid = getcpp(g);
+		int n = grid->getNTriangles();
+		if (n <= capacity)
+		{
+			int const* const* t = grid->getTriangles();
+			for (int i = 0; i < n; ++i)
+			{
+				triangles[3*i] = t[i][0];
+				triangles[3*i+1] = t[i][1];
+				triangles[3*i+2] = t[i][2];
+			}
+		}
+		return n;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(g->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		std::stringstream sstm;
+		sstm << ERR_MSG << __FILE__ << " on " << __LINE__;
+		string s = sstm.str();
+		ec_push(g->err, getCharsFromString(s));
+	}
+	return -1;
+}
+
 GEO_TESS_EXPORT_C int* geogrid_getTriangleVertexIndexes(GeoTessGridC* g,
 		int triangleIndex)
 {
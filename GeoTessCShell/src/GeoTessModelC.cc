@@ -1050,6 +1050,50 @@ GEO_TESS_EXPORT_C byte geomodel_getPointValueByte(GeoTessModelC* gtm,
 	return CHAR_MIN;
 }
 
+GEO_TESS_EXPORT_C int geomodel_getPointValues(GeoTessModelC* gtm,
+		int attributeIndex, double* values, int capacity)
+{
+	try
+	{
+		GeoTessPointMap* m = get_model(gtm)->getPointMap();
+		int size = m->size();
+		if (size <= capacity)
+			m->getPointValues(attributeIndex, values);
+		return size;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(gtm->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		ec_push(gtm->err, getCharsFromString(etos(ERR_MSG, __FILE__, __LINE__)));
+	}
+	return -1;
+}
+
+GEO_TESS_EXPORT_C int geomodel_setPointValues(GeoTessModelC* gtm,
+		int attributeIndex, double* values, int capacity)
+{
+	try
+	{
+		GeoTessPointMap* m = get_model(gtm)->getPointMap();
+		int size = m->size();
+		if (size <= capacity)
+			m->setPointValues(attributeIndex, values);
+		return size;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(gtm->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		ec_push(gtm->err, getCharsFromString(etos(ERR_MSG, __FILE__, __LINE__)));
+	}
+	return -1;
+}
+
 GEO_TESS_EXPORT_C void geomodel_setPointRadius(GeoTessModelC* gtm, int pointIndex, float radius)
 {
 	try
@@ -1933,6 +1977,40 @@ GEO_TESS_EXPORT_C void geomodel_getWeights2D(GeoTessModelC* gtm,
 	}
 }
 
+GEO_TESS_EXPORT_C int geomodel_copyWeights2D(GeoTessModelC* gtm,
+		double* firstPoint, double* lastPoint, double pointSpacing, double earthRadius,
+		InterpolatorTypeC horizontalType,
+		int* pointIndices, double* weights, int capacity)
+{
+	try
+	{
+		map<int, double> m;
+		get_model(gtm)->getWeights(firstPoint, lastPoint, pointSpacing, earthRadius,
+				*getInterpolatorType(horizontalType), m);
+
+		int size = (int) m.size();
+		if (size <= capacity)
+		{
+			int i = 0;
+			for (map<int, double>::iterator it = m.begin(); it != m.end(); ++it, ++i)
+			{
+				pointIndices[i] = it->first;
+				weights[i] = it->second;
+			}
+		}
+		return size;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(gtm->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		ec_push(gtm->err, getCharsFromString(etos(ERR_MSG, __FILE__, __LINE__)));
+	}
+	return -1;
+}
+
 GEO_TESS_EXPORT_C void geomodel_getWeights3D(GeoTessModelC* gtm, double** rayPath,
 		double* radii, int* layerIds, int pathSize, InterpolatorTypeC horizontalType,
 		InterpolatorTypeC radialType, int** pointIndices, double** weights,
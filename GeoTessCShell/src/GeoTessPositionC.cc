@@ -158,6 +158,59 @@ GEO_TESS_EXPORT_C double geoposition_getValue(GeoTessPositionC* gtp,
 	return -1;
 }
 
+GEO_TESS_EXPORT_C int geoposition_getValues(GeoTessPositionC* gtp,
+		const double* uVectors, const double* radii, int n, double* values)
+{
+	GeoTessPosition* pos;
+	int nAttributes;
+	try
+	{
+		pos = getcpp(gtp);
+		nAttributes = pos->getModel()->getNAttributes();
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(gtp->err, getCharsFromString(ex.emessage));
+		return n;
+	}
+	catch (...)
+	{
+		std::stringstream sstm;
+		sstm << ERR_MSG << __FILE__ << " on " << __LINE__;
+		ec_push(gtp->err, getCharsFromString(sstm.str()));
+		return n;
+	}
+
+	int nErrors = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		double* v = values + (LONG_INT) i * nAttributes;
+		try
+		{
+			pos->set(uVectors + 3*i, radii[i]);
+			for (int a = 0; a < nAttributes; ++a)
+				v[a] = pos->getValue(a);
+		}
+		catch (GeoTessException& ex)
+		{
+			++nErrors;
+			for (int a = 0; a < nAttributes; ++a)
+				v[a] = pos->getErrorValue();
+			ec_push(gtp->err, getCharsFromString(ex.emessage));
+		}
+		catch (...)
+		{
+			++nErrors;
+			for (int a = 0; a < nAttributes; ++a)
+				v[a] = pos->getErrorValue();
+			std::stringstream sstm;
+			sstm << ERR_MSG << __FILE__ << " on " << __LINE__;
+			ec_push(gtp->err, getCharsFromString(sstm.str()));
+		}
+	}
+	return nErrors;
+}
+
 GEO_TESS_EXPORT_C boolean geoposition_noEmptyProfiles(GeoTessPositionC* gtp)
 {
 	try
@@ -999,6 +1052,7 @@ GEO_TESS_EXPORT_C void geoposition_getCoefficients(GeoTessPositionC* gtp,
 		*coeffs = cs;
 		*size = retsize;
 		delete m;
+		return;
 	}
 	catch (GeoTessException& ex)
 	{
@@ -1013,6 +1067,38 @@ GEO_TESS_EXPORT_C void geoposition_getCoefficients(GeoTessPositionC* gtp,
 	*size = -1;
 }
 
+GEO_TESS_EXPORT_C int geoposition_copyCoefficients(GeoTessPositionC* gtp,
+		int* points, double* coeffs, int capacity)
+{
+	try
+	{
+		map<int, double> m;
+		getcpp(gtp)->getCoefficients(m);
+		int size = (int) m.size();
+		if (size <= capacity)
+		{
+			int i = 0;
+			for (map<int, double>::iterator it = m.begin(); it != m.end(); ++it, ++i)
+			{
+				points[i] = it->first;
+				coeffs[i] = it->second;
+			}
+		}
+		return size;
+	}
+	catch (GeoTessException& ex)
+	{
+		ec_push(gtp->err, getCharsFromString(ex.emessage));
+	}
+	catch (...)
+	{
+		std::stringstream sstm;
+		sstm << ERR_MSG << __FILE__ << " on " << __LINE__;
+		ec_push(gtp->err, getCharsFromString(sstm.str()));
+	}
+	return -1;
+}
+
 GEO_TESS_EXPORT_C int geoposition_getTessLevelId(GeoTessPositionC* gtp, int tId)
 {
 	try
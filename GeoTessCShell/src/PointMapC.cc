@@ -144,7 +144,7 @@ GEO_TESS_EXPORT_C int geopoint_getNodeIndex(PointMapC* pm, int pointIndex){
 
 GEO_TESS_EXPORT_C int* geopoint_getPointIndices(PointMapC* pm, int pointIndex){
 	try{
-		return getIntArr((vector<int>*)&getcpp(pm)->getPointIndices(pointIndex));
+		return getIntArr(getcpp(pm)->getPointIndicesFlat(pointIndex), 3);
 	}catch(GeoTessException& ex){
 		ec_push(pm->err, getCharsFromString(ex.emessage));
 	}catch(...){
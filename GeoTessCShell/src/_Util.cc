@@ -147,6 +147,14 @@ int* getIntArr(const std::set<int>& s)
 	return ret;
 }
 
+int* getIntArr(const int* u, int size)
+{
+	int* ret = (int*) malloc(sizeof(int) * size);
+	for (int i = 0; i < size; ++i)
+		ret[i] = u[i];
+	return ret;
+}
+
 string* charArrStrArr(char** arr, int num)
 {
 	string* ret = new string[num];
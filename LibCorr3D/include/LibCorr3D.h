@@ -43,6 +43,9 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <list>
 
 // use standard library objects
 using namespace std;
@@ -71,6 +74,85 @@ class GeoTessInterpolatorType;
 
 // **** _CLASS DEFINITION_ *****************************************************
 
+/**
+ * \brief The result of a LibCorr3D query.
+ *
+ * Returned by the LibCorr3D::getModelResult() methods that take the
+ * interpolation location as arguments rather than using the current
+ * interpolation location.  errorCode and errorMessage have the same meaning
+ * as LibCorr3D::getCurrentErrorCode() and LibCorr3D::getCurrentErrorMessage().
+ */
+struct GEOTESS_EXP_IMP LibCorr3DResult
+{
+	/**
+	 * The interpolated model value, or zero if errorCode is not zero.
+	 */
+	double modelValue;
+
+	/**
+	 * The interpolated model uncertainty, or -1 if it is not available.
+	 */
+	double modelUncertainty;
+
+	/**
+	 * Zero if modelValue is valid, otherwise one of the error codes
+	 * documented by LibCorr3D::getCurrentErrorCode().
+	 */
+	int errorCode;
+
+	/**
+	 * Description of the error, or empty if errorCode is zero.
+	 */
+	string errorMessage;
+
+	LibCorr3DResult() : modelValue(0.), modelUncertainty(-1.), errorCode(0) {}
+
+	/**
+	 * Return true if modelValue was successfully determined.
+	 */
+	bool isValid() const { return errorCode == 0; }
+};
+
+/**
+ * \brief The outcome of loading one model with LibCorr3D::loadModels().
+ */
+struct GEOTESS_EXP_IMP LibCorr3DLoadStatus
+{
+	/**
+	 * The model file name, as supplied to LibCorr3D::loadModels().
+	 */
+	string fileName;
+
+	/**
+	 * The handle associated with the model, or -1 if none was assigned.
+	 */
+	int handle;
+
+	/**
+	 * Time spent reading the model, in seconds.  Zero if the model was
+	 * already in memory.
+	 */
+	double loadTime;
+
+	/**
+	 * Zero if the model was loaded successfully, otherwise the code of the
+	 * exception that prevented it from loading.
+	 */
+	int errorCode;
+
+	/**
+	 * Description of the error, or empty if errorCode is zero.
+	 */
+	string errorMessage;
+
+	LibCorr3DLoadStatus() : handle(-1), loadTime(0.), errorCode(0) {}
+
+	/**
+	 * Return true if the model is in memory.
+	 */
+	bool isValid() const { return errorCode == 0; }
+};
+
 /**
  * This class is responsible for loading, removing, and interpolating
  * LibCorr3D model objects for travel time, slowness, and azimuth attributes.
@@ -112,6 +194,20 @@ class GeoTessInterpolatorType;
  * The interpolation algorithms used in the geographic and radial dimensions
  * default to linear interpolation in both cases, but these can be changed by calling
  * method setInterpolator().
+ * <p>
+ * The methods that use the current interpolation location, and the error
+ * state reported by getCurrentErrorCode(), are not thread safe.  To evaluate
+ * models from several threads concurrently, use the getModelResult() methods
+ * that take the location as arguments and return a LibCorr3DResult.  Models
+ * must not be loaded or removed, and the interpolators must not be changed,
+ * while such queries are in progress.
+ * <p>
+ * When a library holds many more models than a single run uses, call
+ * setDeferredLoading() before loading models.  loadModel() then only
+ * registers each model and it is read from file the first time it is
+ * queried.  The models that were used least recently are deleted again
+ * whenever the models in memory exceed a memory budget; they are reread
+ * transparently if they are needed later.
  */
 class GEOTESS_EXP_IMP LibCorr3D
 {
@@ -216,6 +312,193 @@ private:
 	 */
 	vector<GeoTessPosition*> lc3dPositionList;
 
+	/**
+	 * Map from a gridID to GeoTessPosition objects that are not currently in
+	 * use by a thread safe query.  Positions are taken from the pool for
+	 * the duration of a query and returned to it afterwards, so there are
+	 * never more positions per grid than concurrent queries.
+	 */
+	map<string, vector<GeoTessPosition*> > lc3dPositionPool;
+
+	/**
+	 * Guards lc3dPositionPool.
+	 */
+	mutex lc3dPoolMutex;
+
+	/**
+	 * If true, loadModel() only registers models and each one is read the
+	 * first time it is needed.  See setDeferredLoading().
+	 */
+	bool lc3dDeferred;
+
+	/**
+	 * When lc3dDeferred is true, the maximum memory in bytes of the models
+	 * that are kept in memory, or <= 0 for no limit.
+	 */
+	LONG_INT lc3dMemoryBudget;
+
+	/**
+	 * When lc3dDeferred is true, true for each handle whose model has been
+	 * registered but is not currently in memory.  Indexed by handle.
+	 */
+	vector<bool> lc3dPending;
+
+	/**
+	 * The attribute filter with which each model was registered, applied
+	 * whenever it is read.  Indexed by handle.
+	 */
+	vector<vector<int> > lc3dAttributeFilter;
+
+	/**
+	 * The memory of each model in memory, measured with
+	 * LibCorr3DModel::getMemory() when it was read.  Indexed by handle.
+	 */
+	vector<LONG_INT> lc3dModelMemory;
+
+	/**
+	 * The number of queries currently using each model.  Models in use are
+	 * never evicted.  Indexed by handle.
+	 */
+	vector<int> lc3dModelUsers;
+
+	/**
+	 * True for each handle whose model has been returned by getModel() or
+	 * newPosition() and not released with unpinModel().  A pinned model
+	 * holds one count in lc3dModelUsers, so it is never evicted.  Indexed by
+	 * handle.
+	 */
+	vector<bool> lc3dModelPinned;
+
+	/**
+	 * The handles of the models in memory that are not in use, least
+	 * recently released first.  Models are evicted from the front.
+	 */
+	list<int> lc3dIdleModels;
+
+	/**
+	 * The entry of each handle in lc3dIdleModels, or lc3dIdleModels.end()
+	 * if its model is not idle.  Indexed by handle.
+	 */
+	vector<list<int>::iterator> lc3dIdleEntry;
+
+	/**
+	 * True for each handle whose model is being read by acquireModel()
+	 * without holding lc3dResidencyMutex.  Indexed by handle.
+	 */
+	vector<bool> lc3dLoading;
+
+	/**
+	 * Notified whenever acquireModel() finishes reading a model, so that
+	 * threads waiting for the same handle can use it.
+	 */
+	condition_variable lc3dLoaded;
+
+	/**
+	 * Sum of lc3dModelMemory over the models in memory.
+	 */
+	LONG_INT lc3dResidentMemory;
+
+	/**
+	 * The grids of the models that have been read with deferred loading.
+	 * A reference is held on each one so that positions remain valid while
+	 * all the models on a grid are evicted.
+	 */
+	map<string, GeoTessGrid*> lc3dGrids;
+
+	/**
+	 * Guards the residency of models and the members above when
+	 * lc3dDeferred is true.  Model files are read without holding it.
+	 */
+	mutex lc3dResidencyMutex;
+
+	/**
+	 * Return the handle associated with fname, assigning a new one if the
+	 * file has never been seen before.
+	 */
+	int assignHandle(const string& fname);
+
+	/**
+	 * Register the model associated with handle so that it is read when it
+	 * is first used.
+	 * @throws GeoTessException if the model file does not exist.
+	 */
+	void deferModel(int handle, const vector<int>& attributeFilter);
+
+	/**
+	 * With deferred loading, read the model associated with handle if it
+	 * is not in memory and mark it as in use.  The file is read without
+	 * holding lc3dResidencyMutex; other threads that need the same model
+	 * wait until it has been read.  Returns the model, or NULL if
+	 * it has been removed.  Every call that returns a model must be matched
+	 * by a call to releaseModel().
+	 * @throws GeoTessException if the model cannot be read.
+	 */
+	LibCorr3DModel* acquireModel(int handle);
+
+	/**
+	 * With deferred loading, mark the model associated with handle as no
+	 * longer in use by the caller and evict the least recently used models
+	 * until the memory budget is met.
+	 */
+	void releaseModel(int handle);
+
+	/**
+	 * With deferred loading, keep the model associated with handle, which
+	 * the caller has just acquired, in memory until unpinModel() is called.
+	 */
+	void pinModel(int handle);
+
+	/**
+	 * Delete the model associated with handle, releasing its share of the
+	 * positions.  The handle remains associated with the file name.
+	 */
+	void unloadModel(int handle);
+
+	/**
+	 * Take a GeoTessPosition that supports model from the pool, or create a
+	 * new one if none is available.
+	 */
+	GeoTessPosition* acquirePosition(LibCorr3DModel* model);
+
+	/**
+	 * Return a GeoTessPosition obtained from acquirePosition() to the pool.
+	 */
+	void releasePosition(LibCorr3DModel* model, GeoTessPosition* position);
+
+	/**
+	 * Return the model associated with handle if it is in memory and
+	 * time is within its valid time range.  Otherwise, set the error code
+	 * and message of result and return NULL.
+	 */
+	LibCorr3DModel* checkHandle(int handle, double time, LibCorr3DResult& result);
+
+	/**
+	 * Interpolate model at the specified location using position and store
+	 * the value, uncertainty and any error in result.
+	 */
+	void interpolate(int handle, LibCorr3DModel* model, GeoTessPosition* position,
+			const double* unitVector, double radius, LibCorr3DResult& result);
+
+	/**
+	 * Make sure that a GeoTessPosition object that supports the grid of the
+	 * model associated with handle is available in lc3dPositionList.
+	 */
+	void addPosition(int handle);
+
+	/**
+	 * Compute everything that model, its grid and its profiles would
+	 * otherwise compute lazily the first time they are interpolated with
+	 * the current interpolators, so that concurrent queries only read them.
+	 * See GeoTessModel::prepareInterpolation().
+	 */
+	void prepareModel(LibCorr3DModel* model);
+
+	/**
+	 * Delete the pooled positions for the specified gridID, or for all
+	 * grids if gridID is empty.
+	 */
+	void clearPositionPool(const string& gridID = "");
+
 	/**
 	 * Current error code. Reset to 0 (no error) after calling load or interpolate.
 	 */
@@ -381,6 +664,43 @@ public:
 	int loadModel(const string& fname, vector<int>& attributeFilter,
 			const GeoTessOptimizationType& optimizationType = GeoTessOptimizationType::SPEED);
 
+	/**
+	 * Load many models concurrently.  The files are read by
+	 * GeoTessParallel::getNThreads() threads and models that share a grid
+	 * share a single copy of it, regardless of which thread read the grid
+	 * first.  A model that fails to load does not prevent the others from
+	 * loading; the outcome and read time of each file are reported in status.
+	 * Models that are already in memory are not reloaded.
+	 * <p>This method must not be called concurrently with any other method
+	 * of this LibCorr3D object.
+	 *
+	 * @param fnames the names of the model files, relative to the root paths
+	 * specified in the constructor, as for loadModel().
+	 * @param status (output) one entry for each element of fnames, in the
+	 * same order.  Each entry holds the handle of the model, which is
+	 * assigned even if the model failed to load, as for loadModel().
+	 * @return the number of files that failed to load.
+	 */
+	int loadModels(const vector<string>& fnames, vector<LibCorr3DLoadStatus>& status);
+
+	/**
+	 * Load all the models in a directory, or all the models listed in a
+	 * manifest file, concurrently.  See loadModels(vector<string>, vector<LibCorr3DLoadStatus>).
+	 *
+	 * @param source the name, relative to the GeoTess root path specified in
+	 * the constructor, of either a directory or a manifest file.  If it is a
+	 * directory, every GeoTess model file in it is loaded; other files, such
+	 * as grid files, are ignored.  Specify an empty string to load every
+	 * model in the root directory.  If it is a manifest file, it must contain
+	 * one model file name per line, relative to the root paths.  Blank lines
+	 * and lines that start with '#' are ignored.
+	 * @param status (output) the outcome of loading each model.
+	 * @return the number of files that failed to load.
+	 * @throws GeoTessException if source is neither a directory nor a
+	 * readable file.
+	 */
+	int loadModels(const string& source, vector<LibCorr3DLoadStatus>& status);
+
 	/**
 	 * Removes the specified model from the list of supported models and deletes it from memory.
 	 */
@@ -544,10 +864,55 @@ public:
 	}
 
 	/**
-	 * @return a pointer to a model object given the input handle.
+	 * Specify whether models are read when they are loaded or when they are
+	 * first used.  With deferred loading, loadModel() and loadModels() only
+	 * check that each model file exists; the model is read by the first query
+	 * that needs it, including getModel() and newPosition().  Whenever the
+	 * memory of the models in memory, as measured by
+	 * LibCorr3DModel::getMemory(), exceeds memoryBudget, the models that were
+	 * used least recently, and that are neither in use by a concurrent query
+	 * nor kept by getModel() or newPosition() (see unpinModel()), are
+	 * deleted until the budget is met.  They are reread if they are needed
+	 * again.  Grids are shared by many models and are not counted against
+	 * the budget; they stay in memory once they have been read.
+	 * <p>Deferred loading must be selected before any model is loaded.  The
+	 * memory budget can be changed at any time and takes effect at the next
+	 * query.
+	 * @param deferred true to read models when they are first used.
+	 * @param memoryBudget maximum memory in bytes of the models kept in
+	 * memory.  Values <= 0 mean no limit.
+	 * @throws GeoTessException if deferred differs from the current setting
+	 * and models have already been loaded.
+	 */
+	void setDeferredLoading(bool deferred, LONG_INT memoryBudget = 0);
+
+	/**
+	 * @return true if models are read when they are first used.
+	 */
+	bool isDeferredLoading() const { return lc3dDeferred; }
+
+	/**
+	 * @return the memory budget of deferred loading in bytes, or <= 0 if
+	 * there is no limit.
+	 */
+	LONG_INT getMemoryBudget() const { return lc3dMemoryBudget; }
+
+	/**
+	 * @return a pointer to a model object given the input handle.  With
+	 * deferred loading the model is read if necessary and is not evicted
+	 * until unpinModel() is called, so the pointer remains valid until then.
 	 */
 	LibCorr3DModel* getModel(int handle);
 
+	/**
+	 * With deferred loading, allow the model associated with handle to be
+	 * evicted again after getModel() or newPosition() kept it in memory.
+	 * Pointers returned by getModel(), and positions returned by
+	 * newPosition(), for this handle must not be used after this call.
+	 * Does nothing if the model is not being kept in memory.
+	 */
+	void unpinModel(int handle);
+
 	/**
 	 * The access function used to retrieve the model attribute and associated uncertainty
 	 * results at the current interpolation location for the model associated with the
@@ -583,6 +948,105 @@ public:
 	 */
 	bool getModelResult(int handle, double& modelValue, double& modelUncertainty);
 
+	/**
+	 * Thread safe version of getModelResult() that does not use or modify the
+	 * current interpolation location or the current error code and message.
+	 * The error code and message are returned in the result instead.
+	 * <p>Interpolation requires a GeoTessPosition object.  If the caller
+	 * supplies one, obtained from newPosition() for a model on the same grid, it
+	 * is used and the caller must not use it concurrently from other threads.
+	 * Otherwise a position is borrowed from an internal pool for the duration
+	 * of the call.  Calls for the same or different handles may be made
+	 * concurrently from any number of threads.
+	 *
+	 * @param handle the handle of the model to be interrogated.
+	 * @param unitVector the interpolation location as a unit vector.
+	 * @param radius distance from the center of the Earth in km.  Any value
+	 * less than zero sets the radius to the surface of the WGS84 ellipsoid.
+	 * @param time epoch time (seconds since Jan 1, 1970), or NA_VALUE in which
+	 * case time is not constrained to the valid on-off times of the model.
+	 * @param position (optional) the GeoTessPosition to use for interpolation.
+	 * @return the model value, uncertainty and error code.
+	 */
+	LibCorr3DResult getModelResult(int handle, const double* unitVector, double radius,
+			double time = NA_VALUE, GeoTessPosition* position = NULL);
+
+	/**
+	 * Thread safe version of getModelResult().  See the version of this method
+	 * that takes a unit vector.
+	 *
+	 * @param handle the handle of the model to be interrogated.
+	 * @param lon longitude in degrees
+	 * @param lat latitude in degrees
+	 * @param depth depth below surface of WGS84 ellipsoid, in km.
+	 * @param time epoch time (seconds since Jan 1, 1970), or NA_VALUE in which
+	 * case time is not constrained to the valid on-off times of the model.
+	 * @param position (optional) the GeoTessPosition to use for interpolation.
+	 * @return the model value, uncertainty and error code.
+	 */
+	LibCorr3DResult getModelResult(int handle, double lon, double lat, double depth,
+			double time, GeoTessPosition* position = NULL)
+	{
+		double u[3];
+		GeoTessUtils::getVectorDegrees(lat, lon, u);
+		return getModelResult(handle, u, GeoTessUtils::getEarthRadius(u)-depth, time, position);
+	}
+
+	/**
+	 * Evaluate many models at one location.  Equivalent to calling the thread
+	 * safe getModelResult() for each handle, but models that share a grid are
+	 * interpolated with a single GeoTessPosition: the triangle walk and the
+	 * horizontal interpolation coefficients are computed once per distinct
+	 * grid and only the radial interpolation and the attribute values are
+	 * evaluated for each model.  Thread safe; see getModelResult().
+	 *
+	 * @param handles the handles of the models to be interrogated.
+	 * @param unitVector the interpolation location as a unit vector.
+	 * @param radius distance from the center of the Earth in km.  Any value
+	 * less than zero sets the radius to the surface of the WGS84 ellipsoid.
+	 * @param time epoch time (seconds since Jan 1, 1970), or NA_VALUE in which
+	 * case time is not constrained to the valid on-off times of the models.
+	 * @param results (output) one result for each element of handles, in the
+	 * same order.
+	 */
+	void getModelResults(const vector<int>& handles, const double* unitVector,
+			double radius, double time, vector<LibCorr3DResult>& results);
+
+	/**
+	 * Evaluate many models at one location.  See the version of this method
+	 * that takes a unit vector.
+	 *
+	 * @param handles the handles of the models to be interrogated.
+	 * @param lon longitude in degrees
+	 * @param lat latitude in degrees
+	 * @param depth depth below surface of WGS84 ellipsoid, in km.
+	 * @param time epoch time (seconds since Jan 1, 1970), or NA_VALUE in which
+	 * case time is not constrained to the valid on-off times of the models.
+	 * @param results (output) one result for each element of handles, in the
+	 * same order.
+	 */
+	void getModelResults(const vector<int>& handles, double lon, double lat,
+			double depth, double time, vector<LibCorr3DResult>& results)
+	{
+		double u[3];
+		GeoTessUtils::getVectorDegrees(lat, lon, u);
+		getModelResults(handles, u, GeoTessUtils::getEarthRadius(u)-depth, time, results);
+	}
+
+	/**
+	 * Return a new GeoTessPosition object that can be passed to the thread
+	 * safe getModelResult() methods.  It supports every model that uses the
+	 * same grid as the model associated with handle, and it uses the current
+	 * interpolators.  Each thread should use its own positions.  The caller
+	 * assumes ownership and must delete the position before the models it
+	 * supports are removed.  With deferred loading the model associated with
+	 * handle is kept in memory until unpinModel() is called.
+	 * @param handle the handle of a model.
+	 * @return a new GeoTessPosition, or NULL if handle does not refer to a model
+	 * that is currently in memory.
+	 */
+	GeoTessPosition* newPosition(int handle);
+
 	/**
 	 * Returns the primary (new GeoTess) root path to the caller.  The root path is the
 	 * path to where all new GeoTess models and grids are stored and, if the old path
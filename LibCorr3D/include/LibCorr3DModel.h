@@ -152,6 +152,30 @@ private:
 	vector<float> bmUncDist;
 	vector<float> bmUncValu;
 
+	/**
+	 * True if the distances in bmUncDist are (nearly) uniformly spaced, in
+	 * which case the table entry that brackets a distance is found directly
+	 * using bmUncInvStep rather than by searching.
+	 */
+	bool bmUncUniform;
+
+	/**
+	 * The reciprocal of the spacing of bmUncDist, when bmUncUniform is true.
+	 */
+	double bmUncInvStep;
+
+	/**
+	 * Determine whether bmUncDist is uniformly spaced.  Called after the base
+	 * model uncertainty table has been read.
+	 */
+	void initBaseModelUncertainty();
+
+	/**
+	 * Interpolate the base model uncertainty table at the specified distance
+	 * in radians.
+	 */
+	double getBaseModelUncertainty(double dist) const;
+
 	/**
 	 * Gives classes that extend GeoTessModel an opportunity to load additional
 	 * information. This method is called immediately after all the standard model
@@ -307,6 +331,23 @@ public:
 	 */
 	double interpolate2DModelUncertainty(const double* pos);
 
+	/**
+	 * Calculates the old 2D model uncertainty at many positions, as when a
+	 * grid search evaluates one station-phase model at many candidate
+	 * epicenters.  Equivalent to calling
+	 * interpolate2DModelUncertainty(const double*) for each position, but
+	 * the distances are computed in a single pass over the positions.  If
+	 * this is a 3D model, all the uncertainties are zero.
+	 * @param positions n unit vectors stored consecutively, i.e., the
+	 * components of position i are positions[3*i], positions[3*i+1] and
+	 * positions[3*i+2].
+	 * @param n the number of positions.
+	 * @param uncertainty (output) array of at least n elements that receives
+	 * the uncertainty at each position.
+	 */
+	void interpolate2DModelUncertainty(const double* positions, int n,
+			double* uncertainty);
+
 	/**
 	 * Return the file name string associated with this model.
 	 * @return  the file name string associated with this model.
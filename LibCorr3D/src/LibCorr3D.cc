@@ -37,6 +37,7 @@
 #include <iostream>
 #include <sstream>
 #include <exception>
+#include <fstream>
 
 // **** _LOCAL INCLUDES_ *******************************************************
 
@@ -46,6 +47,8 @@
 #include "GeoTessOptimizationType.h"
 #include "GeoTessInterpolatorType.h"
 #include "IFStreamBinary.h"
+#include "GeoTessParallel.h"
+#include "CpuTimer.h"
 
 // **** _BEGIN GEOTESS NAMESPACE_ **********************************************
 
@@ -69,6 +72,9 @@ LibCorr3D::LibCorr3D(const string& rootPath) :
 														lc3dOldRootPath(rootPath),
 														lc3dGTRelGridPath(""),
 														lc3dOldRelTessPath(""),
+														lc3dDeferred(false),
+														lc3dMemoryBudget(0),
+														lc3dResidentMemory(0),
 														lc3dCurrErrCode(0),
 														lc3dCurrErrMsg(""),
 														geographicInterpolatorType(&GeoTessInterpolatorType::LINEAR),
@@ -89,6 +95,9 @@ LibCorr3D::LibCorr3D(const string& newRootPath, const string& oldRootPath) :
 														lc3dOldRootPath(oldRootPath),
 														lc3dGTRelGridPath(""),
 														lc3dOldRelTessPath(""),
+														lc3dDeferred(false),
+														lc3dMemoryBudget(0),
+														lc3dResidentMemory(0),
 														lc3dCurrErrCode(0),
 														lc3dCurrErrMsg(""),
 														geographicInterpolatorType(&GeoTessInterpolatorType::LINEAR),
@@ -112,6 +121,9 @@ LibCorr3D::LibCorr3D(const string& newRootPath, const string& newRelGridPath,
 		lc3dOldRootPath(oldRootPath),
 		lc3dGTRelGridPath(newRelGridPath),
 		lc3dOldRelTessPath(oldRelTessPath),
+		lc3dDeferred(false),
+		lc3dMemoryBudget(0),
+		lc3dResidentMemory(0),
 		lc3dCurrErrCode(0),
 		lc3dCurrErrMsg(""),
 		geographicInterpolatorType(&GeoTessInterpolatorType::LINEAR),
@@ -127,6 +139,10 @@ LibCorr3D::~LibCorr3D()
 {
 	for (int i = 0; i < (int) lc3dModelList.size(); i++)
 		removeModel(i);
+	clearPositionPool();
+
+	for (map<string, GeoTessGrid*>::iterator it = lc3dGrids.begin(); it != lc3dGrids.end(); ++it)
+		GeoTessModel::releaseGrid(it->second);
 }
 
 LONG_INT LibCorr3D::getMemory()
@@ -165,6 +181,20 @@ LONG_INT LibCorr3D::getMemory()
 	// vector<GeoTessPosition*> lc3dPositionList;
 	memory += (LONG_INT) (lc3dPositionList.capacity() * sizeof(GeoTessPosition*));
 
+	// map<string, vector<GeoTessPosition*> > lc3dPositionPool;
+	{
+		lock_guard<mutex> lock(lc3dPoolMutex);
+		for (map<string, vector<GeoTessPosition*> >::iterator it = lc3dPositionPool.begin();
+				it != lc3dPositionPool.end(); it++)
+		{
+			memory += (LONG_INT) (sizeof(string) + sizeof(vector<GeoTessPosition*>))
+					+ (LONG_INT) it->first.length()
+					+ (LONG_INT) (it->second.capacity() * sizeof(GeoTessPosition*));
+			for (int i = 0; i < (int) it->second.size(); ++i)
+				memory += it->second[i]->getMemory();
+		}
+	}
+
 	// geographicInterpolatorType and radialInterpolatorType
 	memory += (LONG_INT) (sizeof(GeoTessInterpolatorType) + sizeof(GeoTessInterpolatorType));
 
@@ -208,22 +238,17 @@ int LibCorr3D::loadModel(const string& fname, vector<int>& attributeFilter,
 	lc3dCurrErrMsg = "";
 	try
 	{
-		// search the map from fileName -> LibCorr3DModel index to see
-		// if this model has been loaded before.
-		map<string, int>::iterator it = lc3dModelMap.find(fname);
-		if (it == lc3dModelMap.end())
+		// find the handle associated with this file name, or assign a new one
+		handle = assignHandle(fname);
+
+		if (lc3dDeferred)
 		{
-			// have never seen this file name before.  Make a new
-			// entry in the modelList.
-			handle = lc3dModelList.size();
-			lc3dModelFileName.push_back(fname);
-			lc3dModelList.push_back(NULL);
-			lc3dPositionList.push_back(NULL);
-
-			lc3dModelMap[fname] = handle;
+			// just make sure the file exists.  The model is read when it
+			// is first used.
+			if (lc3dModelList[handle] == NULL && !lc3dPending[handle])
+				deferModel(handle, attributeFilter);
+			return handle;
 		}
-		else
-			handle = it->second;
 
 		// if the model associated with modelList entry is null,
 		// load a new LibCorr3D model.
@@ -239,30 +264,8 @@ int LibCorr3D::loadModel(const string& fname, vector<int>& attributeFilter,
 				lc3dModelList[handle] = new LibCorr3DModel(fpath, relGridPath,
 						attributeFilter, handle);
 
-			// get the gridId of the current model.
-			string gridID = lc3dModelList[handle]->getGrid().getGridID();
-
-			// search the map from gridID -> GeoTessPosition object to see if a position
-			// object that can support this model is already available.
-			map<string, GeoTessPosition*>::iterator itp = lc3dPositionMap.find(gridID);
-			if (itp == lc3dPositionMap.end())
-			{
-				//cout << "construct new GeoTessPosition object for grid id " << gridID << endl;
-
-				// don't currently have a GeoTessPosition for this gridID so make a new one.
-				lc3dPositionList[handle] = lc3dModelList[handle]->getPosition(
-						*geographicInterpolatorType, *radialInterpolatorType);
-
-				lc3dPositionMap[gridID] = lc3dPositionList[handle];
-
-				double x[3] = {1,0,0};
-				lc3dPositionList[handle]->set(0, x, 6371.);
-			}
-			else
-				lc3dPositionList[handle] = itp->second;
-
-			lc3dPositionList[handle]->addReference();
-
+			prepareModel(lc3dModelList[handle]);
+			addPosition(handle);
 		}
 
 	}
@@ -282,6 +285,423 @@ int LibCorr3D::loadModel(const string& fname, vector<int>& attributeFilter,
 	return handle;
 }
 
+/**
+ * Returns the handle of fname, assigning a new one the first time the file
+ * name is seen.
+ */
+int LibCorr3D::assignHandle(const string& fname)
+{
+	// search the map from fileName -> LibCorr3DModel index to see
+	// if this model has been loaded before.
+	map<string, int>::iterator it = lc3dModelMap.find(fname);
+	if (it != lc3dModelMap.end())
+		return it->second;
+
+	// have never seen this file name before.  Make a new
+	// entry in the modelList.
+	int handle = lc3dModelList.size();
+	lc3dModelFileName.push_back(fname);
+	lc3dModelList.push_back(NULL);
+	lc3dPositionList.push_back(NULL);
+
+	lc3dPending.push_back(false);
+	lc3dAttributeFilter.push_back(vector<int>());
+	lc3dModelMemory.push_back(0);
+	lc3dModelUsers.push_back(0);
+	lc3dModelPinned.push_back(false);
+	lc3dIdleEntry.push_back(lc3dIdleModels.end());
+	lc3dLoading.push_back(false);
+
+	lc3dModelMap[fname] = handle;
+	return handle;
+}
+
+void LibCorr3D::setDeferredLoading(bool deferred, LONG_INT memoryBudget)
+{
+	if (deferred != lc3dDeferred && !lc3dModelList.empty())
+	{
+		ostringstream os;
+		os << endl << "ERROR in LibCorr3D::setDeferredLoading" << endl
+				<< "Deferred loading cannot be changed after models have been loaded." << endl;
+		throw GeoTessException(os, __FILE__, __LINE__, 109);
+	}
+
+	lock_guard<mutex> lock(lc3dResidencyMutex);
+	lc3dDeferred = deferred;
+	lc3dMemoryBudget = memoryBudget;
+}
+
+void LibCorr3D::deferModel(int handle, const vector<int>& attributeFilter)
+{
+	string fpath = "";
+	string relGridPath = "";
+	checkPath(lc3dModelFileName[handle], fpath, relGridPath);
+
+	lc3dAttributeFilter[handle] = attributeFilter;
+	lc3dPending[handle] = true;
+}
+
+LibCorr3DModel* LibCorr3D::acquireModel(int handle)
+{
+	unique_lock<mutex> lock(lc3dResidencyMutex);
+
+	// wait while another thread reads this model.
+	lc3dLoaded.wait(lock, [&] { return !lc3dLoading[handle]; });
+
+	if (lc3dModelList[handle] == NULL)
+	{
+		if (!lc3dPending[handle])
+			return NULL;
+
+		// read the model without holding the lock, so that queries of other
+		// models are not blocked by the file I/O.
+		lc3dLoading[handle] = true;
+		string fname = lc3dModelFileName[handle];
+		vector<int> attributeFilter = lc3dAttributeFilter[handle];
+		lock.unlock();
+
+		LibCorr3DModel* model = NULL;
+		try
+		{
+			string fpath = "";
+			string relGridPath = "";
+			checkPath(fname, fpath, relGridPath);
+
+			if (attributeFilter.size() == 0)
+				model = new LibCorr3DModel(fpath, relGridPath, handle);
+			else
+				model = new LibCorr3DModel(fpath, relGridPath, attributeFilter, handle);
+
+			prepareModel(model);
+		}
+		catch (...)
+		{
+			delete model;
+			lock.lock();
+			lc3dLoading[handle] = false;
+			lc3dLoaded.notify_all();
+			throw;
+		}
+
+		lock.lock();
+		lc3dLoading[handle] = false;
+		lc3dLoaded.notify_all();
+
+		lc3dModelList[handle] = model;
+		addPosition(handle);
+		lc3dPending[handle] = false;
+
+		lc3dModelMemory[handle] = model->getMemory();
+		lc3dResidentMemory += lc3dModelMemory[handle];
+
+		// hold the grid so that positions on it survive eviction of all
+		// the models that use it.
+		string gridID = model->getGrid().getGridID();
+		if (lc3dGrids.find(gridID) == lc3dGrids.end())
+		{
+			GeoTessGrid* grid = GeoTessModel::acquireReuseGrid(gridID);
+			if (grid != NULL)
+				lc3dGrids[gridID] = grid;
+		}
+	}
+	else if (lc3dIdleEntry[handle] != lc3dIdleModels.end())
+	{
+		// no longer a candidate for eviction.
+		lc3dIdleModels.erase(lc3dIdleEntry[handle]);
+		lc3dIdleEntry[handle] = lc3dIdleModels.end();
+	}
+
+	++lc3dModelUsers[handle];
+	return lc3dModelList[handle];
+}
+
+void LibCorr3D::releaseModel(int handle)
+{
+	lock_guard<mutex> lock(lc3dResidencyMutex);
+
+	if (--lc3dModelUsers[handle] == 0 && lc3dModelList[handle] != NULL)
+		lc3dIdleEntry[handle] = lc3dIdleModels.insert(lc3dIdleModels.end(), handle);
+
+	// evict the least recently used models that are not in use until the
+	// budget is met.
+	while (lc3dMemoryBudget > 0 && lc3dResidentMemory > lc3dMemoryBudget
+			&& !lc3dIdleModels.empty())
+	{
+		int lru = lc3dIdleModels.front();
+		lc3dIdleModels.pop_front();
+		lc3dIdleEntry[lru] = lc3dIdleModels.end();
+
+		unloadModel(lru);
+		lc3dPending[lru] = true;
+	}
+}
+
+void LibCorr3D::pinModel(int handle)
+{
+	lock_guard<mutex> lock(lc3dResidencyMutex);
+
+	// a pinned model holds a single use no matter how often it is pinned.
+	if (lc3dModelPinned[handle])
+		--lc3dModelUsers[handle];
+	else
+		lc3dModelPinned[handle] = true;
+}
+
+void LibCorr3D::unpinModel(int handle)
+{
+	if (!lc3dDeferred || handle < 0 || handle >= (int) lc3dModelList.size())
+		return;
+
+	{
+		lock_guard<mutex> lock(lc3dResidencyMutex);
+		if (!lc3dModelPinned[handle])
+			return;
+		lc3dModelPinned[handle] = false;
+	}
+
+	releaseModel(handle);
+}
+
+void LibCorr3D::unloadModel(int handle)
+{
+	// get GeoTessPosition object that supports this model
+	lc3dPositionList[handle]->removeReference();
+
+	if (lc3dPositionList[handle]->isNotReferenced())
+	{
+		// there are no more references to this position object so remove
+		// the reference from the map (gridID -> GeoTessPosition) and delete it.
+		lc3dPositionMap.erase(lc3dModelList[handle]->getGrid().getGridID());
+		delete lc3dPositionList[handle];
+
+		// pooled positions reference the grid, which may be deleted
+		// along with this model.
+		clearPositionPool(lc3dModelList[handle]->getGrid().getGridID());
+	}
+	lc3dPositionList[handle] = NULL;
+
+	if (lc3dDeferred)
+	{
+		lc3dResidentMemory -= lc3dModelMemory[handle];
+		lc3dModelMemory[handle] = 0;
+	}
+
+	// get model, remove it from map and nullify its
+	// pointer in the list
+	delete lc3dModelList[handle];
+	lc3dModelList[handle] = NULL;
+}
+
+/**
+ * Prepares model for concurrent interpolation with the current
+ * interpolators.
+ */
+void LibCorr3D::prepareModel(LibCorr3DModel* model)
+{
+	lock_guard<mutex> lock(lc3dPoolMutex);
+	model->prepareInterpolation(*geographicInterpolatorType, *radialInterpolatorType);
+}
+
+/**
+ * Shares (or creates) the GeoTessPosition that supports the grid of the
+ * model associated with handle.
+ */
+void LibCorr3D::addPosition(int handle)
+{
+	// get the gridId of the current model.
+	string gridID = lc3dModelList[handle]->getGrid().getGridID();
+
+	// search the map from gridID -> GeoTessPosition object to see if a position
+	// object that can support this model is already available.
+	map<string, GeoTessPosition*>::iterator itp = lc3dPositionMap.find(gridID);
+	if (itp == lc3dPositionMap.end())
+	{
+		// don't currently have a GeoTessPosition for this gridID so make a new one.
+		lc3dPositionList[handle] = lc3dModelList[handle]->getPosition(
+				*geographicInterpolatorType, *radialInterpolatorType);
+
+		lc3dPositionMap[gridID] = lc3dPositionList[handle];
+
+		double x[3] = {1,0,0};
+		lc3dPositionList[handle]->set(0, x, 6371.);
+	}
+	else
+		lc3dPositionList[handle] = itp->second;
+
+	lc3dPositionList[handle]->addReference();
+}
+
+int LibCorr3D::loadModels(const vector<string>& fnames, vector<LibCorr3DLoadStatus>& status)
+{
+	status.assign(fnames.size(), LibCorr3DLoadStatus());
+
+	// assign handles serially, exactly as loadModel() does.  pending holds the
+	// index in fnames of the first occurrence of each model that has to be
+	// read or registered; first maps a handle to that index.
+
+	vector<int> pending;
+	map<int, int> first;
+	for (int i = 0; i < (int) fnames.size(); ++i)
+	{
+		int handle = assignHandle(fnames[i]);
+
+		status[i].fileName = fnames[i];
+		status[i].handle = handle;
+
+		if (lc3dModelList[handle] == NULL && !lc3dPending[handle]
+				&& first.find(handle) == first.end())
+		{
+			first[handle] = i;
+			pending.push_back(i);
+		}
+	}
+
+	// with deferred loading, only check that the files exist.
+	vector<int> deferred;
+	if (lc3dDeferred)
+		deferred.swap(pending);
+	for (int k = 0; k < (int) deferred.size(); ++k)
+	{
+		LibCorr3DLoadStatus& st = status[deferred[k]];
+		try
+		{
+			deferModel(st.handle, vector<int>());
+		}
+		catch (const GeoTessException& ex)
+		{
+			st.errorCode = ex.ecode;
+			st.errorMessage = ex.emessage;
+		}
+	}
+
+	// read the models concurrently.  Each thread only touches its own
+	// elements of models and status.
+
+	vector<LibCorr3DModel*> models(pending.size(), NULL);
+	GeoTessParallel::forEach((int) pending.size(), 1,
+			[&](int begin, int end, int)
+			{
+				for (int k = begin; k < end; ++k)
+				{
+					LibCorr3DLoadStatus& st = status[pending[k]];
+					CpuTimer timer;
+					try
+					{
+						string fpath = "";
+						string relGridPath = "";
+						checkPath(st.fileName, fpath, relGridPath);
+						models[k] = new LibCorr3DModel(fpath, relGridPath, st.handle);
+					}
+					catch (const GeoTessException& ex)
+					{
+						st.errorCode = ex.ecode;
+						st.errorMessage = ex.emessage;
+					}
+					catch (const exception& ex)
+					{
+						st.errorCode = -1;
+						st.errorMessage = ex.what();
+					}
+					st.loadTime = timer.realTime() * 1e-3;
+				}
+			});
+
+	// register the models and their positions serially.
+
+	for (int k = 0; k < (int) pending.size(); ++k)
+		if (models[k] != NULL)
+		{
+			LibCorr3DLoadStatus& st = status[pending[k]];
+			lc3dModelList[st.handle] = models[k];
+			try
+			{
+				prepareModel(models[k]);
+				addPosition(st.handle);
+			}
+			catch (const GeoTessException& ex)
+			{
+				st.errorCode = ex.ecode;
+				st.errorMessage = ex.emessage;
+			}
+		}
+
+	// copy the outcome to repeated file names, count the failures and record
+	// the first one as the current error.
+
+	int nFailed = 0;
+	lc3dCurrErrCode = 0;
+	lc3dCurrErrMsg = "";
+	for (int i = 0; i < (int) status.size(); ++i)
+	{
+		map<int, int>::iterator it = first.find(status[i].handle);
+		if (it != first.end() && it->second != i)
+		{
+			status[i].errorCode = status[it->second].errorCode;
+			status[i].errorMessage = status[it->second].errorMessage;
+		}
+
+		if (!status[i].isValid())
+		{
+			if (nFailed++ == 0)
+			{
+				lc3dCurrErrCode = status[i].errorCode;
+				lc3dCurrErrMsg = status[i].errorMessage;
+			}
+		}
+	}
+	return nFailed;
+}
+
+int LibCorr3D::loadModels(const string& source, vector<LibCorr3DLoadStatus>& status)
+{
+	string path = CPPUtils::insertPathSeparator(lc3dGTRootPath, source);
+
+	vector<string> fnames;
+	vector<string> files;
+	if (CPPUtils::listFiles(path, files))
+	{
+		// a directory.  Load every GeoTess model file in it.
+		for (int i = 0; i < (int) files.size(); ++i)
+		{
+			string f = source.empty() ? files[i]
+					: CPPUtils::insertPathSeparator(source, files[i]);
+			try
+			{
+				if (GeoTessModel::isGeoTessModel(
+						CPPUtils::insertPathSeparator(lc3dGTRootPath, f)))
+					fnames.push_back(f);
+			}
+			catch (...)
+			{
+				// not readable, or too short to be a model.
+			}
+		}
+	}
+	else
+	{
+		// a manifest file.
+		ifstream input(path.c_str());
+		if (!input.is_open())
+		{
+			ostringstream os;
+			os << endl << "ERROR in LibCorr3D::loadModels" << endl
+					<< path << endl
+					<< "is neither a directory nor a readable manifest file." << endl;
+			throw GeoTessException(os, __FILE__, __LINE__, 109);
+		}
+
+		string line;
+		while (getline(input, line))
+		{
+			line = CPPUtils::trim(line);
+			if (!line.empty() && line[0] != '#')
+				fnames.push_back(line);
+		}
+	}
+
+	return loadModels(fnames, status);
+}
+
 /**
  * Returns the path (pth) and relative grid path (relPath) given the input file
  * name. If the file name is not found an error is thrown.
@@ -335,9 +755,19 @@ LibCorr3DModel* LibCorr3D::getModel(int handle)
 	lc3dCurrErrMsg = "";
 	try
 	{
-		if (handle > -1 && handle < (int) lc3dModelList.size()
-				&& lc3dModelList[handle] != NULL)
-			return lc3dModelList[handle];
+		LibCorr3DModel* model = NULL;
+		if (handle > -1 && handle < (int) lc3dModelList.size())
+		{
+			// the caller keeps the pointer, so the model stays in memory until
+			// it is unpinned.
+			if (!lc3dDeferred)
+				model = lc3dModelList[handle];
+			else if ((model = acquireModel(handle)) != NULL)
+				pinModel(handle);
+		}
+
+		if (model != NULL)
+			return model;
 		else
 			throw GeoTessException("Invalid Model Handle", __FILE__,
 					__LINE__, 109);
@@ -355,127 +785,323 @@ LibCorr3DModel* LibCorr3D::getModel(int handle)
 bool LibCorr3D::getModelResult(int handle, double& modelValue,
 		double& modelUncertainty)
 {
-	bool valid = false;
-	modelValue = 0.;
-	modelUncertainty = -1.;
-	lc3dCurrErrCode = 0;
-	lc3dCurrErrMsg = "";
-	try
+	GeoTessPosition* pos = (handle > -1) && (handle < (int) lc3dPositionList.size())
+			? lc3dPositionList[handle] : NULL;
+
+	LibCorr3DResult result = getModelResult(handle, lc3dCurrIntrpVector,
+			lc3dCurrIntrpRadius, lc3dCurrIntrpTime, pos);
+
+	modelValue = result.modelValue;
+	modelUncertainty = result.modelUncertainty;
+	lc3dCurrErrCode = result.errorCode;
+	lc3dCurrErrMsg = result.errorMessage;
+
+	return result.isValid();
+}
+
+LibCorr3DResult LibCorr3D::getModelResult(int handle, const double* unitVector,
+		double radius, double time, GeoTessPosition* position)
+{
+	LibCorr3DResult result;
+	LibCorr3DModel* model = checkHandle(handle, time, result);
+	if (model != NULL)
 	{
-		if ((handle > -1) && (handle < (int) lc3dModelList.size()))
+		GeoTessPosition* pooled = NULL;
+		try
 		{
-			// valid handle ... get associated model and check for valid start time
+			if (position == NULL)
+				position = pooled = acquirePosition(model);
+		}
+		catch (const exception& ex)
+		{
+			result.errorCode = -99;
+			result.errorMessage = ex.what();
+			cerr << ex.what() << endl;
+		}
 
-			LibCorr3DModel* model = lc3dModelList[handle];
-			GeoTessPosition* pos = lc3dPositionList[handle];
+		if (position != NULL)
+		{
+			if (radius < 0.)
+				radius = GeoTessUtils::getEarthRadius(unitVector);
 
-			if (model != NULL && pos != NULL)
-			{
-				if ((lc3dCurrIntrpTime == NA_VALUE)
-						|| ((lc3dCurrIntrpTime >= model->getStationStartTime())
-								&& (lc3dCurrIntrpTime <= model->getStationEndTime())))
-				{
-					pos->setModel(model);
+			interpolate(handle, model, position, unitVector, radius, result);
+		}
 
-					pos->set(0, lc3dCurrIntrpVector,lc3dCurrIntrpRadius);
+		if (pooled != NULL)
+			releasePosition(model, pooled);
 
-					modelValue = pos->getValue(0);
+		if (lc3dDeferred)
+			releaseModel(handle);
+	}
+	return result;
+}
 
-					// replace NaN with 0
-					if (isnan(modelValue))
-					{
-						modelValue = 0.;
-						lc3dCurrErrCode = -1;
-						lc3dCurrErrMsg = "ERROR in LibCorr3D::getModelResult\nModel "
-								+lc3dModelFileName[handle]
-								+"\nCurrent interpolation location is out of range\n";
-					}
-					else
-					{
-						valid = true;
+void LibCorr3D::getModelResults(const vector<int>& handles, const double* unitVector,
+		double radius, double time, vector<LibCorr3DResult>& results)
+{
+	results.assign(handles.size(), LibCorr3DResult());
 
-						if (model->getMetaData().getNAttributes() > 1)
-							modelUncertainty = pos->getValue(1)
-							+ model->interpolate2DModelUncertainty(pos->getVector());
-						else
-							modelUncertainty = -1.;
+	if (radius < 0.)
+		radius = GeoTessUtils::getEarthRadius(unitVector);
 
-						// replace NaN with -1
-						if (isnan(modelUncertainty))
-							modelUncertainty = -1.;
-					}
-				}
-				else
-				{
-					ostringstream os;
-					os.setf(ios::fixed);
-					os.precision(3);
-					os << endl
-							<< "ERROR in LibCorr3D::getModelResult" << endl
-							<< "Model " << lc3dModelFileName[handle] << endl
-							<< "Current interpolation time (" << lc3dCurrIntrpTime << ")" << endl
-							<< "is out of bounds for the station limits " << endl
-							<< "(on time = " << model->getStationStartTime()
-							<< ", off time = " << model->getStationEndTime() << ")" << endl;
-
-					lc3dCurrErrCode = -2;
-					lc3dCurrErrMsg = os.str();
-					//throw GeoTessException(os, __FILE__, __LINE__, lc3dCurrErrCode);
-				}
-			}
-			else
+	// group the valid handles by grid, preserving their order within each
+	// group, so that every group is interpolated with a single position.
+
+	vector<LibCorr3DModel*> models(handles.size(), NULL);
+	map<string, vector<int> > groups;
+	for (int i = 0; i < (int) handles.size(); ++i)
+	{
+		models[i] = checkHandle(handles[i], time, results[i]);
+		if (models[i] != NULL)
+			groups[models[i]->getGrid().getGridID()].push_back(i);
+	}
+
+	for (map<string, vector<int> >::iterator it = groups.begin(); it != groups.end(); ++it)
+	{
+		vector<int>& group = it->second;
+		LibCorr3DModel* first = models[group[0]];
+		GeoTessPosition* position = NULL;
+		try
+		{
+			position = acquirePosition(first);
+		}
+		catch (const exception& ex)
+		{
+			for (int i = 0; i < (int) group.size(); ++i)
 			{
-				ostringstream os;
-				os << endl << "ERROR in LibCorr3D::getModelResult" << endl
-						<< "Model " << lc3dModelFileName[handle] << endl
-						<< "associated with input handle ("
-						<< handle << ") has been removed" << endl;
-
-				lc3dCurrErrCode = -3;
-				lc3dCurrErrMsg = os.str();
-				//throw GeoTessException(os, __FILE__, __LINE__, lc3dCurrErrCode);
+				results[group[i]].errorCode = -99;
+				results[group[i]].errorMessage = ex.what();
 			}
+			cerr << ex.what() << endl;
+			continue;
 		}
-		else
+
+		// the first call walks the grid to the location.  Subsequent calls
+		// find the position unchanged and only update the radial coefficients
+		// for each model.
+		for (int i = 0; i < (int) group.size(); ++i)
+			interpolate(handles[group[i]], models[group[i]], position,
+					unitVector, radius, results[group[i]]);
+
+		releasePosition(first, position);
+	}
+
+	if (lc3dDeferred)
+		for (int i = 0; i < (int) handles.size(); ++i)
+			if (models[i] != NULL)
+				releaseModel(handles[i]);
+}
+
+LibCorr3DModel* LibCorr3D::checkHandle(int handle, double time, LibCorr3DResult& result)
+{
+	if ((handle < 0) || (handle >= (int) lc3dModelList.size()))
+	{
+		ostringstream os;
+		os << endl << "ERROR in LibCorr3D::getModelResult" << endl
+				<< "Input handle (" << handle << ") is out of range." << endl
+				<< "No model has been associated with this handle." << endl;
+		result.errorCode = -4;
+		result.errorMessage = os.str();
+		return NULL;
+	}
+
+	// with deferred loading the list may be changed by other threads, so it
+	// is only read by acquireModel(), under the residency lock.
+	LibCorr3DModel* model = NULL;
+	if (!lc3dDeferred)
+		model = lc3dModelList[handle];
+	else
+	{
+		try
 		{
-			ostringstream os;
-			os << endl << "ERROR in LibCorr3D::getModelResult" << endl
-					<< "Input handle (" << handle << ") is out of range." << endl
-					<< "No model has been associated with this handle." << endl;
-			lc3dCurrErrCode = -4;
-			lc3dCurrErrMsg = os.str();
-			//throw GeoTessException(os, __FILE__, __LINE__, lc3dCurrErrCode);
+			model = acquireModel(handle);
+		}
+		catch (const GeoTessException& ex)
+		{
+			result.errorCode = ex.ecode;
+			result.errorMessage = ex.emessage;
+			cerr << ex.emessage << endl;
+			return NULL;
 		}
 	}
-	catch (const GeoTessException& ex)
+
+	if (model == NULL)
 	{
-		modelValue = 0.;
-		modelUncertainty = -1.;
 		ostringstream os;
 		os << endl << "ERROR in LibCorr3D::getModelResult" << endl
-				<< "Handle " << handle << endl;
+				<< "Model " << lc3dModelFileName[handle] << endl
+				<< "associated with input handle ("
+				<< handle << ") has been removed" << endl;
+
+		result.errorCode = -3;
+		result.errorMessage = os.str();
+		return NULL;
+	}
+
+	// check for valid start time
+
+	if ((time != NA_VALUE)
+			&& ((time < model->getStationStartTime())
+					|| (time > model->getStationEndTime())))
+	{
+		ostringstream os;
+		os.setf(ios::fixed);
+		os.precision(3);
+		os << endl
+				<< "ERROR in LibCorr3D::getModelResult" << endl
+				<< "Model " << lc3dModelFileName[handle] << endl
+				<< "Current interpolation time (" << time << ")" << endl
+				<< "is out of bounds for the station limits " << endl
+				<< "(on time = " << model->getStationStartTime()
+				<< ", off time = " << model->getStationEndTime() << ")" << endl;
+
+		result.errorCode = -2;
+		result.errorMessage = os.str();
+		if (lc3dDeferred)
+			releaseModel(handle);
+		return NULL;
+	}
+
+	return model;
+}
+
+void LibCorr3D::interpolate(int handle, LibCorr3DModel* model,
+		GeoTessPosition* position, const double* unitVector, double radius,
+		LibCorr3DResult& result)
+{
+	try
+	{
+		position->setModel(model);
+
+		position->set(0, unitVector, radius);
+
+		result.modelValue = position->getValue(0);
 
-		if ((handle > -1) && (handle < (int) lc3dModelList.size()))
-			os << "Model " << lc3dModelFileName[handle] << endl;
+		// replace NaN with 0
+		if (isnan(result.modelValue))
+		{
+			result.modelValue = 0.;
+			result.errorCode = -1;
+			result.errorMessage = "ERROR in LibCorr3D::getModelResult\nModel "
+					+lc3dModelFileName[handle]
+					+"\nCurrent interpolation location is out of range\n";
+		}
 		else
-			os << "Handle out of range (no model has been associated with this handle)" << endl;
+		{
+			if (model->getMetaData().getNAttributes() > 1)
+				result.modelUncertainty = position->getValue(1)
+				+ model->interpolate2DModelUncertainty(position->getVector());
+			else
+				result.modelUncertainty = -1.;
 
-		os << ex.emessage << endl;
+			// replace NaN with -1
+			if (isnan(result.modelUncertainty))
+				result.modelUncertainty = -1.;
+		}
+	}
+	catch (const GeoTessException& ex)
+	{
+		result.modelValue = 0.;
+		result.modelUncertainty = -1.;
+		ostringstream os;
+		os << endl << "ERROR in LibCorr3D::getModelResult" << endl
+				<< "Handle " << handle << endl
+				<< "Model " << lc3dModelFileName[handle] << endl
+				<< ex.emessage << endl;
 
-		lc3dCurrErrCode = ex.ecode;
-		lc3dCurrErrMsg = os.str();
+		result.errorCode = ex.ecode;
+		result.errorMessage = os.str();
 		cerr << os.str() << endl;
 	}
 	catch (const exception& ex)
 	{
-		modelValue = 0.;
-		modelUncertainty = -1.;
-		lc3dCurrErrCode = -99;
-		lc3dCurrErrMsg = ex.what();
+		result.modelValue = 0.;
+		result.modelUncertainty = -1.;
+		result.errorCode = -99;
+		result.errorMessage = ex.what();
 		cerr << ex.what() << endl;
 	}
+}
+
+GeoTessPosition* LibCorr3D::newPosition(int handle)
+{
+	if ((handle < 0) || (handle >= (int) lc3dModelList.size()))
+		return NULL;
 
-	return valid;
+	LibCorr3DModel* model = NULL;
+	if (!lc3dDeferred)
+		model = lc3dModelList[handle];
+	else
+	{
+		try
+		{
+			model = acquireModel(handle);
+		}
+		catch (const GeoTessException& ex)
+		{
+			cerr << ex.emessage << endl;
+			return NULL;
+		}
+	}
+
+	if (model == NULL)
+		return NULL;
+
+	GeoTessPosition* pos;
+	{
+		lock_guard<mutex> lock(lc3dPoolMutex);
+		pos = model->getPosition(*geographicInterpolatorType, *radialInterpolatorType);
+		double x[3] = {1,0,0};
+		pos->set(0, x, 6371.);
+	}
+
+	// the position refers to the model, so the model stays in memory until
+	// it is unpinned.
+	if (lc3dDeferred)
+		pinModel(handle);
+	return pos;
+}
+
+GeoTessPosition* LibCorr3D::acquirePosition(LibCorr3DModel* model)
+{
+	lock_guard<mutex> lock(lc3dPoolMutex);
+	vector<GeoTessPosition*>& pool = lc3dPositionPool[model->getGrid().getGridID()];
+	if (!pool.empty())
+	{
+		GeoTessPosition* pos = pool.back();
+		pool.pop_back();
+		return pos;
+	}
+
+	// positions are created while holding the lock because a natural
+	// neighbor position computes the circumcenters of the grid in its
+	// constructor if prepareModel() has not already done so.
+	GeoTessPosition* pos = model->getPosition(
+			*geographicInterpolatorType, *radialInterpolatorType);
+	double x[3] = {1,0,0};
+	pos->set(0, x, 6371.);
+	return pos;
+}
+
+void LibCorr3D::releasePosition(LibCorr3DModel* model, GeoTessPosition* position)
+{
+	lock_guard<mutex> lock(lc3dPoolMutex);
+	lc3dPositionPool[model->getGrid().getGridID()].push_back(position);
+}
+
+void LibCorr3D::clearPositionPool(const string& gridID)
+{
+	lock_guard<mutex> lock(lc3dPoolMutex);
+	map<string, vector<GeoTessPosition*> >::iterator it = lc3dPositionPool.begin();
+	while (it != lc3dPositionPool.end())
+		if (gridID.empty() || it->first == gridID)
+		{
+			for (int i = 0; i < (int) it->second.size(); ++i)
+				delete it->second[i];
+			lc3dPositionPool.erase(it++);
+		}
+		else
+			++it;
 }
 
 /**
@@ -491,26 +1117,23 @@ void LibCorr3D::removeModel(int handle)
 	{
 		// valid handle
 
-		if (lc3dModelList[handle] != NULL)
+		if (lc3dIdleEntry[handle] != lc3dIdleModels.end())
 		{
-			// get GeoTessPosition object that supports this model
-			lc3dPositionList[handle]->removeReference();
-
-			if (lc3dPositionList[handle]->isNotReferenced())
-			{
-				// there are no more references to this position object so remove
-				// the reference from the map (gridID -> GeoTessPosition) and delete it.
-				lc3dPositionMap.erase(lc3dModelList[handle]->getGrid().getGridID());
-				delete lc3dPositionList[handle];
-			}
-			lc3dPositionList[handle] = NULL;
+			lc3dIdleModels.erase(lc3dIdleEntry[handle]);
+			lc3dIdleEntry[handle] = lc3dIdleModels.end();
+		}
 
-			// get model, remove it from map and nullify its
-			// pointer in the list
-			delete lc3dModelList[handle];
-			lc3dModelList[handle] = NULL;
+		if (lc3dModelPinned[handle])
+		{
+			lc3dModelPinned[handle] = false;
+			--lc3dModelUsers[handle];
 		}
 
+		if (lc3dModelList[handle] != NULL)
+			unloadModel(handle);
+
+		// a removed model is not reread when it is used.
+		lc3dPending[handle] = false;
 	}
 }
 
@@ -526,14 +1149,23 @@ void LibCorr3D::setInterpolator(GeoTessInterpolatorType const* intrpGeographic,
 		radialInterpolatorType = intrpRadial;
 
 		for (int i=0; i<(int)lc3dPositionList.size(); ++i)
-		{
-			lc3dPositionList[i]->removeReference();
-			if (lc3dPositionList[i]->isNotReferenced())
-				delete lc3dPositionList[i];
-		}
+			if (lc3dPositionList[i] != NULL)
+			{
+				lc3dPositionList[i]->removeReference();
+				if (lc3dPositionList[i]->isNotReferenced())
+					delete lc3dPositionList[i];
+			}
 
 		lc3dPositionMap.clear();
 		lc3dPositionList.clear();
+		clearPositionPool();
+
+		// prepare every model in memory for the new interpolators before
+		// any position that uses them is handed out.  Deferred models are
+		// prepared when they are read.
+		for (int i=0; i<(int)lc3dModelList.size(); ++i)
+			if (lc3dModelList[i] != NULL)
+				prepareModel(lc3dModelList[i]);
 
 		map<string, GeoTessPosition*>::iterator itpos;
 		GeoTessPosition* pos = NULL;
@@ -541,6 +1173,13 @@ void LibCorr3D::setInterpolator(GeoTessInterpolatorType const* intrpGeographic,
 
 		for (int i=0; i<(int)lc3dModelList.size(); ++i)
 		{
+			// removed and deferred models do not have a position.
+			if (lc3dModelList[i] == NULL)
+			{
+				lc3dPositionList.push_back(NULL);
+				continue;
+			}
+
 			gridID = lc3dModelList[i]->getGrid().getGridID();
 			itpos = lc3dPositionMap.find(gridID);
 			if (itpos == lc3dPositionMap.end())
@@ -35,6 +35,7 @@
 
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 
 // **** _LOCAL INCLUDES_ *******************************************************
 
@@ -72,7 +73,7 @@ LibCorr3DModel::LibCorr3DModel(const string& fn, const string& relGridFilePath,
   staDnorth(0.), staDeast(0.),
   phase(""), supportedPhases(""),
   parameters(""), comments(""), baseModel(""), baseModelVersion(""),
-  formatVersion(-9)
+  formatVersion(-9), bmUncUniform(false), bmUncInvStep(0.)
 {
 	staPosition[0] = 1.; staPosition[1]=staPosition[2]=0.;
 	loadModel(fn, relGridFilePath);
@@ -90,7 +91,7 @@ LibCorr3DModel::LibCorr3DModel(const string& fn, const string& relGridFilePath,
   staDnorth(0.), staDeast(0.),
   phase(""), supportedPhases(""),
   parameters(""), comments(""), baseModel(""), baseModelVersion(""),
-  formatVersion(-9)
+  formatVersion(-9), bmUncUniform(false), bmUncInvStep(0.)
 {
 	staPosition[0] = 1.; staPosition[1]=staPosition[2]=0.;
 	loadModel(fn, relGridFilePath);
@@ -268,19 +269,16 @@ void LibCorr3DModel::loadModelBinaryLibCorr2D(IFStreamBinary& input,
 
 	// see if the grid exists in the static map ... assign it if it does
 
-	map<string, GeoTessGrid*>::iterator it = reuseGridMap.find(gridID);
-	if (it != reuseGridMap.end())
-		grid = it->second;
-	else
+	grid = acquireReuseGrid(gridID);
+	if (grid == NULL)
 	{
 		// now read grid data
 		// create the grid file path/name and load the file. If grid reuse is on then add the
 		// grid to the static map
 
-		grid = new LibCorr3DGrid(gridFilePath, gridID);
-		if (metaData->isGridReuseOn()) reuseGridMap[gridID] = grid;
+		grid = registerReuseGrid(new LibCorr3DGrid(gridFilePath, gridID), gridID,
+				metaData->isGridReuseOn());
 	}
-	grid->addReference();
 
 	// finally, we need to read in the base model uncertainty so that it can be added to the
 	// interpolated uncertainty (only used when representing 2D LibCorr surfaces).
@@ -307,6 +305,7 @@ void LibCorr3DModel::loadModelBinaryLibCorr2D(IFStreamBinary& input,
 		bmUncDist.push_back(CPPUtils::toRadians(ifs.readFloat()));
 		bmUncValu.push_back(ifs.readFloat());
 	}
+	initBaseModelUncertainty();
 }
 
 /**
@@ -814,45 +813,101 @@ double LibCorr3DModel::interpolate2DModelUncertainty(const double* pos)
 	if (is3DModel())
 		return 0.;
 
-	double dist = GeoTessUtils::angle(staPosition, pos);
+	return getBaseModelUncertainty(GeoTessUtils::angle(staPosition, pos));
+}
+
+void LibCorr3DModel::interpolate2DModelUncertainty(const double* positions, int n,
+		double* uncertainty)
+{
+	if (is3DModel())
+	{
+		for (int i = 0; i < n; ++i)
+			uncertainty[i] = 0.;
+		return;
+	}
+
+	// compute the cosine of the distance from the station to every position
+	// in a loop that the compiler can vectorize, then convert to distance
+	// and look up the table.
 
-	// if base model uncertainty array consists of only 2 entries then set index
-	// to 0 ... otherwise, find bracketing index value
+	const double s0 = staPosition[0], s1 = staPosition[1], s2 = staPosition[2];
+	for (int i = 0; i < n; ++i)
+		uncertainty[i] = s0 * positions[3*i] + s1 * positions[3*i+1]
+				+ s2 * positions[3*i+2];
 
-	int inc = (int) bmUncDist.size();
-	if (dist > bmUncDist[inc - 1])
-		return bmUncValu[inc - 1];
-	else
+	for (int i = 0; i < n; ++i)
 	{
-		int index = 0;
-		if (inc > 2)
-		{
-			// set up interpolation increment and index start
-
-			inc >>= 1;
-			index = inc;
-
-			// perform binary search to find index.
-			do
-			{
-				if (inc > 1) inc >>= 1;
-				if ((double) bmUncDist[index + 1] <= dist)
-					index += inc;
-				else if ((double) bmUncDist[index] > dist)
-					index -= inc;
-				else
-					break;
-			} while (true);
-		}
+		double dot = uncertainty[i];
+		uncertainty[i] = getBaseModelUncertainty(
+				dot >= 1. ? 0. : (dot <= -1. ? PI : acos(dot)));
+	}
+}
+
+void LibCorr3DModel::initBaseModelUncertainty()
+{
+	// the table is treated as uniform if every distance is within a tenth
+	// of a step of its nominal value.  getBaseModelUncertainty() corrects
+	// the computed index, so this only bounds the size of the correction.
+
+	int n = (int) bmUncDist.size();
+	bmUncUniform = false;
+	bmUncInvStep = 0.;
+	if (n < 3)
+		return;
+
+	double step = ((double) bmUncDist[n-1] - (double) bmUncDist[0]) / (n-1);
+	if (step <= 0.)
+		return;
+
+	for (int i = 1; i < n-1; ++i)
+		if (fabs((double) bmUncDist[i] - (double) bmUncDist[0] - i * step) > 0.1 * step)
+			return;
+
+	bmUncUniform = true;
+	bmUncInvStep = 1. / step;
+}
 
-		// calculate weight fraction and evaluate base model error component ...
+double LibCorr3DModel::getBaseModelUncertainty(double dist) const
+{
+	int n = (int) bmUncDist.size();
+	if (dist > bmUncDist[n - 1] || n == 1)
+		return bmUncValu[n - 1];
 
-		double wbm = (dist - (double) bmUncDist[index]) /
-				((double) bmUncDist[index+1] - (double) bmUncDist[index]);
+	// find index such that bmUncDist[index] <= dist < bmUncDist[index+1]
 
-		return (double)(bmUncValu[index+1] - bmUncValu[index]) * wbm +
-				bmUncValu[index];
+	int last = n - 2;
+	int index;
+	if (bmUncUniform)
+	{
+		index = (int) ((dist - bmUncDist[0]) * bmUncInvStep);
+		if (index < 0)
+			index = 0;
+		else if (index > last)
+			index = last;
+
+		// the distances are single precision and only nearly uniform.
+		while (index < last && (double) bmUncDist[index + 1] <= dist)
+			++index;
+		while (index > 0 && (double) bmUncDist[index] > dist)
+			--index;
 	}
+	else
+	{
+		index = (int) (upper_bound(bmUncDist.begin(), bmUncDist.end(), dist)
+				- bmUncDist.begin()) - 1;
+		if (index < 0)
+			index = 0;
+		else if (index > last)
+			index = last;
+	}
+
+	// calculate weight fraction and evaluate base model error component ...
+
+	double wbm = (dist - (double) bmUncDist[index]) /
+			((double) bmUncDist[index+1] - (double) bmUncDist[index]);
+
+	return (double)(bmUncValu[index+1] - bmUncValu[index]) * wbm +
+			bmUncValu[index];
 }
 
 } // end namespace geotess